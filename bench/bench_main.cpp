@@ -0,0 +1,499 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/charset_registry.hpp"
+#include "randkey/encoding.hpp"
+#include "randkey/generator.hpp"
+#include "randkey/key_plan.hpp"
+#include "randkey/options.hpp"
+#include "randkey/output_writer.hpp"
+#include "randkey/random_engine.hpp"
+
+// 统计堆分配次数：替换全局 operator new，计数对 randkey_core 内部的分配同样生效
+namespace
+{
+    std::atomic<std::uint64_t> allocation_count{0};
+}
+
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief 被测计算结果的汇聚点：写入 volatile 防止编译器删除整段计算，main 退出前读取一次
+    volatile std::uint64_t benchmark_sink = 0;
+
+    void do_not_optimize(std::uint64_t value) noexcept
+    {
+        benchmark_sink = value;
+    }
+
+    /// @brief 一项基准的结果：ns_per_op 与 allocations_per_op 按单次操作折算，无吞吐量意义时 bytes_per_second 为 0
+    struct BenchResult
+    {
+        std::string name;
+        std::uint64_t iterations{0};
+        double ns_per_op{0.0};
+        double bytes_per_second{0.0};
+        double allocations_per_op{0.0};
+    };
+
+    struct BenchSettings
+    {
+        std::string filter{};
+        std::chrono::milliseconds min_time{200};
+        bool json{false};
+    };
+
+    /// @brief 执行 iterations 次操作，返回处理的字节数（无意义时返回 0）
+    using BenchBody = std::function<std::uint64_t(std::uint64_t iterations)>;
+
+    /// @brief 临时目录中的输入文件，基准结束后删除
+    class TempFile
+    {
+    public:
+        TempFile(const std::string &name, const std::string &content)
+            : path_(std::filesystem::temp_directory_path() / name)
+        {
+            std::ofstream out(path_, std::ios::binary);
+            out.write(content.data(), static_cast<std::streamsize>(content.size()));
+        }
+
+        ~TempFile()
+        {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+
+        TempFile(const TempFile &) = delete;
+        TempFile &operator=(const TempFile &) = delete;
+
+        const std::filesystem::path &path() const noexcept
+        {
+            return path_;
+        }
+
+        std::string string() const
+        {
+            return path_.string();
+        }
+
+    private:
+        std::filesystem::path path_;
+    };
+
+    /// @brief 丢弃全部写入的流缓冲，用于只测生成与编码、不测 I/O 的场景
+    class NullSink : public std::streambuf
+    {
+    protected:
+        std::streamsize xsputn(const char *, std::streamsize size) override
+        {
+            return size;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            return traits_type::not_eof(ch);
+        }
+    };
+
+    class BenchRunner
+    {
+    public:
+        explicit BenchRunner(BenchSettings settings) : settings_(std::move(settings)) {}
+
+        /// @brief 倍增迭代次数直到单轮耗时达到 min_time，以最后一轮计算结果
+        void run(const std::string &name, const BenchBody &body)
+        {
+            if (!settings_.filter.empty() && name.find(settings_.filter) == std::string::npos)
+            {
+                return;
+            }
+
+            std::uint64_t iterations = 1;
+            for (;;)
+            {
+                const std::uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+                const auto start = Clock::now();
+                const std::uint64_t bytes = body(iterations);
+                const auto elapsed = Clock::now() - start;
+                const std::uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+
+                const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+                if (elapsed >= settings_.min_time || iterations >= (1ULL << 40U))
+                {
+                    BenchResult result;
+                    result.name = name;
+                    result.iterations = iterations;
+                    result.ns_per_op = ns / static_cast<double>(iterations);
+                    result.bytes_per_second = ns > 0.0 ? static_cast<double>(bytes) * 1e9 / ns : 0.0;
+                    result.allocations_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+                    report(result);
+                    return;
+                }
+
+                // 按本轮耗时估算达到 min_time 所需的次数，至少翻倍、至多放大 100 倍
+                const double target = static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(settings_.min_time).count());
+                const double scale = ns > 0.0 ? std::clamp(target * 1.2 / ns, 2.0, 100.0) : 100.0;
+                iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale);
+            }
+        }
+
+        const std::vector<BenchResult> &results() const noexcept
+        {
+            return results_;
+        }
+
+    private:
+        void report(const BenchResult &result)
+        {
+            results_.push_back(result);
+            if (settings_.json)
+            {
+                return;
+            }
+            std::cout << std::left << std::setw(32) << result.name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(14) << result.ns_per_op << " ns/op"
+                      << std::setw(12) << std::setprecision(1) << result.bytes_per_second / (1024.0 * 1024.0) << " MiB/s"
+                      << std::setw(10) << std::setprecision(3) << result.allocations_per_op << " allocs/op\n";
+        }
+
+        BenchSettings settings_;
+        std::vector<BenchResult> results_;
+    };
+
+    std::string json_escape(std::string_view text)
+    {
+        std::string out;
+        for (char ch : text)
+        {
+            if (ch == '"' || ch == '\\')
+            {
+                out.push_back('\\');
+            }
+            out.push_back(ch);
+        }
+        return out;
+    }
+
+    void write_json(std::ostream &out, const std::vector<BenchResult> &results)
+    {
+        out << "{\n  \"version\": \"" << RANDKEY_VERSION << "\",\n  \"results\": [";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult &result = results[i];
+            out << (i == 0 ? "\n" : ",\n") << std::setprecision(6) << std::defaultfloat
+                << "    {\"name\": \"" << json_escape(result.name) << "\", \"iterations\": " << result.iterations
+                << ", \"ns_per_op\": " << result.ns_per_op << ", \"bytes_per_second\": " << result.bytes_per_second
+                << ", \"allocations_per_op\": " << result.allocations_per_op << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    randkey::ParsedArguments parse_cli(std::vector<const char *> args)
+    {
+        args.insert(args.begin(), "randkey");
+        return randkey::ArgumentParser().parse(static_cast<int>(args.size()), args.data());
+    }
+
+    /// @brief 流式生成 iterations 个密钥并丢弃输出，返回输出字节数（每个操作为一个密钥）
+    BenchBody generate_keys(randkey::GenerationOptions options)
+    {
+        return [options = std::move(options)](std::uint64_t iterations) mutable {
+            options.count = static_cast<std::size_t>(iterations);
+            NullSink sink;
+            std::ostream stream(&sink);
+            randkey::OutputWriter writer(stream);
+            randkey::RandomKeyGenerator().generate(options, writer);
+            return writer.bytes_written();
+        };
+    }
+
+    void bench_random(BenchRunner &runner)
+    {
+        runner.run("random/fill_4k", [](std::uint64_t iterations) {
+            std::vector<std::byte> buffer(4096);
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                randkey::SecureRandom::fill(buffer);
+            }
+            return iterations * buffer.size();
+        });
+
+        runner.run("random/uniform", [](std::uint64_t iterations) {
+            std::uint64_t sink = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                sink += randkey::SecureRandom::uniform(62);
+            }
+            do_not_optimize(sink);
+            return std::uint64_t{0};
+        });
+
+        runner.run("random/stream_fill_32", [](std::uint64_t iterations) {
+            randkey::SecureRandomStream random;
+            std::array<std::byte, 32> buffer{};
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                random.fill(buffer);
+            }
+            return iterations * buffer.size();
+        });
+
+        runner.run("random/stream_uniform", [](std::uint64_t iterations) {
+            randkey::SecureRandomStream random;
+            std::uint64_t sink = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                sink += random.uniform(62);
+            }
+            do_not_optimize(sink);
+            return std::uint64_t{0};
+        });
+    }
+
+    void bench_generate(BenchRunner &runner)
+    {
+        // 各模式的单密钥生成（generate_single 等为私有实现，经流式生成入口测量，批次开销已按密钥数摊薄）
+        runner.run("generate/charset_default_12", generate_keys(parse_cli({}).options));
+        runner.run("generate/charset_all_32", generate_keys(parse_cli({"--all", "--length", "32"}).options));
+
+        // 字符集大小为 2 的幂时走整比特直取路径，不经过拒绝采样
+        runner.run("generate/preset_hex_32", generate_keys(parse_cli({"--hex", "--length", "32"}).options));
+        runner.run("generate/preset_base32_32", generate_keys(parse_cli({"--base32", "--length", "32"}).options));
+        runner.run("generate/preset_base64_32", generate_keys(parse_cli({"--base64", "--length", "32"}).options));
+        runner.run("generate/tokens_unicode_16",
+                   generate_keys(parse_cli({"--append", "αβγδεζηθικλμνξοπρστυφχψω", "--length", "16"}).options));
+        runner.run("generate/require_24",
+                   generate_keys(parse_cli({"--lower", "--upper", "--digits", "--special", "--length", "24",
+                                            "--require", "lower,upper,digit,special"})
+                                     .options));
+
+        std::string weighted;
+        for (int i = 0; i < 1000; ++i)
+        {
+            weighted += "tok" + std::to_string(i) + '\t' + std::to_string(1 + i % 17) + '\n';
+        }
+        const TempFile weighted_file("randkey_bench_weighted.txt", weighted);
+        const std::string weighted_path = weighted_file.string();
+        runner.run("generate/weighted_8",
+                   generate_keys(parse_cli({"--append-file-weighted", weighted_path.c_str(), "--length", "8"}).options));
+
+        runner.run("generate/pattern", generate_keys(parse_cli({"--pattern", "AAAA-9999-XXXX-hhhh"}).options));
+
+        std::string words;
+        for (int i = 0; i < 7776; ++i)
+        {
+            words += "word" + std::to_string(i) + '\n';
+        }
+        const TempFile wordlist("randkey_bench_words.txt", words);
+        const std::string wordlist_path = wordlist.string();
+        runner.run("generate/passphrase_6",
+                   generate_keys(parse_cli({"--passphrase", wordlist_path.c_str(), "--words", "6"}).options));
+
+        runner.run("generate/raw_32_binary",
+                   generate_keys(parse_cli({"--raw-bytes", "32", "--raw-encoding", "binary"}).options));
+        runner.run("generate/raw_32_hex",
+                   generate_keys(parse_cli({"--raw-bytes", "32", "--raw-encoding", "hex"}).options));
+        runner.run("generate/uuid4", generate_keys(parse_cli({"--id", "uuid4"}).options));
+        runner.run("generate/uuid7", generate_keys(parse_cli({"--id", "uuid7"}).options));
+        runner.run("generate/ulid", generate_keys(parse_cli({"--id", "ulid"}).options));
+
+        const randkey::KeyPlan plan = randkey::KeyPlan::compile(parse_cli({"--all", "--length", "32"}).options);
+        runner.run("plan/generate_into_32", [&plan](std::uint64_t iterations) {
+            randkey::KeyEngine engine;
+            std::vector<char> buffer(plan.max_key_bytes());
+            std::uint64_t bytes = 0;
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                bytes += plan.generate_into(engine, buffer.data(), buffer.size());
+            }
+            return bytes;
+        });
+    }
+
+    void bench_encoding(BenchRunner &runner)
+    {
+        // 4 KiB 左右的混合文本：ASCII、拉丁扩展、CJK 与表情符号
+        std::string utf8;
+        while (utf8.size() < 4096)
+        {
+            utf8 += "randkey-Ünïcödé-密钥生成器-🔑";
+        }
+        const std::u32string utf32 = randkey::utf8_to_utf32(utf8);
+        std::string ascii(4096, 'k');
+        const std::u32string ascii32 = randkey::utf8_to_utf32(ascii);
+
+        runner.run("encoding/utf8_to_utf32_4k", [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                const std::u32string decoded = randkey::utf8_to_utf32(utf8);
+                do_not_optimize(decoded.size());
+            }
+            return iterations * utf8.size();
+        });
+
+        runner.run("encoding/utf32_to_locale_4k", [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                const std::string encoded = randkey::utf32_to_locale(utf32);
+                do_not_optimize(encoded.size());
+            }
+            return iterations * utf8.size();
+        });
+
+        runner.run("encoding/utf32_to_locale_ascii_4k", [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                const std::string encoded = randkey::utf32_to_locale(ascii32);
+                do_not_optimize(encoded.size());
+            }
+            return iterations * ascii.size();
+        });
+    }
+
+    void bench_charset(BenchRunner &runner)
+    {
+        // 约 1 MiB 的字符集文件：按字符读取时大量重复字符，按行读取时为 65536 个 token
+        std::string characters;
+        std::string tokens;
+        for (std::size_t i = 0; characters.size() < (1U << 20U); ++i)
+        {
+            characters += randkey::utf32_to_utf8(std::u32string(1, static_cast<char32_t>(0x4E00 + i % 4096)));
+        }
+        for (int i = 0; i < 65536; ++i)
+        {
+            tokens += "token-" + std::to_string(i) + '\n';
+        }
+        const TempFile character_file("randkey_bench_chars.txt", characters);
+        const TempFile token_file("randkey_bench_tokens.txt", tokens);
+
+        runner.run("charset/add_from_file_1m", [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                randkey::CharsetRegistry registry;
+                registry.add_from_file(character_file.path());
+            }
+            return iterations * characters.size();
+        });
+
+        runner.run("charset/add_from_file_tokens_64k", [&](std::uint64_t iterations) {
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                randkey::CharsetRegistry registry;
+                registry.add_from_file(token_file.path(), true);
+            }
+            return iterations * tokens.size();
+        });
+    }
+
+    void bench_cli(BenchRunner &runner)
+    {
+        // 端到端：启动构建出的 randkey 可执行文件写到空设备，包含进程启动、语言目录与 locale 初始化（每个操作为一个密钥）
+#if defined(_WIN32)
+        const char *null_device = "NUL";
+#else
+        const char *null_device = "/dev/null";
+#endif
+        const std::string executable = RANDKEY_CLI_PATH;
+        runner.run("cli/all_32_to_devnull", [&](std::uint64_t iterations) {
+            const std::string command = "\"" + executable + "\" --all --length 32 --count " + std::to_string(iterations) +
+                                        " > " + null_device;
+            if (std::system(command.c_str()) != 0)
+            {
+                throw std::runtime_error("failed to run " + executable);
+            }
+            return iterations * 33U;
+        });
+    }
+
+    void print_usage()
+    {
+        std::cout << "randkey_bench [--filter <substring>] [--min-time <ms>] [--json]\n";
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    BenchSettings settings;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg(argv[i]);
+        if (arg == "--json")
+        {
+            settings.json = true;
+        }
+        else if (arg == "--filter" && i + 1 < argc)
+        {
+            settings.filter = argv[++i];
+        }
+        else if (arg == "--min-time" && i + 1 < argc)
+        {
+            settings.min_time = std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            print_usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    BenchRunner runner(settings);
+    try
+    {
+        bench_random(runner);
+        bench_generate(runner);
+        bench_encoding(runner);
+        bench_charset(runner);
+        bench_cli(runner);
+    }
+    catch (const std::exception &ex)
+    {
+        std::cerr << "randkey_bench: " << ex.what() << "\n";
+        return 1;
+    }
+
+    if (settings.json)
+    {
+        write_json(std::cout, runner.results());
+    }
+    // 读取一次汇聚点，被测计算的结果因此始终被使用
+    static_cast<void>(benchmark_sink);
+    return 0;
+}
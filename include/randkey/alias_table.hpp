@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace randkey
+{
+    /// @brief Vose 别名表：按权重进行 O(1) 抽样
+    /// @details 每次抽样消耗一个 64 位随机字：低 32 位经拒绝采样得到列号，
+    ///          高 32 位与该列的阈值比较一次决定取本列或别名
+    class AliasTable
+    {
+    public:
+        AliasTable() = default;
+
+        /// @brief 由权重构建别名表（权重须为有限正数，数量不超过 2^32）
+        /// @throws std::invalid_argument 当权重为空或非法
+        explicit AliasTable(std::span<const double> weights);
+
+        std::size_t size() const noexcept;
+
+        /// @brief 若 word 的列号部分落在拒绝区间返回 false，需换一个随机字重试
+        bool try_sample(std::uint64_t word, std::size_t &out) const noexcept;
+
+        template <typename WordSource>
+        std::size_t sample(WordSource &&source) const
+        {
+            std::size_t result = 0;
+            while (!try_sample(source(), result))
+            {
+            }
+            return result;
+        }
+
+    private:
+        std::vector<std::uint64_t> thresholds_;
+        std::vector<std::uint32_t> aliases_;
+        std::uint64_t column_limit_{0};
+    };
+}
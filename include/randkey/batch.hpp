@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/options.hpp"
+
+namespace randkey
+{
+    /// @brief 作业文件中的一行，已解析为与命令行相同的参数
+    struct BatchJob
+    {
+        std::size_t line{0};
+        ParsedArguments arguments{};
+    };
+
+    /// @brief 单个作业的失败：行号 + 错误键（与命令行相同的 "error_xxx[:detail]" 格式）
+    struct BatchFailure
+    {
+        std::size_t line{0};
+        std::string error;
+    };
+
+    struct BatchReport
+    {
+        std::size_t jobs{0};
+        std::uint64_t keys{0};
+
+        /// @brief 去重后实际物化的字符集表数量
+        std::size_t charset_tables{0};
+        std::vector<BatchFailure> failures;
+    };
+
+    /// @brief 解析一行作业：JSON 对象 {"args": [...] | "...", "output": "..."}
+    /// @details args 为字符串数组（或以空白分隔的字符串），写法与命令行参数相同；
+    ///          output 等价于在 args 末尾追加 --output
+    /// @throws std::runtime_error 当 JSON 或参数非法
+    ParsedArguments parse_batch_job(std::string_view line);
+
+    /// @brief 预先解析全部作业；空行与 # 注释行被忽略，解析失败的作业记入 failures
+    std::vector<BatchJob> load_batch_jobs(const std::filesystem::path &path, std::vector<BatchFailure> &failures);
+
+    /// @brief 在工作窃取线程池上执行全部作业，每个作业写入各自的输出文件
+    /// @details 相同字符集的作业共享同一张物化表；可拆分的大作业按下标区间切块，
+    ///          空闲线程窃取后续区间，各块按序提交到文件，输出与单独运行该作业一致
+    /// @param threads 0 表示使用硬件并发数
+    BatchReport run_batch(std::vector<BatchJob> jobs, std::size_t threads);
+
+    struct BatchArguments
+    {
+        std::filesystem::path jobs{};
+        std::size_t threads{0};
+
+        /// @brief 设置时把全部工作线程的区间导出为 Chrome trace-event JSON
+        std::optional<std::filesystem::path> trace{};
+    };
+
+    /// @brief 解析 `randkey batch` 之后的参数：<jobs.jsonl> [--threads n] [--trace file]
+    BatchArguments parse_batch_arguments(const std::vector<std::string> &args);
+}
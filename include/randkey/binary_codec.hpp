@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 原始字节密钥的输出编码
+    enum class BinaryEncoding
+    {
+        Binary,
+        Hex,
+        Base32,
+        Base64,
+        Base64Url,
+    };
+
+    /// @brief 解析编码名称（binary/hex/base32/base64/base64url）
+    /// @throws std::runtime_error 当名称未知
+    BinaryEncoding parse_binary_encoding(std::u32string_view name);
+
+    /// @brief 计算编码后的字节数（Base32/Base64 含填充，Base64Url 不含填充）
+    std::size_t encoded_size(std::size_t input_size, BinaryEncoding encoding) noexcept;
+
+    /// @brief 将字节按 RFC 4648 编码后追加到 out
+    void append_encoded(std::string &out, std::span<const std::byte> data, BinaryEncoding encoding);
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
-#include <unordered_set>
 #include <vector>
 
 namespace randkey
@@ -15,6 +19,177 @@ namespace randkey
         Uppercase,
         Digits,
         Special,
+        Hex,
+        Base32,
+        Base64,
+        Base64Url,
+    };
+
+    /// @brief 单码点集合的位图：ASCII 内联、BMP 按需分配的定长位图，其余平面用有序数组；集合运算均为逐字操作
+    class CharsetBitmap
+    {
+    public:
+        constexpr CharsetBitmap() = default;
+
+        constexpr explicit CharsetBitmap(std::u32string_view chars)
+        {
+            for (char32_t ch : chars)
+            {
+                set(ch);
+            }
+        }
+
+        constexpr void set(char32_t ch)
+        {
+            if (ch < 0x80)
+            {
+                ascii_[ch / 64] |= bit(ch);
+            }
+            else if (ch < 0x10000)
+            {
+                if (bmp_.empty())
+                {
+                    bmp_.assign(BMP_WORDS, 0);
+                }
+                bmp_[ch / 64] |= bit(ch);
+            }
+            else
+            {
+                const auto it = std::lower_bound(astral_.begin(), astral_.end(), ch);
+                if (it == astral_.end() || *it != ch)
+                {
+                    astral_.insert(it, ch);
+                }
+            }
+        }
+
+        constexpr bool test(char32_t ch) const noexcept
+        {
+            if (ch < 0x80)
+            {
+                return (ascii_[ch / 64] & bit(ch)) != 0;
+            }
+            if (ch < 0x10000)
+            {
+                return !bmp_.empty() && (bmp_[ch / 64] & bit(ch)) != 0;
+            }
+            return std::binary_search(astral_.begin(), astral_.end(), ch);
+        }
+
+        constexpr std::size_t count() const noexcept
+        {
+            std::size_t total = astral_.size();
+            for (std::uint64_t word : ascii_)
+            {
+                total += static_cast<std::size_t>(std::popcount(word));
+            }
+            for (std::uint64_t word : bmp_)
+            {
+                total += static_cast<std::size_t>(std::popcount(word));
+            }
+            return total;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return count() == 0;
+        }
+
+        constexpr CharsetBitmap &operator|=(const CharsetBitmap &other)
+        {
+            ascii_[0] |= other.ascii_[0];
+            ascii_[1] |= other.ascii_[1];
+            if (!other.bmp_.empty())
+            {
+                if (bmp_.empty())
+                {
+                    bmp_ = other.bmp_;
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < BMP_WORDS; ++i)
+                    {
+                        bmp_[i] |= other.bmp_[i];
+                    }
+                }
+            }
+            for (char32_t ch : other.astral_)
+            {
+                set(ch);
+            }
+            return *this;
+        }
+
+        constexpr CharsetBitmap &operator&=(const CharsetBitmap &other)
+        {
+            ascii_[0] &= other.ascii_[0];
+            ascii_[1] &= other.ascii_[1];
+            if (other.bmp_.empty())
+            {
+                bmp_.clear();
+            }
+            else
+            {
+                for (std::size_t i = 0; i < bmp_.size(); ++i)
+                {
+                    bmp_[i] &= other.bmp_[i];
+                }
+            }
+            std::erase_if(astral_, [&](char32_t ch) { return !other.test(ch); });
+            return *this;
+        }
+
+        /// @brief 集合差：移除 other 中的全部码点
+        constexpr CharsetBitmap &operator-=(const CharsetBitmap &other)
+        {
+            ascii_[0] &= ~other.ascii_[0];
+            ascii_[1] &= ~other.ascii_[1];
+            if (!other.bmp_.empty())
+            {
+                for (std::size_t i = 0; i < bmp_.size(); ++i)
+                {
+                    bmp_[i] &= ~other.bmp_[i];
+                }
+            }
+            std::erase_if(astral_, [&](char32_t ch) { return other.test(ch); });
+            return *this;
+        }
+
+        friend constexpr CharsetBitmap operator|(CharsetBitmap left, const CharsetBitmap &right)
+        {
+            return left |= right;
+        }
+
+        friend constexpr CharsetBitmap operator&(CharsetBitmap left, const CharsetBitmap &right)
+        {
+            return left &= right;
+        }
+
+        friend constexpr CharsetBitmap operator-(CharsetBitmap left, const CharsetBitmap &right)
+        {
+            return left -= right;
+        }
+
+    private:
+        static constexpr std::size_t BMP_WORDS = 0x10000 / 64;
+
+        static constexpr std::uint64_t bit(char32_t ch) noexcept
+        {
+            return std::uint64_t{1} << (ch % 64);
+        }
+
+        std::array<std::uint64_t, 2> ascii_{};
+        // 下标与码点对齐（前两个字恒为 0，ASCII 由 ascii_ 负责）
+        std::vector<std::uint64_t> bmp_{};
+        std::vector<char32_t> astral_{};
+    };
+
+    /// @brief 物化后的只读字符集表（已补默认字符集），可在多个生成任务间共享
+    struct CompiledCharset
+    {
+        std::vector<std::u32string> tokens;
+        std::vector<double> weights;
+        bool weighted{false};
     };
 
     class CharsetRegistry
@@ -22,21 +197,80 @@ namespace randkey
     public:
         CharsetRegistry();
 
+        /// @brief 内置字符集包含的全部字符
+        static std::u32string_view builtin_characters(BuiltinCharset kind) noexcept;
+
+        /// @brief 内置字符集的编译期位图
+        static const CharsetBitmap &builtin_bitmap(BuiltinCharset kind) noexcept;
+
         void include(BuiltinCharset kind);
         void include_all_builtins();
         void add_characters(std::u32string_view chars);
         void add_token(std::u32string token);
         void add_from_file(const std::filesystem::path &path, bool treat_line_as_token = false);
 
+        /// @brief 添加带权重的 token，重复添加时权重累加
+        /// @throws std::runtime_error 当权重不是有限正数
+        void add_weighted_token(std::u32string token, double weight);
+
+        /// @brief 从 "token<TAB>weight" 格式的文件加载加权 token（缺省权重为 1）
+        void add_weighted_file(const std::filesystem::path &path);
+
+        /// @brief 从最终字符集中剔除这些单码点（与添加顺序无关，多码点 token 不受影响）
+        void exclude_characters(std::u32string_view chars);
+
+        bool has_exclusions() const noexcept;
+
+        /// @brief 当前单码点成员（已剔除排除项，不含默认字符集），无需物化
+        CharsetBitmap characters() const;
+
+        bool contains(char32_t ch) const noexcept;
+
+        /// @brief 是否添加过显式权重
+        bool weighted() const noexcept;
+
         /// @brief 如果当前集合为空则填充默认字符集（小写+数字）
         void ensure_default();
 
         std::vector<std::u32string> materialize() const;
 
+        /// @brief 与 materialize() 顺序一致的权重（未加权 token 为 1）
+        std::vector<double> materialize_weights() const;
+
+        /// @brief 补默认字符集后一次性物化 token 与权重
+        std::shared_ptr<const CompiledCharset> compile() const;
+
     private:
-        void append_unique_token(std::u32string token);
+        enum class EntryKind
+        {
+            Builtin,
+            Characters,
+            Token,
+        };
+
+        /// @brief 添加记录：物化时按添加顺序回放，保证 token 顺序（进而确定性种子的输出）不变
+        struct Entry
+        {
+            EntryKind kind;
+            BuiltinCharset builtin;
+            std::size_t index;
+        };
+
+        struct TokenEntry
+        {
+            std::u32string token;
+            double weight;
+            bool accumulate;
+        };
+
+        void append_token(std::u32string token, double weight, bool accumulate);
+        CompiledCharset replay() const;
 
-        std::vector<std::u32string> tokens_;
-        std::unordered_set<std::u32string> seen_;
+        std::vector<Entry> order_;
+        std::vector<std::u32string> runs_;
+        std::vector<TokenEntry> tokens_;
+        CharsetBitmap characters_;
+        CharsetBitmap excluded_;
+        bool weighted_{false};
     };
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 输出数据的增量摘要（按 8 字节字处理的 64 位非密码学哈希），与分块方式无关
+    class RunningDigest
+    {
+    public:
+        void update(std::string_view data) noexcept;
+
+        /// @brief 当前摘要（含尚未凑满一个字的尾部字节），不改变内部状态
+        std::uint64_t value() const noexcept;
+
+        std::uint64_t bytes() const noexcept;
+
+    private:
+        std::uint64_t state_{0x9E3779B97F4A7C15ULL};
+        std::uint64_t pending_{0};
+        unsigned pending_bytes_{0};
+        std::uint64_t total_{0};
+    };
+
+    /// @brief 长批次的断点记录：下一个待生成的全局下标、已写出的字节数与其摘要
+    struct Checkpoint
+    {
+        std::uint64_t next_index{0};
+        std::uint64_t bytes{0};
+        std::uint64_t digest{0};
+
+        /// @brief 生成参数指纹（不含 --resume/--force），续写时必须一致
+        std::uint64_t config{0};
+
+        /// @brief 确定性模式的种子；安全模式不记录，续写时重新取熵
+        std::optional<std::uint64_t> deterministic_seed{};
+
+        /// @brief 输出文件对应的断点文件路径（<output>.ckpt）
+        static std::filesystem::path path_for(const std::filesystem::path &output);
+
+        /// @brief 断点保存时使用的临时文件路径（<checkpoint>.tmp），保存中途退出时可能残留
+        static std::filesystem::path temp_path_for(const std::filesystem::path &path);
+
+        /// @brief 先写临时文件并落盘再改名，保证断点文件始终完整
+        /// @note 调用方须先把断点覆盖的输出内容落盘，否则掉电后断点可能声称尚未落盘的字节
+        /// @throws std::runtime_error 当写入或落盘失败
+        void save(const std::filesystem::path &path) const;
+
+        /// @throws std::runtime_error 当文件缺失或格式错误
+        static Checkpoint load(const std::filesystem::path &path);
+    };
+
+    /// @brief 校验输出文件前 checkpoint.bytes 字节的摘要并截断其后内容
+    /// @param digest 输出：覆盖保留部分的摘要状态，供续写时继续累计
+    /// @throws std::runtime_error 当文件过短或摘要不符
+    void truncate_to_checkpoint(const std::filesystem::path &output, const Checkpoint &checkpoint, RunningDigest &digest);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/charset_registry.hpp"
+
+namespace randkey
+{
+    /// @brief 解析逗号分隔的字符类别列表（lower,upper,digit,special）
+    /// @throws std::runtime_error 当类别未知
+    std::vector<BuiltinCharset> parse_required_classes(std::u32string_view list);
+
+    /// @brief “每类至少一个”约束下的精确均匀采样器
+    /// @details 预先计算 f(r, M)：长度为 r 且覆盖缺失类别集合 M 的序列数，
+    ///          逐位置按 f 的精确比例选择类别（大整数计数），无整键拒绝重试；
+    ///          全部类别覆盖后剩余位置退化为普通均匀抽取。计数表内存随长度平方增长，
+    ///          长度超过 1024 时改为整键均匀抽取并拒绝缺类者（同样精确均匀），
+    ///          此时要求按并集上界估计的缺类概率不超过 1/2
+    class ConstrainedSampler
+    {
+    public:
+        /// @brief 64 位均匀随机字来源
+        using WordSource = std::function<std::uint64_t()>;
+
+        /// @throws std::runtime_error 当某个类别在字符集中没有字符、长度不足，
+        ///         或长度超过 1024 且某个类别占比过小（error_require_too_long）
+        ConstrainedSampler(const std::vector<std::u32string> &tokens,
+                           const std::vector<BuiltinCharset> &required,
+                           std::size_t length);
+        ~ConstrainedSampler();
+
+        ConstrainedSampler(ConstrainedSampler &&) noexcept;
+        ConstrainedSampler &operator=(ConstrainedSampler &&) noexcept;
+
+        /// @brief 采样一个满足约束的密钥，将 token 下标写入 out（长度为 length）
+        void sample(const WordSource &source, std::vector<std::size_t> &out) const;
+
+    private:
+        struct Tables;
+
+        std::size_t length_;
+        std::size_t token_count_;
+        std::vector<std::vector<std::size_t>> class_tokens_;
+        std::vector<std::vector<std::size_t>> other_tokens_;
+        std::vector<std::size_t> token_class_;
+        std::unique_ptr<Tables> tables_;
+    };
+}
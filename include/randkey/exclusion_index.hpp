@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "randkey/platform/mapped_file.hpp"
+
+namespace randkey
+{
+    /// @brief 已签发密钥的排除索引：分块 Bloom 过滤器 + 有序指纹数组
+    /// @details 指纹取 KeyFingerprint::primary（短 ASCII 密钥为无损编码）。过滤器约 12 位/键常驻内存，
+    ///          一次查询只访问一个 64 字节块；命中后才在内存映射的有序数组上二分查找。
+    ///          索引持久化为 <keys>.rkx（本机字节序），源文件大小或修改时间变化时自动重建
+    class ExclusionIndex
+    {
+    public:
+        ExclusionIndex() = default;
+
+        /// @brief 加载 keys 对应的持久化索引；缺失或过期时由 keys（每行一个密钥）重建并尝试写回
+        /// @throws std::runtime_error 当 keys 无法读取
+        static ExclusionIndex open(const std::filesystem::path &keys);
+
+        /// @brief 由内存中的密钥（本地编码字节）构建，不落盘
+        static ExclusionIndex from_keys(const std::vector<std::string> &keys);
+
+        /// @brief keys 对应的索引文件路径
+        static std::filesystem::path index_path(const std::filesystem::path &keys);
+
+        bool contains(std::u32string_view key) const;
+        bool contains(std::string_view key) const noexcept;
+
+        std::size_t size() const noexcept;
+
+        /// @brief 索引是否直接映射自持久化文件
+        bool mapped() const noexcept;
+
+    private:
+        bool contains_fingerprint(std::uint64_t fingerprint) const noexcept;
+        void adopt(std::vector<std::uint64_t> fingerprints);
+
+        std::optional<platform::MappedFile> mapped_;
+        std::vector<std::uint64_t> storage_;
+        std::span<const std::uint64_t> filter_;
+        std::span<const std::uint64_t> sorted_;
+    };
+}
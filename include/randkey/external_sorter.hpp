@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace randkey
+{
+    /// @brief 内存受限的外部排序器：按字节序升序输出并去除重复
+    /// @details 块内先按 8 字节前缀做 LSD 基数排序，前缀相同者再整键比较；块满后写出有序段，
+    ///          结束时对所有段做 k 路归并。全部数据装得下一个块时不落盘
+    /// @note 溢出段以明文保存密钥：位于 temp_directory 下的私有目录（0700）内、权限 0600，
+    ///       删除前以零覆盖；进程被强行终止时目录与段文件会残留
+    class ExternalSorter
+    {
+    public:
+        /// @param memory_limit 排序阶段的内存预算（字节），下限为 MIN_MEMORY_LIMIT
+        /// @param temp_directory 溢出段所在私有目录的父目录，首次溢出时才创建
+        explicit ExternalSorter(std::size_t memory_limit,
+                                std::filesystem::path temp_directory = std::filesystem::temp_directory_path());
+        ~ExternalSorter();
+
+        ExternalSorter(const ExternalSorter &) = delete;
+        ExternalSorter &operator=(const ExternalSorter &) = delete;
+
+        static constexpr std::size_t MIN_MEMORY_LIMIT = 1U << 20U;
+
+        /// @throws std::runtime_error 当私有目录无法创建（error_temp_dir）或溢出段无法写入
+        void push(std::string_view key);
+
+        /// @brief 按升序依次输出去重后的密钥；调用后排序器被清空
+        void finish(const std::function<void(std::string_view)> &emit);
+
+        /// @brief 迄今写出的溢出段数量
+        std::size_t spilled_runs() const noexcept;
+
+    private:
+        struct SortEntry
+        {
+            std::uint64_t prefix;
+            std::uint64_t record;
+        };
+
+        std::string_view record(std::uint64_t entry) const noexcept;
+        void sort_chunk(std::vector<SortEntry> &entries) const;
+        void drain_chunk(const std::function<void(std::string_view)> &emit);
+        void spill();
+        std::filesystem::path next_run_path();
+        void merge(const std::vector<std::filesystem::path> &runs,
+                   std::size_t buffer_bytes,
+                   const std::function<void(std::string_view)> &emit) const;
+
+        std::size_t memory_limit_;
+        std::filesystem::path temp_directory_;
+        std::string arena_;
+        std::vector<std::uint64_t> records_;
+        std::vector<std::filesystem::path> runs_;
+        std::filesystem::path run_directory_;
+        std::uint64_t run_serial_{0};
+        std::size_t total_runs_{0};
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 密钥指纹：primary 用于探查，secondary 用于主指纹相同时的二次确认
+    struct KeyFingerprint
+    {
+        std::uint64_t primary{0};
+        std::uint64_t secondary{0};
+
+        /// @brief 不超过 8 个字符的 ASCII 密钥按 7 位无损打包，primary 即为精确编码
+        static KeyFingerprint of(std::u32string_view key) noexcept;
+        static KeyFingerprint of(std::string_view key) noexcept;
+
+        bool exact() const noexcept;
+    };
+
+    /// @brief 固定容量的无锁指纹集合，用于批内去重
+    /// @details 开放寻址表，槽位为两个 64 位原子字。短 ASCII 密钥的 primary 是无损编码，比较即精确；
+    ///          其余密钥在 primary 命中后再比较 secondary，二者均相同才判定为重复，
+    ///          primary 碰撞但 secondary 不同时继续探查。只保存 128 位指纹、不保存密钥本身：
+    ///          两个指纹都碰撞的不同密钥（概率约 2^-128）会被当作重复而重新生成，
+    ///          只多一次抽取，永远不会放过真正的重复
+    class FingerprintSet
+    {
+    public:
+        /// @param expected 预计插入数量，容量按不超过 75% 负载向上取 2 的幂
+        explicit FingerprintSet(std::size_t expected);
+
+        /// @brief 插入指纹；首次出现返回 true，已存在返回 false（线程安全）
+        /// @throws std::runtime_error 当集合已满
+        bool insert(const KeyFingerprint &fingerprint);
+
+        template <typename Key>
+        bool insert(const Key &key)
+        {
+            return insert(KeyFingerprint::of(key));
+        }
+
+        bool contains(const KeyFingerprint &fingerprint) const noexcept;
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+
+    private:
+        std::size_t capacity_;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> primary_;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> secondary_;
+        std::atomic<std::size_t> size_{0};
+    };
+}
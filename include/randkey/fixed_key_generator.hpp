@@ -0,0 +1,172 @@
+#pragma once
+
+#include "randkey/random_engine.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 可作为模板实参的编译期 ASCII 字符集字面量（如 "0123456789abcdef"）
+    template <std::size_t Size>
+    struct FixedCharset
+    {
+        static_assert(Size >= 2, "字符集不能为空");
+
+        char chars[Size]{};
+
+        constexpr FixedCharset(const char (&text)[Size])
+        {
+            for (std::size_t i = 0; i < Size; ++i)
+            {
+                chars[i] = text[i];
+            }
+        }
+
+        static constexpr std::size_t size() noexcept
+        {
+            return Size - 1;
+        }
+
+        constexpr std::string_view view() const noexcept
+        {
+            return std::string_view(chars, Size - 1);
+        }
+
+        /// @brief 字符互不重复且均为可打印 ASCII（与运行时注册表对字面量的去重结果一致）
+        constexpr bool valid() const noexcept
+        {
+            for (std::size_t i = 0; i + 1 < Size; ++i)
+            {
+                const auto ch = static_cast<unsigned char>(chars[i]);
+                if (ch < 0x21 || ch > 0x7e)
+                {
+                    return false;
+                }
+                for (std::size_t j = 0; j < i; ++j)
+                {
+                    if (chars[j] == chars[i])
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    /// @brief 编译期拼接两个字符集，如 fixed_charsets::lowercase + fixed_charsets::digits
+    template <std::size_t A, std::size_t B>
+    constexpr FixedCharset<A + B - 1> operator+(const FixedCharset<A> &left, const FixedCharset<B> &right)
+    {
+        char text[A + B - 1]{};
+        for (std::size_t i = 0; i + 1 < A; ++i)
+        {
+            text[i] = left.chars[i];
+        }
+        for (std::size_t i = 0; i < B; ++i)
+        {
+            text[A - 1 + i] = right.chars[i];
+        }
+        return FixedCharset<A + B - 1>(text);
+    }
+
+    /// @brief 与 CharsetRegistry 内置字符集逐字相同的编译期字面量
+    namespace fixed_charsets
+    {
+        inline constexpr FixedCharset lowercase{"abcdefghijklmnopqrstuvwxyz"};
+        inline constexpr FixedCharset uppercase{"ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
+        inline constexpr FixedCharset digits{"0123456789"};
+        inline constexpr FixedCharset special{"!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"};
+        inline constexpr FixedCharset hex{"0123456789abcdef"};
+        inline constexpr FixedCharset base32{"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567"};
+        inline constexpr FixedCharset base64{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+        inline constexpr FixedCharset base64url{"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"};
+    }
+
+    /// @brief 字符集与长度在编译期固定的密钥生成器：查表与拒绝阈值均为常量，密钥存放在 std::array 中，不经过注册表也不分配堆内存
+    /// @details 每个字符消耗一个随机字节，字节 < THRESHOLD 时经 TABLE 直接映射到字符，否则丢弃重抽，分布严格均匀
+    template <FixedCharset Chars, std::size_t Length>
+    class FixedKeyGenerator
+    {
+        static_assert(Chars.valid(), "字符集须为互不重复的可打印 ASCII 字符");
+        static_assert(Chars.size() <= 256, "单字节抽样最多支持 256 个字符");
+        static_assert(Length > 0, "密钥长度必须大于 0");
+
+        static constexpr std::array<char, 256> make_table() noexcept
+        {
+            std::array<char, 256> table{};
+            for (std::size_t value = 0; value < 256; ++value)
+            {
+                table[value] = Chars.chars[value % Chars.size()];
+            }
+            return table;
+        }
+
+    public:
+        using key_type = std::array<char, Length>;
+
+        static constexpr std::size_t WIDTH = Length;
+        static constexpr std::size_t CHARSET_SIZE = Chars.size();
+
+        /// @brief 接受区间 [0, THRESHOLD) 内的字节；字符数为 2 的幂时为 256，不会拒绝
+        static constexpr unsigned THRESHOLD = 256U - 256U % CHARSET_SIZE;
+
+        /// @brief 随机字节到字符的映射，下标已按字符数取模展开
+        static constexpr std::array<char, 256> TABLE = make_table();
+
+        static constexpr std::string_view charset() noexcept
+        {
+            return Chars.view();
+        }
+
+        /// @brief 从带缓冲的随机流生成一个密钥（每线程持有独立流）
+        static key_type generate(SecureRandomStream &random)
+        {
+            return draw([&](std::span<std::byte> out) { random.fill(out); });
+        }
+
+        /// @brief 直接读取系统随机源生成一个密钥，无需任何运行时状态
+        static key_type generate()
+        {
+            return draw([](std::span<std::byte> out) { SecureRandom::fill(out); });
+        }
+
+        static constexpr std::string_view view(const key_type &key) noexcept
+        {
+            return std::string_view(key.data(), key.size());
+        }
+
+    private:
+        template <typename Fill>
+        static key_type draw(Fill &&fill)
+        {
+            key_type key{};
+            std::array<std::byte, Length> bytes{};
+            std::size_t filled = 0;
+            while (filled < Length)
+            {
+                const std::size_t wanted = Length - filled;
+                fill(std::span<std::byte>(bytes.data(), wanted));
+                for (std::size_t i = 0; i < wanted; ++i)
+                {
+                    const auto value = std::to_integer<unsigned>(bytes[i]);
+                    if (THRESHOLD == 256U || value < THRESHOLD)
+                    {
+                        key[filled++] = TABLE[value];
+                    }
+                }
+            }
+            // 随机字节与密钥同等敏感，返回前清零
+            volatile std::byte *wipe = bytes.data();
+            for (std::size_t i = 0; i < Length; ++i)
+            {
+                wipe[i] = std::byte{0};
+            }
+            return key;
+        }
+    };
+}
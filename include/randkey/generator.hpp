@@ -1,11 +1,20 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "randkey/alias_table.hpp"
+#include "randkey/constraints.hpp"
 #include "randkey/options.hpp"
+#include "randkey/output_writer.hpp"
+#include "randkey/pattern.hpp"
+#include "randkey/random_engine.hpp"
+#include "randkey/wordlist.hpp"
 
 namespace randkey
 {
@@ -14,6 +23,9 @@ namespace randkey
         std::vector<std::u32string> keys;
         std::optional<std::uint64_t> deterministic_seed;
         std::optional<std::uint64_t> mixing_seed;
+
+        /// @brief 口令模式下每条口令的熵（比特）
+        std::optional<double> entropy_bits;
     };
 
     class RandomKeyGenerator
@@ -23,12 +35,85 @@ namespace randkey
                                    std::optional<std::uint64_t> deterministic_seed_only = std::nullopt,
                                    std::optional<std::uint64_t> mixing_seed = std::nullopt) const;
 
+        /// @brief 流式生成：密钥直接写入 writer，返回值中的 keys 为空
+        /// @param on_checkpoint 设置 checkpoint_interval 时，每写完该数量的密钥先刷新 writer，
+        ///        再以下一个待生成的全局下标调用
+        GenerationOutcome generate(const GenerationOptions &options,
+                                   OutputWriter &writer,
+                                   std::optional<std::uint64_t> deterministic_seed_only = std::nullopt,
+                                   std::optional<std::uint64_t> mixing_seed = std::nullopt,
+                                   const std::function<void(std::uint64_t)> &on_checkpoint = {}) const;
+
     private:
+        static GenerationOutcome prepare_outcome(std::optional<std::uint64_t> deterministic_seed_only,
+                                                 std::optional<std::uint64_t> mixing_seed);
+
+        static std::shared_ptr<const CompiledCharset> prepare_charset(const GenerationOptions &options);
+
+        /// @brief 按模式逐个产出密钥：字符集模式调用 on_key，原始字节/标识符模式调用 on_encoded（不含分隔符）
+        /// @details 开启 sorted 时所有密钥先经外部排序，再以本地编码按升序交给 on_encoded
+        static void produce(const GenerationOptions &options,
+                            GenerationOutcome &outcome,
+                            const std::function<void(std::u32string_view)> &on_key,
+                            const std::function<void(std::string_view)> &on_encoded);
+
+        static void produce_direct(const GenerationOptions &options,
+                                   GenerationOutcome &outcome,
+                                   const std::function<void(std::u32string_view)> &on_key,
+                                   const std::function<void(std::string_view)> &on_encoded);
+
+        /// @brief 以整块方式取得下标 [first_index, first_index + count) 的随机块（确定性/混合种子按全局下标派生）
+        static void for_each_random_block(const GenerationOutcome &outcome,
+                                          std::size_t block_bytes,
+                                          std::size_t first_index,
+                                          std::size_t count,
+                                          const std::function<void(std::span<const std::byte>)> &consume);
+
+        /// @brief 原始字节模式：整块读取随机源并编码
+        static void generate_raw(const GenerationOptions &options,
+                                 const GenerationOutcome &outcome,
+                                 const std::function<void(std::string_view)> &emit);
+
+        /// @brief UUID/ULID 模式：每个标识符消耗 16 个随机字节
+        static void generate_ids(const GenerationOptions &options,
+                                 const GenerationOutcome &outcome,
+                                 const std::function<void(std::string_view)> &emit);
+
+        /// @brief 口令模式：从词表均匀抽取单词，以预编码字节拼接分隔符
+        /// @param accept 非空时对每条口令调用，返回 false 则重新抽取（去重/排除）
+        static void generate_passphrases(const GenerationOptions &options,
+                                         const Wordlist &wordlist,
+                                         const GenerationOutcome &outcome,
+                                         const std::function<bool(std::string_view)> &accept,
+                                         const std::function<void(std::string_view)> &emit);
+
         static std::u32string generate_single(const std::vector<std::u32string> &tokens,
                                               std::size_t length,
                                               std::optional<std::uint64_t> deterministic_seed_only,
                                               std::optional<std::uint64_t> mixing_seed,
-                                              std::size_t index);
+                                              std::size_t index,
+                                              SecureRandomStream &random);
+
+        static std::u32string generate_constrained_single(const ConstrainedSampler &sampler,
+                                                          const std::vector<std::u32string> &tokens,
+                                                          std::optional<std::uint64_t> deterministic_seed_only,
+                                                          std::optional<std::uint64_t> mixing_seed,
+                                                          std::size_t index,
+                                                          SecureRandomStream &random);
+
+        static std::u32string generate_weighted_single(const AliasTable &table,
+                                                       const std::vector<std::u32string> &tokens,
+                                                       std::size_t length,
+                                                       std::optional<std::uint64_t> deterministic_seed_only,
+                                                       std::optional<std::uint64_t> mixing_seed,
+                                                       std::size_t index,
+                                                       SecureRandomStream &random);
+
+        static std::u32string generate_pattern_single(const PatternPlan &plan,
+                                                      std::optional<std::uint64_t> deterministic_seed_only,
+                                                      std::optional<std::uint64_t> mixing_seed,
+                                                      std::size_t index,
+                                                      SecureRandomStream &random);
     };
 
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 标识符格式（RFC 9562 UUID 与 ULID）
+    enum class IdFormat
+    {
+        None,
+        UuidV4,
+        UuidV7,
+        Ulid,
+    };
+
+    /// @brief 解析格式名称（uuid4/uuid7/ulid）
+    /// @throws std::runtime_error 当名称未知
+    IdFormat parse_id_format(std::u32string_view name);
+
+    /// @brief 标识符格式化器：写入版本/变体位并保持 v7/ULID 时间戳单调递增
+    /// @note 非线程安全，单调性仅在同一实例内保证
+    class IdFormatter
+    {
+    public:
+        static constexpr std::size_t RANDOM_BYTES = 16;
+
+        explicit IdFormatter(IdFormat format);
+
+        /// @brief 当前 Unix 毫秒时间戳
+        static std::uint64_t now_unix_ms();
+
+        /// @brief 基于 16 个随机字节与给定毫秒时间戳生成下一个标识符并追加到 out
+        void append_next(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out);
+
+        /// @brief 输出文本长度（UUID 36，ULID 26）
+        std::size_t text_size() const noexcept;
+
+    private:
+        void append_uuid(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out);
+        void append_ulid(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out);
+
+        IdFormat format_;
+        std::uint64_t last_ms_{0};
+        std::uint16_t counter_{0};
+        std::uint64_t ulid_high_{0};
+        std::uint64_t ulid_low_{0};
+    };
+}
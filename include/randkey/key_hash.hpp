@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace randkey
+{
+    /// @brief 随密钥输出的摘要算法
+    enum class KeyHashAlgorithm
+    {
+        None,
+        Sha256,
+        Blake3,
+    };
+
+    using KeyDigest = std::array<std::uint8_t, 32>;
+
+    /// @brief 解析算法名称（sha256/blake3）
+    /// @throws std::runtime_error 当名称未知
+    KeyHashAlgorithm parse_key_hash_algorithm(std::u32string_view name);
+
+    KeyDigest sha256(std::string_view data) noexcept;
+
+    KeyDigest blake3(std::string_view data) noexcept;
+
+    /// @brief 批量计算摘要，digests 与 keys 一一对应
+    /// @details SHA-256 将块数相同的消息每 8 个一组，支持时以 AVX2 多缓冲并行压缩；其余逐个计算
+    void hash_keys(KeyHashAlgorithm algorithm, std::span<const std::string_view> keys, std::span<KeyDigest> digests);
+
+    /// @brief 以小写十六进制追加摘要
+    void append_digest_hex(std::string &out, const KeyDigest &digest);
+}
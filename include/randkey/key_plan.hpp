@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/options.hpp"
+#include "randkey/random_engine.hpp"
+
+namespace randkey
+{
+    class KeyPlan;
+    class KeyView;
+
+    /// @brief 单线程随机状态与复用缓冲；首次使用后按计划的最大尺寸保留容量，此后生成不再分配内存
+    /// @note 非线程安全，每个线程应持有独立实例；析构时清零缓冲区
+    class KeyEngine
+    {
+    public:
+        KeyEngine() = default;
+        ~KeyEngine();
+
+        KeyEngine(const KeyEngine &) = delete;
+        KeyEngine &operator=(const KeyEngine &) = delete;
+
+    private:
+        friend class KeyPlan;
+
+        SecureRandomStream random_{};
+        std::string text_{};
+        std::vector<std::byte> bytes_{};
+        std::vector<std::size_t> indices_{};
+    };
+
+    /// @brief 编译后的单密钥生成计划：字符表预先编码为 UTF-8，可被多个线程共享（只读）
+    /// @details 面向进程内调用（C ABI、惰性区间）：每次生成一个密钥直接写入调用方缓冲区。
+    ///          仅使用安全随机源；种子、去重、排除、排序、断点、区间与输出选项属于批次语义，编译时拒绝
+    class KeyPlan
+    {
+    public:
+        /// @throws std::runtime_error 当选项不适用于单密钥生成或字符集/词表无效
+        static KeyPlan compile(const GenerationOptions &options);
+
+        KeyPlan(KeyPlan &&) noexcept;
+        KeyPlan &operator=(KeyPlan &&) noexcept;
+        ~KeyPlan();
+
+        /// @brief 单个密钥的最大字节数（UTF-8，不含终止符）；缓冲区不小于该值时不会截断
+        std::size_t max_key_bytes() const noexcept;
+
+        /// @brief 生成一个密钥写入 buffer，返回密钥字节数
+        /// @details 返回值大于 capacity 时仅写入前 capacity 字节，该密钥应视为作废
+        std::size_t generate_into(KeyEngine &engine, char *buffer, std::size_t capacity) const;
+
+        std::string generate(KeyEngine &engine) const;
+
+        /// @brief 按需拉取密钥的惰性区间，计划须比区间存活更久
+        KeyView keys() const;
+
+    private:
+        struct State;
+
+        explicit KeyPlan(std::unique_ptr<State> state);
+
+        std::unique_ptr<State> state_;
+    };
+
+    /// @brief 无限长的惰性输入区间：解引用时才生成当前密钥，可与 std::views::take 等适配器组合
+    /// @details 自带引擎与复用缓冲，逐个拉取的摊销开销与批量生成相同；
+    ///          解引用得到的引用在下一次递增后失效（内容被下一个密钥覆盖）
+    class KeyView : public std::ranges::view_interface<KeyView>
+    {
+    public:
+        class iterator
+        {
+        public:
+            using value_type = std::string;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::input_iterator_tag;
+
+            iterator() = default;
+
+            const std::string &operator*() const
+            {
+                return view_->current();
+            }
+
+            iterator &operator++()
+            {
+                view_->stale_ = true;
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator &, std::unreachable_sentinel_t) noexcept
+            {
+                return false;
+            }
+
+        private:
+            friend class KeyView;
+
+            explicit iterator(KeyView &view) : view_(&view) {}
+
+            KeyView *view_{nullptr};
+        };
+
+        KeyView() = default;
+        explicit KeyView(const KeyPlan &plan);
+        ~KeyView();
+
+        KeyView(KeyView &&) noexcept = default;
+        KeyView &operator=(KeyView &&) noexcept = default;
+
+        iterator begin()
+        {
+            return iterator(*this);
+        }
+
+        std::unreachable_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        const std::string &current();
+
+        const KeyPlan *plan_{nullptr};
+        std::unique_ptr<KeyEngine> engine_{};
+        std::string current_{};
+        bool stale_{true};
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "randkey/platform/shared_memory.hpp"
+
+namespace randkey
+{
+    /// @brief 单个槽位可容纳的密钥字节上限（槽位连同序号与长度共 256 字节）
+    constexpr std::size_t KEY_RING_SLOT_BYTES = 240;
+
+    /// @brief 由服务名与配置名得到共享内存区域名，如 ("randkey", "pin") -> "/randkey.pin"
+    std::string key_ring_name(std::string_view base, std::string_view profile);
+
+    /// @brief 共享内存密钥环的生产端（单生产者），由 `randkey serve --shm` 持有
+    /// @details 环由 2 的幂个槽位组成，每个槽位带 64 位序号：序号等于票号表示空闲，等于票号+1 表示已就绪。
+    ///          消费方以一次 fetch_add 领取票号，就绪后以 CAS 置最高位锁定槽位，拷出后清零并把序号推进一圈；
+    ///          双方在对方未就绪时通过 futex 休眠，只有存在等待者时才发起唤醒系统调用。
+    ///
+    ///          故障模式：消费方领取票号后、锁定槽位前退出（如在空环上等待时被 Ctrl-C），该票号对应的
+    ///          密钥无人取走。生产端下一圈写到此槽位时最多等待 abandon_timeout，随后收回槽位并清零其中的密钥
+    ///          （被放弃的密钥不会再发给任何人）；若该消费方其实只是被挂起，恢复后发现票号已失效会自动换票重试。
+    ///          消费方在锁定后、释放前的拷贝窗口（不足一微秒）内退出的情形无法与仍在拷贝的消费方区分，
+    ///          不做收回：该槽位会使生产端停滞，需要重启服务
+    class KeyRingProducer
+    {
+    public:
+        /// @param slots 槽位数，向上取 2 的幂
+        /// @param abandon_timeout 已就绪但无人锁定的槽位在被视为放弃前的等待时间
+        /// @throws std::runtime_error 当共享内存创建失败
+        KeyRingProducer(const std::string &name,
+                        std::size_t slots,
+                        std::chrono::milliseconds abandon_timeout = std::chrono::milliseconds(1000));
+
+        /// @brief 关闭环：阻塞中的消费方收到错误而不是无限等待；区域名称随之删除
+        ~KeyRingProducer();
+
+        KeyRingProducer(const KeyRingProducer &) = delete;
+        KeyRingProducer &operator=(const KeyRingProducer &) = delete;
+
+        /// @brief 发布一个密钥，环满时等待消费；stop 置位时放弃并返回 false
+        /// @throws std::runtime_error 当密钥超过 KEY_RING_SLOT_BYTES
+        bool publish(std::string_view key, const std::atomic<bool> &stop);
+
+        void close() noexcept;
+
+        std::size_t slots() const noexcept;
+
+        /// @brief 因消费方退出而收回的槽位数
+        std::uint64_t reclaimed() const noexcept;
+
+    private:
+        platform::SharedMemory region_;
+        std::chrono::milliseconds abandon_timeout_;
+        std::uint64_t next_ticket_{0};
+        std::uint64_t reclaimed_{0};
+    };
+
+    /// @brief 共享内存密钥环的消费端，可在多个线程与进程中同时使用
+    class KeyRingClient
+    {
+    public:
+        /// @throws std::runtime_error 当环不存在或格式不符
+        explicit KeyRingClient(const std::string &name);
+
+        KeyRingClient(const KeyRingClient &) = delete;
+        KeyRingClient &operator=(const KeyRingClient &) = delete;
+
+        /// @brief 领取一个密钥写入 buffer（不含换行），返回字节数；槽位在拷出后立即清零
+        /// @param capacity 不小于 KEY_RING_SLOT_BYTES 时不会截断
+        /// @throws std::runtime_error 当生产端已关闭且无可领取的密钥
+        std::size_t claim(char *buffer, std::size_t capacity);
+
+        std::string claim();
+
+    private:
+        platform::SharedMemory region_;
+    };
+}
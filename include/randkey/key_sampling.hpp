@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "randkey/alias_table.hpp"
+#include "randkey/constraints.hpp"
+#include "randkey/random_engine.hpp"
+
+// 单个密钥的下标抽样：RandomKeyGenerator 与 KeyPlan 共用，二者只在 token 的表示（UTF-32/预编码 UTF-8）上不同
+namespace randkey::sampling
+{
+    /// @brief 位精确快速路径一次处理的字符数（8 的倍数，保证各内核按整组处理）
+    constexpr std::size_t BIT_EXACT_BLOCK = 64;
+
+    /// @brief 位精确快速路径支持的最大字符集（索引最多 16 位）
+    constexpr std::uint64_t BIT_EXACT_MAX_TOKENS = 1ULL << 16U;
+
+    /// @brief 生成 count 个 bits 位索引所需的随机字节数
+    std::size_t random_bytes_for(std::size_t count, unsigned bits);
+
+    /// @brief 从随机字节流中按 bits 位切出索引，无拒绝采样
+    /// @note hex/base32/base64/字节 四种宽度按整组展开（1→2、5→8、3→4、1→1），
+    ///       循环体无数据相关分支，便于编译器向量化；out 需容纳按整组向上取整的数量
+    void extract_indices(const unsigned char *src, unsigned bits, std::size_t count, std::uint32_t *out);
+
+    /// @brief 从安全随机流均匀抽取 count 个 [0, token_count) 下标，依次调用 emit(位置, 下标)
+    /// @details 字符集大小为 2 的幂时每个字符恰好消耗 log2(n) 位随机数，无需逐字符拒绝采样
+    template <typename Emit>
+    void for_each_uniform_index(std::uint64_t token_count, std::size_t count, SecureRandomStream &random, Emit &&emit)
+    {
+        if (std::has_single_bit(token_count) && token_count <= BIT_EXACT_MAX_TOKENS)
+        {
+            const unsigned bits = static_cast<unsigned>(std::countr_zero(token_count));
+            std::array<std::byte, BIT_EXACT_BLOCK * 2 + 2> bytes{};
+            std::array<std::uint32_t, BIT_EXACT_BLOCK> indices{};
+
+            for (std::size_t start = 0; start < count; start += BIT_EXACT_BLOCK)
+            {
+                const std::size_t block = std::min(BIT_EXACT_BLOCK, count - start);
+                random.fill(std::span<std::byte>(bytes.data(), random_bytes_for(block, bits)));
+                extract_indices(reinterpret_cast<const unsigned char *>(bytes.data()), bits, block, indices.data());
+
+                for (std::size_t i = 0; i < block; ++i)
+                {
+                    emit(start + i, static_cast<std::uint64_t>(indices[i]));
+                }
+            }
+
+            bytes.fill(std::byte{0});
+            return;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            emit(i, random.uniform(token_count));
+        }
+    }
+
+    /// @brief 按别名表权重抽取 count 个下标，依次调用 emit(下标)
+    template <typename Source, typename Emit>
+    void for_each_weighted_index(const AliasTable &table, std::size_t count, Source &&source, Emit &&emit)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            emit(table.sample(source));
+        }
+    }
+
+    /// @brief 抽取一个满足“每类至少一个”约束的密钥，依次调用 emit(下标)
+    /// @param scratch 复用的下标缓冲
+    template <typename Source, typename Emit>
+    void for_each_constrained_index(const ConstrainedSampler &sampler,
+                                    std::vector<std::size_t> &scratch,
+                                    Source &&source,
+                                    Emit &&emit)
+    {
+        sampler.sample(source, scratch);
+        for (std::size_t index : scratch)
+        {
+            emit(index);
+        }
+    }
+
+    /// @brief 口令：从 size 个单词中均匀抽取 words 个下标（64 位随机字拒绝采样），依次调用 emit(序号, 下标)
+    template <typename Source, typename Emit>
+    void for_each_word_index(std::uint64_t size, std::size_t words, Source &&source, Emit &&emit)
+    {
+        const std::uint64_t threshold = std::numeric_limits<std::uint64_t>::max() -
+                                        (std::numeric_limits<std::uint64_t>::max() % size);
+        for (std::size_t w = 0; w < words; ++w)
+        {
+            std::uint64_t value = source();
+            while (value >= threshold)
+            {
+                value = source();
+            }
+            emit(w, static_cast<std::size_t>(value % size));
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "randkey/exclusion_index.hpp"
+#include "randkey/key_plan.hpp"
+#include "randkey/key_ring.hpp"
+#include "randkey/options.hpp"
+
+namespace randkey
+{
+    /// @brief 服务模式下的命名配置：名称 + 与命令行相同写法的生成参数
+    struct ServeProfile
+    {
+        std::string name;
+        GenerationOptions options;
+    };
+
+    /// @brief 解析一行配置：`名称 参数...`（参数以空白分隔，不支持引号）
+    /// @throws std::runtime_error 当参数非法或不适用于服务模式（种子、文件输出、二进制原始字节等）
+    ServeProfile parse_serve_profile(std::string_view line);
+
+    /// @brief 读取配置文件，忽略空行与以 # 开头的注释行
+    std::vector<ServeProfile> load_serve_profiles(const std::filesystem::path &path);
+
+    /// @brief 单个配置的预取池：后台线程按批生成密钥，请求方直接取用已就绪的密钥
+    /// @details 构造时一次性编译 KeyPlan 并打开排除索引，之后各批只做抽样；
+    ///          标识符格式化器随计划存续，uuid7/ulid 跨批保持单调
+    /// @note 已取出的密钥在池内存中随即清零
+    class KeyPool
+    {
+    public:
+        /// @param capacity 池中最多保留的就绪密钥数
+        /// @throws std::runtime_error 当字符集、词表或排除文件无效
+        KeyPool(const GenerationOptions &options, std::size_t capacity);
+        ~KeyPool();
+
+        KeyPool(const KeyPool &) = delete;
+        KeyPool &operator=(const KeyPool &) = delete;
+
+        /// @brief 取出 count 个密钥（每个以 '\n' 结尾）追加到 out，池空时等待补充
+        /// @throws std::runtime_error 当后台生成失败
+        void take(std::size_t count, std::string &out);
+
+        std::size_t ready() const;
+
+    private:
+        void fill_loop();
+
+        KeyPlan plan_;
+        std::optional<ExclusionIndex> excluded_;
+        std::size_t capacity_;
+        std::size_t batch_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<std::string> chunks_;
+        std::size_t front_offset_{0};
+        std::size_t ready_{0};
+        bool stopping_{false};
+        std::exception_ptr failure_;
+        std::thread filler_;
+    };
+
+    /// @brief 密钥服务：按配置名分发到各自的预取池
+    /// @details 请求负载：4 字节小端数量 + 配置名（空表示 default）。
+    ///          响应负载：1 字节状态（0 成功，1 失败）+ 成功时为 '\n' 结尾的密钥序列，失败时为错误键
+    class KeyServer
+    {
+    public:
+        static constexpr std::size_t MAX_BATCH = 1U << 20U;
+
+        KeyServer(const std::vector<ServeProfile> &profiles, std::size_t pool_capacity);
+
+        std::string handle(std::string_view request);
+
+        static std::string encode_request(std::string_view profile, std::uint32_t count);
+
+        std::vector<std::string> profile_names() const;
+
+        /// @throws std::out_of_range 当配置不存在
+        KeyPool &pool(const std::string &profile);
+
+    private:
+        std::unordered_map<std::string, std::unique_ptr<KeyPool>> pools_;
+    };
+
+    /// @brief 把一个预取池的密钥持续搬运到共享内存环，供同机进程免系统调用领取
+    class KeyRingFeeder
+    {
+    public:
+        KeyRingFeeder(KeyPool &pool, const std::string &ring_name, std::size_t slots);
+        ~KeyRingFeeder();
+
+        KeyRingFeeder(const KeyRingFeeder &) = delete;
+        KeyRingFeeder &operator=(const KeyRingFeeder &) = delete;
+
+    private:
+        void feed_loop();
+
+        KeyPool &pool_;
+        KeyRingProducer ring_;
+        std::atomic<bool> stop_{false};
+        std::thread worker_;
+    };
+
+    struct ServeArguments
+    {
+        std::filesystem::path socket{};
+        std::optional<std::filesystem::path> profiles{};
+        std::size_t pool{1U << 16U};
+        /// @brief 非空时为每个配置额外创建共享内存环 "/<shm>.<配置名>"
+        std::optional<std::string> shm{};
+    };
+
+    /// @brief 解析 `randkey serve` 之后的参数
+    ServeArguments parse_serve_arguments(const std::vector<std::string> &args);
+}
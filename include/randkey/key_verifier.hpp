@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/charset_registry.hpp"
+#include "randkey/options.hpp"
+
+namespace randkey
+{
+    enum class ViolationKind
+    {
+        Empty,
+        Encoding,
+        Charset,
+        Length,
+        Required,
+    };
+
+    /// @brief 单行违规：行号从 1 起；detail 为字符集违规的字符位置（从 1 起）或长度违规的实际长度
+    struct KeyViolation
+    {
+        std::uint64_t line{0};
+        ViolationKind kind{ViolationKind::Charset};
+        std::uint64_t detail{0};
+    };
+
+    struct VerifyReport
+    {
+        std::uint64_t keys{0};
+        std::uint64_t violations{0};
+    };
+
+    /// @brief 由生成参数推导的校验策略：字符集成员位图、可选的精确长度与必选类别
+    class KeyPolicy
+    {
+    public:
+        /// @param check_length 为 false 时不校验长度（命令行未显式给出 --length）
+        /// @throws std::runtime_error error_verify_mode（非字符集模式）或 error_verify_tokens（含多字符 token）
+        static KeyPolicy from_options(const GenerationOptions &options, bool check_length);
+
+        /// @brief 逐码点完整校验一行（不含换行符），返回的违规行号为 0
+        std::optional<KeyViolation> check(std::string_view key) const;
+
+        /// @brief 逐行校验整块文本（\n 或 \r\n 分隔），违规按行回调
+        /// @details 先以 64 字节块批量判定 ASCII 成员与换行位置（支持时使用 AVX2），
+        ///          只有块内出现非成员字节的行才回退到逐码点解码
+        VerifyReport verify(std::span<const std::byte> data,
+                            const std::function<void(const KeyViolation &)> &on_violation) const;
+
+    private:
+        /// @brief 已知全部字节均为 ASCII 成员时只需检查长度与必选类别
+        std::optional<KeyViolation> check_ascii(std::string_view key) const;
+        std::optional<KeyViolation> check_line(std::string_view line, bool ascii_members) const;
+
+        CharsetBitmap members_{};
+        // ASCII 成员按 (低 4 位 → 高 3 位掩码) 排列，供查表与 SIMD 共用
+        std::array<std::uint8_t, 16> ascii_rows_{};
+        std::optional<std::size_t> length_{};
+        std::vector<BuiltinCharset> required_{};
+        // 每个 ASCII 字节所属的必选类别位掩码
+        std::array<std::uint32_t, 128> ascii_classes_{};
+    };
+
+    struct VerifyArguments
+    {
+        std::filesystem::path input{};
+        ParsedArguments policy{};
+        bool check_length{false};
+    };
+
+    /// @brief 解析 `randkey verify` 之后的参数：--input <file> 加上与生成相同的字符集/长度/--require 参数
+    VerifyArguments parse_verify_arguments(const std::vector<std::string> &args);
+
+    /// @brief 内存映射 input 并逐行校验
+    VerifyReport verify_file(const std::filesystem::path &input,
+                             const KeyPolicy &policy,
+                             const std::function<void(const KeyViolation &)> &on_violation);
+}
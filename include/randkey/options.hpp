@@ -1,12 +1,17 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "randkey/binary_codec.hpp"
 #include "randkey/charset_registry.hpp"
+#include "randkey/key_hash.hpp"
+#include "randkey/id_format.hpp"
+#include "randkey/output_tee.hpp"
 
 namespace randkey
 {
@@ -16,17 +21,100 @@ namespace randkey
         File,
     };
 
+    /// @brief --stats 的输出形式
+    enum class StatsFormat
+    {
+        None,
+        Text,
+        Json,
+    };
+
     struct GenerationOptions
     {
         CharsetRegistry registry;
+
+        /// @brief 非空时直接使用该字符集表，跳过 registry 物化（batch 模式在相同字符集的任务间共享）
+        std::shared_ptr<const CompiledCharset> compiled_charset{};
+
         std::size_t length{12};
         std::size_t count{1};
 
+        /// @brief 首个密钥的全局下标：生成下标 [start_index, start_index + count) 的密钥，
+        ///        确定性种子下与从 0 开始的单次运行中同一下标的输出逐字节相同
+        std::size_t start_index{0};
+
+        /// @brief 非 0 时进入原始字节模式：每个密钥为 raw_bytes 个随机字节，不经过字符集
+        std::size_t raw_bytes{0};
+        BinaryEncoding raw_encoding{BinaryEncoding::Binary};
+
+        /// @brief 非 None 时生成 UUID/ULID，忽略字符集与长度
+        IdFormat id_format{IdFormat::None};
+
+        /// @brief 设置时按模板生成（如 AAAA-9999-XXXX），忽略长度
+        std::optional<std::u32string> pattern{};
+
+        /// @brief 每个密钥必须至少包含一个字符的内置类别（仅字符集模式）
+        std::vector<BuiltinCharset> required_classes{};
+
+        /// @brief 设置时进入口令模式：从词表抽取 words 个单词并以 separator 连接
+        std::optional<std::filesystem::path> passphrase_wordlist{};
+        std::size_t words{6};
+        std::u32string separator{U" "};
+
+        /// @brief 批内去重：重复的密钥会被丢弃并重新生成
+        bool unique{false};
+
+        /// @brief 已签发密钥文件（每行一个）：命中的新密钥会被重新生成
+        std::optional<std::filesystem::path> exclude_file{};
+
+        /// @brief 按字节序升序输出并去重，排序阶段内存不超过 memory_limit 字节（超出部分溢出到临时文件）
+        bool sorted{false};
+        std::size_t memory_limit{256U << 20U};
+
+        /// @brief 溢出段私有目录的父目录，未设置时使用系统临时目录
+        std::optional<std::filesystem::path> temp_directory{};
+
+        /// @brief 非 0 时每写出该数量的密钥记录一次断点（需输出到文件）
+        std::size_t checkpoint_interval{0};
+
+        /// @brief 非 None 时每行附带密钥的摘要（key<TAB>hex）；hash_only 时只输出摘要
+        KeyHashAlgorithm emit_hash{KeyHashAlgorithm::None};
+        bool hash_only{false};
+
+        /// @brief 附加输出（--output-format <格式>:<文件>）：同一批密钥同时写入这些文件
+        std::vector<TeeTarget> tee_targets{};
+
         OutputTarget target{OutputTarget::Stdout};
         std::optional<std::filesystem::path> output_path{};
 
         bool force_overwrite{false};
         bool show_seed{false};
+
+        /// @brief 结束时在 stderr 输出吞吐、随机源、拒绝率、峰值内存与各阶段耗时
+        StatsFormat stats{StatsFormat::None};
+
+        /// @brief 设置时把各阶段区间（加载、编译、生成、编码、写出、刷新）导出为 Chrome trace-event JSON
+        std::optional<std::filesystem::path> trace_path{};
+    };
+
+    /// @brief 全局下标的半开区间 [begin, end)
+    struct KeyRange
+    {
+        std::uint64_t begin{0};
+        std::uint64_t end{0};
+    };
+
+    /// @brief 将 total 个密钥尽量均分为 shards 片，返回第 shard 片（从 0 起）的下标区间
+    /// @throws std::runtime_error 当 shards 为 0 或 shard >= shards
+    KeyRange shard_range(std::uint64_t total, std::uint64_t shard, std::uint64_t shards);
+
+    /// @brief 按分片区间设置 start_index 与 count
+    void apply_shard(GenerationOptions &options, std::uint64_t shard, std::uint64_t shards);
+
+    struct ShardSpec
+    {
+        std::uint64_t index{0};
+        std::uint64_t count{1};
     };
 
     struct ParsedArguments
@@ -35,6 +123,11 @@ namespace randkey
         bool request_version{false};
         std::optional<std::uint64_t> mixing_seed{};
         std::optional<std::uint64_t> deterministic_seed{};
+        std::optional<ShardSpec> shard{};
+        bool resume{false};
+
+        /// @brief 参数指纹（不含 --resume/--force/--stats/--trace），用于确认断点属于同一任务
+        std::uint64_t config_fingerprint{0};
         GenerationOptions options{};
 
         void validate() const;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace randkey
+{
+    /// @brief 附加输出的格式
+    enum class TeeFormat
+    {
+        Text,         ///< 每行一个密钥，与主输出的纯文本相同
+        Csv,          ///< 元数据表：index,bytes,sha256（不含密钥本身）
+        Sha256,       ///< 每行一个 SHA-256 十六进制摘要
+        Blake3,       ///< 每行一个 BLAKE3 十六进制摘要
+        Sha256Binary, ///< 每个密钥 32 字节原始 SHA-256 摘要，按下标顺序定长排列
+    };
+
+    /// @brief 一个附加输出：格式与目标文件
+    struct TeeTarget
+    {
+        TeeFormat format{TeeFormat::Text};
+        std::filesystem::path path{};
+    };
+
+    /// @brief 解析 `<format>:<file>`（text|csv|sha256|blake3|sha256-bin）
+    /// @throws std::runtime_error 当格式未知或缺少文件名
+    TeeTarget parse_tee_target(std::u32string_view spec);
+
+    /// @brief 把同一批密钥同时写到多个附加输出：每个输出一个写线程，密钥只编码一次并以共享块分发
+    /// @details 块在全部写线程处理完后清零释放；每个写线程最多积压 QUEUE_DEPTH 个块，写得慢时生产端等待
+    class TeeWriter
+    {
+    public:
+        static constexpr std::size_t QUEUE_DEPTH = 8;
+
+        /// @param first_index 首个密钥的全局下标（CSV 的 index 列）
+        /// @throws std::runtime_error error_output_exists（未给 force）或 error_write_file
+        TeeWriter(const std::vector<TeeTarget> &targets, bool force_overwrite, std::uint64_t first_index);
+        ~TeeWriter();
+
+        TeeWriter(const TeeWriter &) = delete;
+        TeeWriter &operator=(const TeeWriter &) = delete;
+
+        /// @brief 分发一批已编码的密钥：bytes 为首尾相接的密钥字节，ends 为各密钥的结束偏移
+        /// @details 接管 bytes 与 ends 的内容，返回后两者为空
+        /// @throws std::runtime_error 当某个输出已写入失败
+        void push(std::string &bytes, std::vector<std::size_t> &ends);
+
+        /// @brief 等待全部写线程落盘并关闭文件
+        /// @throws std::runtime_error error_write_file（首个失败的输出）
+        void close();
+
+    private:
+        struct Chunk;
+        class Sink;
+
+        std::vector<std::unique_ptr<Sink>> sinks_;
+        std::uint64_t next_index_{0};
+        bool closed_{false};
+    };
+}
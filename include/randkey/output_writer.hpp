@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/key_hash.hpp"
+
+namespace randkey
+{
+    class RunningDigest;
+    class TeeWriter;
+
+    /// @brief 带缓冲的密钥输出器，按块写入底层流以减少逐行 I/O
+    class OutputWriter
+    {
+    public:
+        explicit OutputWriter(std::ostream &stream, std::size_t buffer_limit = 1U << 16U);
+        ~OutputWriter();
+
+        OutputWriter(const OutputWriter &) = delete;
+        OutputWriter &operator=(const OutputWriter &) = delete;
+
+        /// @brief 以本地编码写出一个密钥并换行（纯 ASCII 密钥跳过转码）
+        void write_key(std::u32string_view key);
+
+        /// @brief 写出已编码的一行文本并换行
+        void write_line(std::string_view line);
+
+        /// @brief 原样写出字节，不附加分隔符
+        void write_bytes(std::string_view bytes);
+
+        /// @brief 将缓冲区内容写入底层流
+        void flush();
+
+        /// @brief 迄今写出（含仍在缓冲区中）的总字节数
+        std::uint64_t bytes_written() const noexcept;
+
+        /// @brief 此后写入底层流的字节同时累计到 digest（digest 须比写出器存活更久）
+        void track_digest(RunningDigest &digest) noexcept;
+
+        /// @brief 此后每个密钥行附带其输出字节的摘要（key<TAB>hex），hash_only 时只写 hex
+        /// @details 密钥先暂存，凑满一批后统一计算摘要再写入缓冲区，flush 时处理剩余部分；不影响 write_bytes
+        void emit_hash(KeyHashAlgorithm algorithm, bool hash_only) noexcept;
+
+        /// @brief 此后每个密钥行（不含摘要与换行）同时按批交给 tee 分发到附加输出（tee 须比写出器存活更久）
+        void tee(TeeWriter &tee) noexcept;
+
+    private:
+        bool staging() const noexcept;
+        void stage_key();
+        void drain_staged();
+        void release_staged();
+        void maybe_flush();
+        void write_out();
+
+        std::ostream &stream_;
+        std::size_t buffer_limit_;
+        std::string buffer_;
+        std::uint64_t flushed_{0};
+        RunningDigest *digest_{nullptr};
+
+        KeyHashAlgorithm hash_{KeyHashAlgorithm::None};
+        bool hash_only_{false};
+        std::string staged_;
+        std::vector<std::size_t> staged_ends_;
+        std::vector<std::string_view> staged_views_;
+        std::vector<KeyDigest> digests_;
+        TeeWriter *tee_{nullptr};
+    };
+
+    /// @brief 直接追加到 std::string 的流缓冲，用于把 OutputWriter 的输出收集到内存且可随后清零
+    class StringSink : public std::streambuf
+    {
+    public:
+        explicit StringSink(std::string &target) : target_(target) {}
+
+    protected:
+        std::streamsize xsputn(const char *data, std::streamsize size) override
+        {
+            target_.append(data, static_cast<std::size_t>(size));
+            return size;
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                target_.push_back(traits_type::to_char_type(ch));
+            }
+            return ch;
+        }
+
+    private:
+        std::string &target_;
+    };
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/charset_registry.hpp"
+
+namespace randkey
+{
+    /// @brief 模板中的一段：字面量串或“从某个字符表抽取 repeat 次”
+    struct PatternSegment
+    {
+        std::u32string literal;
+        std::size_t table{0};
+        std::size_t repeat{0};
+    };
+
+    /// @brief 编译后的模板：按位置排列的字面量段与字符表段
+    /// @details 占位符：9 数字，a 小写，A 大写，x 小写+数字，X 大写+数字，
+    ///          h 小写十六进制，H 大写十六进制，! 特殊字符，? 当前字符集；
+    ///          {n} 重复前一个元素 n 次，\ 转义下一个字符，其余字符原样输出；
+    ///          展开后每个密钥至多 1048576 个字符
+    class PatternPlan
+    {
+    public:
+        /// @brief 编译模板，? 占位符使用 active 中的字符集（为空时使用默认字符集）
+        /// @throws std::runtime_error 当模板语法错误或展开后超过字符数上限
+        static PatternPlan compile(std::u32string_view pattern, const CharsetRegistry &active);
+
+        const std::vector<PatternSegment> &segments() const noexcept;
+        const std::vector<std::vector<std::u32string>> &tables() const noexcept;
+
+        /// @brief 每个密钥的随机抽取次数
+        std::size_t draw_count() const noexcept;
+
+    private:
+        std::size_t table_for(char32_t placeholder, const CharsetRegistry &active);
+        void push_literal(std::u32string_view text, std::size_t repeat);
+        void push_draw(std::size_t table, std::size_t repeat);
+
+        std::vector<PatternSegment> segments_;
+        std::vector<std::vector<std::u32string>> tables_;
+        std::u32string table_keys_;
+    };
+}
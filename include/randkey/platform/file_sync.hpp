@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+
+namespace randkey::platform
+{
+    /// @brief 把 path 已写入的内容落盘（POSIX 为 fsync，Windows 为 FlushFileBuffers）
+    /// @return 文件无法打开或落盘失败时返回 false
+    bool sync_file(const std::filesystem::path &path) noexcept;
+
+    /// @brief 落盘 path 所在目录，使其中的创建与改名在掉电后依然可见；Windows 上无需此步骤，直接返回 true
+    bool sync_parent_directory(const std::filesystem::path &path) noexcept;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace randkey::platform
+{
+    /// @brief 本地套接字帧：4 字节小端长度 + 负载
+    constexpr std::size_t FRAME_HEADER_BYTES = 4;
+
+    /// @brief 帧负载上限，防止异常长度导致过量分配
+    constexpr std::size_t FRAME_MAX_BYTES = 64U << 20U;
+
+    /// @brief 在 path 上监听本地（Unix 域）套接字，每个连接独立线程按帧调用 handler 并回写一帧
+    /// @details 阻塞直至 stop 置位；返回前关闭全部连接并删除套接字文件。套接字文件权限为 0600；
+    ///          path 上已有文件时只替换拒绝连接的残留套接字
+    /// @throws std::runtime_error 当平台不支持、path 被其他文件或运行中的服务占用，或监听失败
+    void serve_local_socket(const std::filesystem::path &path,
+                            const std::function<std::string(std::string_view)> &handler,
+                            const std::atomic<bool> &stop);
+
+    /// @brief 本地套接字客户端：每次 request 发送一帧并等待一帧响应
+    class LocalSocketClient
+    {
+    public:
+        /// @throws std::runtime_error 当连接失败
+        explicit LocalSocketClient(const std::filesystem::path &path);
+        ~LocalSocketClient();
+
+        LocalSocketClient(const LocalSocketClient &) = delete;
+        LocalSocketClient &operator=(const LocalSocketClient &) = delete;
+
+        std::string request(std::string_view payload);
+
+    private:
+        std::intptr_t handle_{-1};
+    };
+}
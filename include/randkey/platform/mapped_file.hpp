@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace randkey::platform
+{
+    /// @brief 只读内存映射文件，析构时解除映射
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /// @throws std::runtime_error 当文件无法打开或映射
+        static MappedFile open(const std::filesystem::path &path);
+
+        std::span<const std::byte> bytes() const noexcept;
+
+    private:
+        void release() noexcept;
+
+        const std::byte *data_{nullptr};
+        std::size_t size_{0};
+        void *handle_{nullptr};
+    };
+}
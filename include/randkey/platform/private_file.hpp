@@ -0,0 +1,18 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace randkey::platform
+{
+    /// @brief 在 parent 下创建仅当前用户可访问的唯一目录（POSIX 为 mkdtemp，权限 0700）
+    /// @throws std::runtime_error 当 parent 不存在或目录无法创建
+    std::filesystem::path create_private_directory(const std::filesystem::path &parent, const std::string &prefix);
+
+    /// @brief 独占创建仅当前用户可读写的空文件（O_CREAT|O_EXCL|O_NOFOLLOW，权限 0600），已存在时失败
+    /// @throws std::runtime_error 当文件已存在或无法创建
+    void create_private_file(const std::filesystem::path &path);
+
+    /// @brief 以零覆盖文件全部内容并落盘后删除；任一步失败时仍尝试删除
+    void wipe_and_remove(const std::filesystem::path &path) noexcept;
+}
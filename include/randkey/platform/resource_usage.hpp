@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+namespace randkey::platform
+{
+    /// @brief 当前进程的峰值常驻内存（字节），平台不支持时返回 0
+    std::uint64_t peak_resident_bytes() noexcept;
+}
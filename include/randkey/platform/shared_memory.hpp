@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace randkey::platform
+{
+    /// @brief 具名共享内存区域（POSIX shm_open），可读写映射，析构时解除映射
+    /// @note 创建方析构时同时删除名称；区域权限为 0600，仅同一用户的进程可打开
+    class SharedMemory
+    {
+    public:
+        SharedMemory() = default;
+        ~SharedMemory();
+
+        SharedMemory(SharedMemory &&other) noexcept;
+        SharedMemory &operator=(SharedMemory &&other) noexcept;
+        SharedMemory(const SharedMemory &) = delete;
+        SharedMemory &operator=(const SharedMemory &) = delete;
+
+        /// @brief 创建（或替换同名残留的）区域并清零
+        /// @throws std::runtime_error 当平台不支持或创建失败
+        static SharedMemory create(const std::string &name, std::size_t size);
+
+        /// @throws std::runtime_error 当区域不存在或无法映射
+        static SharedMemory open(const std::string &name);
+
+        std::span<std::byte> bytes() const noexcept;
+
+    private:
+        void release() noexcept;
+
+        std::byte *data_{nullptr};
+        std::size_t size_{0};
+        std::string owned_name_{};
+    };
+
+    /// @brief 若 word 仍等于 expected 则休眠，直到被唤醒或超时（跨进程有效）
+    void wait_on_address(const std::atomic<std::uint32_t> &word, std::uint32_t expected, int timeout_ms) noexcept;
+
+    /// @brief 唤醒所有在 word 上等待的线程与进程
+    void wake_address(std::atomic<std::uint32_t> &word) noexcept;
+}
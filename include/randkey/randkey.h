@@ -0,0 +1,89 @@
+/* RandKey C ABI：供 Python/Go/Rust 等通过 FFI 进程内调用，头文件只使用 C 类型 */
+#ifndef RANDKEY_RANDKEY_H
+#define RANDKEY_RANDKEY_H
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+#if defined(RANDKEY_C_BUILD)
+#define RANDKEY_C_API __declspec(dllexport)
+#else
+#define RANDKEY_C_API __declspec(dllimport)
+#endif
+#else
+#define RANDKEY_C_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /** 编译后的生成计划：创建后只读，可在任意线程间共享 */
+    typedef struct randkey_plan randkey_plan;
+
+    /** 随机状态与复用缓冲；内部带锁，可跨线程使用，但每线程一个句柄可避免争用 */
+    typedef struct randkey_engine randkey_engine;
+
+    typedef enum randkey_status
+    {
+        RANDKEY_OK = 0,
+        /** 参数非法或选项不适用于进程内生成，详情见 randkey_last_error() */
+        RANDKEY_ERROR_ARGUMENT = 1,
+        /** 缓冲区不足：*out_length 为所需字节数，本次生成的密钥已作废 */
+        RANDKEY_ERROR_BUFFER_TOO_SMALL = 2,
+        /** 安全随机源不可用或其他内部错误 */
+        RANDKEY_ERROR_INTERNAL = 3
+    } randkey_status;
+
+    /** 库版本，如 "2.0.0" */
+    RANDKEY_C_API const char *randkey_version(void);
+
+    /**
+     * 当前线程最近一次失败的错误键（与命令行相同的 "error_xxx[:detail]" 格式），无错误时为空串。
+     * 返回的指针在本线程下一次调用本库之前有效。
+     */
+    RANDKEY_C_API const char *randkey_last_error(void);
+
+    /**
+     * 以命令行写法的参数编译计划（不含程序名），如 {"--upper", "--digits", "--length", "16"}。
+     * 参数按进程区域设置的编码解释；种子、--unique、--sorted、--output 等批次选项会被拒绝。
+     */
+    RANDKEY_C_API randkey_status randkey_plan_create(const char *const *args, size_t arg_count, randkey_plan **out_plan);
+
+    RANDKEY_C_API void randkey_plan_destroy(randkey_plan *plan);
+
+    /** 单个密钥的最大字节数（UTF-8，不含终止符）；按此值分配缓冲区即不会出现 BUFFER_TOO_SMALL */
+    RANDKEY_C_API size_t randkey_plan_max_key_bytes(const randkey_plan *plan);
+
+    RANDKEY_C_API randkey_status randkey_engine_create(randkey_engine **out_engine);
+
+    /** 销毁句柄并清零其中的缓冲区 */
+    RANDKEY_C_API void randkey_engine_destroy(randkey_engine *engine);
+
+    /**
+     * 生成一个 UTF-8 密钥写入 buffer（不追加终止符），*out_length 为密钥字节数。
+     * engine 为 NULL 时使用当前线程的内部句柄。稳定状态下不分配内存。
+     */
+    RANDKEY_C_API randkey_status randkey_generate_into(const randkey_plan *plan,
+                                                       randkey_engine *engine,
+                                                       char *buffer,
+                                                       size_t capacity,
+                                                       size_t *out_length);
+
+    /**
+     * 连续生成 count 个密钥写入 buffer，每个密钥后追加 '\n'，*out_length 为写入的总字节数。
+     * 缓冲区不足时返回 BUFFER_TOO_SMALL，*out_length 为已完整写入的字节数。
+     */
+    RANDKEY_C_API randkey_status randkey_generate_many_into(const randkey_plan *plan,
+                                                            randkey_engine *engine,
+                                                            size_t count,
+                                                            char *buffer,
+                                                            size_t capacity,
+                                                            size_t *out_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
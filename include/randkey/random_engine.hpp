@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <span>
+#include <vector>
 
 namespace randkey
 {
@@ -21,4 +23,31 @@ namespace randkey
         /// @throws std::invalid_argument 当 upper 为 0
         static std::uint64_t uniform(std::uint64_t upper);
     };
+
+    /// @brief 带缓冲的安全随机字节流，整块读取系统随机源以摊薄系统调用
+    /// @note 非线程安全，每个线程应持有独立实例；析构时清零缓冲区
+    class SecureRandomStream
+    {
+    public:
+        explicit SecureRandomStream(std::size_t buffer_size = 4096);
+        ~SecureRandomStream();
+
+        SecureRandomStream(const SecureRandomStream &) = delete;
+        SecureRandomStream &operator=(const SecureRandomStream &) = delete;
+
+        /// @brief 从缓冲区取出随机字节填充 out，不足时自动补充
+        void fill(std::span<std::byte> out);
+
+        std::uint64_t next_u64();
+
+        /// @brief 生成 [0, upper) 区间内的均匀随机数（拒绝采样）
+        /// @throws std::invalid_argument 当 upper 为 0
+        std::uint64_t uniform(std::uint64_t upper);
+
+    private:
+        void refill();
+
+        std::vector<std::byte> buffer_;
+        std::size_t position_;
+    };
 }
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// 由 CMake 选项 RANDKEY_ENABLE_STATS 控制；为 0 时所有计数与计时均为空内联函数，不产生任何开销
+#if !defined(RANDKEY_STATS)
+#define RANDKEY_STATS 1
+#endif
+
+namespace randkey::stats
+{
+    enum class Counter : std::size_t
+    {
+        EntropyReads,      ///< 读取系统随机源的次数（每次对应至少一个系统调用）
+        EntropyBytes,      ///< 从系统随机源读取的字节数
+        UniformDraws,      ///< uniform 返回的均匀随机数个数
+        UniformRejections, ///< uniform 拒绝采样丢弃的次数
+        Transcodes,        ///< 编码转换调用次数
+        TranscodedBytes,   ///< 编码转换输出的字节数
+        Writes,            ///< 写入输出流的次数
+        WrittenBytes,      ///< 写入输出流的字节数
+        Count,
+    };
+
+    enum class Stage : std::size_t
+    {
+        Entropy,
+        Transcode,
+        Write,
+        Count,
+    };
+
+    /// @brief 各线程计数与各阶段累计耗时之和
+    struct Snapshot
+    {
+        std::array<std::uint64_t, static_cast<std::size_t>(Counter::Count)> counters{};
+        std::array<std::uint64_t, static_cast<std::size_t>(Stage::Count)> stage_ns{};
+
+        std::uint64_t count(Counter counter) const noexcept
+        {
+            return counters[static_cast<std::size_t>(counter)];
+        }
+
+        std::uint64_t nanoseconds(Stage stage) const noexcept
+        {
+            return stage_ns[static_cast<std::size_t>(stage)];
+        }
+    };
+
+    /// @brief 一次生成运行的统计：由调用方给出密钥数、输出字节数与墙钟耗时
+    struct RunReport
+    {
+        std::uint64_t keys{0};
+        std::uint64_t output_bytes{0};
+        std::uint64_t elapsed_ns{0};
+        std::uint64_t peak_rss_bytes{0};
+        Snapshot snapshot{};
+
+        double keys_per_second() const noexcept;
+        double bytes_per_second() const noexcept;
+
+        /// @brief 拒绝次数占 uniform 抽样尝试次数的比例
+        double rejection_rate() const noexcept;
+
+        /// @brief 未归入任何阶段的耗时（生成、排序等）；多线程时各阶段之和可能超过墙钟耗时，此时为 0
+        std::uint64_t other_ns() const noexcept;
+
+        void write_json(std::ostream &out) const;
+    };
+
+    constexpr bool compiled_in() noexcept
+    {
+        return RANDKEY_STATS != 0;
+    }
+
+#if RANDKEY_STATS
+    namespace detail
+    {
+        extern std::atomic<bool> enabled_flag;
+
+        void add(Counter counter, std::uint64_t value) noexcept;
+        void add_time(Stage stage, std::uint64_t nanoseconds) noexcept;
+    }
+
+    inline bool enabled() noexcept
+    {
+        return detail::enabled_flag.load(std::memory_order_relaxed);
+    }
+
+    /// @brief 开启统计；开启前的计数与计时不会被记录
+    void enable() noexcept;
+
+    inline void add(Counter counter, std::uint64_t value = 1) noexcept
+    {
+        if (enabled())
+        {
+            detail::add(counter, value);
+        }
+    }
+
+    /// @brief 作用域计时：构造时已开启统计才读取时钟，析构时累计到所在线程的阶段耗时
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Stage stage) noexcept : stage_(stage), armed_(enabled())
+        {
+            if (armed_)
+            {
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if (armed_)
+            {
+                const auto elapsed = std::chrono::steady_clock::now() - start_;
+                detail::add_time(stage_,
+                                 static_cast<std::uint64_t>(
+                                     std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Stage stage_;
+        bool armed_;
+        std::chrono::steady_clock::time_point start_{};
+    };
+
+    /// @brief 汇总全部线程（含已退出线程）的计数与计时
+    Snapshot snapshot();
+#else
+    inline bool enabled() noexcept
+    {
+        return false;
+    }
+
+    inline void enable() noexcept {}
+
+    inline void add(Counter, std::uint64_t = 1) noexcept {}
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Stage) noexcept {}
+    };
+
+    inline Snapshot snapshot()
+    {
+        return {};
+    }
+#endif
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// 由 CMake 选项 RANDKEY_ENABLE_USDT 控制：为 1 时每个区间的起止处额外放置 USDT 探针 randkey:span_begin/span_end，
+// 未挂载 perf/bpftrace 时探针只是一条 nop
+#if !defined(RANDKEY_USDT)
+#define RANDKEY_USDT 0
+#endif
+
+namespace randkey::trace
+{
+    namespace detail
+    {
+        bool recording() noexcept;
+
+        /// @return 记录开启时为区间起点（steady_clock 纳秒），否则为 0
+        std::uint64_t begin(const char *name, std::uint64_t value) noexcept;
+        void end(const char *name, std::uint64_t value, std::uint64_t begin_ns) noexcept;
+    }
+
+    /// @brief 开始记录区间；此前结束的区间不会被记录
+    void start() noexcept;
+
+    /// @brief 是否正在记录（未开启记录且未编译 USDT 探针时区间不读取时钟）
+    inline bool enabled() noexcept
+    {
+        return detail::recording();
+    }
+
+    /// @brief 流水线阶段的作用域区间：写入所在线程的无锁事件缓冲，并在启用 USDT 时触发探针
+    /// @param name 须为静态字符串（如 "generate"），只保存指针
+    /// @param value 附加数值（如密钥数、字节数），导出为 args.value
+    class Span
+    {
+    public:
+        explicit Span(const char *name, std::uint64_t value = 0) noexcept : name_(name), value_(value)
+        {
+            if (RANDKEY_USDT != 0 || enabled())
+            {
+                armed_ = true;
+                begin_ = detail::begin(name_, value_);
+            }
+        }
+
+        ~Span()
+        {
+            if (armed_)
+            {
+                detail::end(name_, value_, begin_);
+            }
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *name_;
+        std::uint64_t value_;
+        std::uint64_t begin_{0};
+        bool armed_{false};
+    };
+
+    /// @brief 以 Chrome trace-event JSON（chrome://tracing、Perfetto 可直接打开）导出已记录的全部区间
+    /// @details 只应在工作线程结束或停止产生区间之后调用
+    void write_chrome_trace(std::ostream &out);
+}
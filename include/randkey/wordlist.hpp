@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace randkey
+{
+    /// @brief 驻留式词表：整文件读入一块内存，按行切分去重，单词以本地编码字节保存
+    /// @details 输入与输出同为本地编码，生成时直接拷贝字节，无需逐词转码
+    class Wordlist
+    {
+    public:
+        Wordlist() = default;
+
+        /// @brief 从文件加载（每行一个单词，忽略空行与重复项，兼容 CRLF）
+        /// @throws std::runtime_error 当文件无法读取或不含任何单词
+        static Wordlist load(const std::filesystem::path &path);
+
+        /// @brief 由内存中的单词构建（单词为本地编码字节）
+        static Wordlist from_words(const std::vector<std::string> &words);
+
+        std::size_t size() const noexcept;
+        std::string_view word(std::size_t index) const noexcept;
+
+        /// @brief 每个单词贡献的熵（log2(size)）
+        double bits_per_word() const noexcept;
+
+    private:
+        void intern(std::string data);
+
+        std::string data_;
+        std::vector<std::uint64_t> entries_;
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace randkey
+{
+    /// @brief 工作窃取线程池：每个工作线程有自己的双端队列，本线程从尾部取（LIFO，缓存友好），
+    ///        空闲线程从其他队列头部窃取（FIFO，先拿到较早拆出的大块任务）
+    class WorkStealingPool
+    {
+    public:
+        /// @param threads 工作线程数，0 表示使用硬件并发数
+        explicit WorkStealingPool(std::size_t threads = 0);
+
+        /// @brief 等待已提交任务全部完成后退出
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        /// @brief 提交任务：在工作线程内调用时压入本线程队列，否则轮流分发
+        /// @note 任务抛出的异常会被吞掉，需要上报的错误应由任务自行记录
+        void submit(std::function<void()> task);
+
+        /// @brief 阻塞直到所有已提交（包括任务内再提交）的任务完成
+        void wait();
+
+        std::size_t size() const noexcept;
+
+    private:
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void worker_loop(std::size_t self);
+        bool try_pop(std::size_t self, std::function<void()> &task);
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+
+        std::mutex idle_mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable all_done_;
+        std::size_t pending_{0};
+        std::size_t queued_{0};
+        bool stopping_{false};
+        std::atomic<std::size_t> next_queue_{0};
+    };
+}
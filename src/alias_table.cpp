@@ -0,0 +1,84 @@
+#include "randkey/alias_table.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::uint64_t COIN_SCALE = 1ULL << 32U;
+        constexpr std::uint64_t COLUMN_RANGE = 1ULL << 32U;
+    }
+
+    AliasTable::AliasTable(std::span<const double> weights)
+    {
+        const std::size_t n = weights.size();
+        if (n == 0 || static_cast<std::uint64_t>(n) > COLUMN_RANGE)
+        {
+            throw std::invalid_argument("别名表权重数量非法");
+        }
+
+        double total = 0.0;
+        for (double weight : weights)
+        {
+            if (!std::isfinite(weight) || weight <= 0.0)
+            {
+                throw std::invalid_argument("别名表权重必须为有限正数");
+            }
+            total += weight;
+        }
+
+        std::vector<double> scaled(n);
+        std::vector<std::uint32_t> small;
+        std::vector<std::uint32_t> large;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            scaled[i] = weights[i] * static_cast<double>(n) / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+        }
+
+        thresholds_.assign(n, COIN_SCALE);
+        aliases_.resize(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            aliases_[i] = static_cast<std::uint32_t>(i);
+        }
+
+        while (!small.empty() && !large.empty())
+        {
+            const std::uint32_t less = small.back();
+            small.pop_back();
+            const std::uint32_t more = large.back();
+            large.pop_back();
+
+            thresholds_[less] = static_cast<std::uint64_t>(std::llround(scaled[less] * static_cast<double>(COIN_SCALE)));
+            aliases_[less] = more;
+
+            scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+            (scaled[more] < 1.0 ? small : large).push_back(more);
+        }
+        // 剩余列（含浮点误差导致的残留）概率视为 1，阈值保持 COIN_SCALE
+
+        column_limit_ = COLUMN_RANGE - (COLUMN_RANGE % static_cast<std::uint64_t>(n));
+    }
+
+    std::size_t AliasTable::size() const noexcept
+    {
+        return thresholds_.size();
+    }
+
+    bool AliasTable::try_sample(std::uint64_t word, std::size_t &out) const noexcept
+    {
+        const std::uint64_t column_bits = word & 0xFFFFFFFFULL;
+        if (column_bits >= column_limit_)
+        {
+            return false;
+        }
+
+        const std::size_t column = static_cast<std::size_t>(column_bits % thresholds_.size());
+        const std::uint64_t coin = word >> 32U;
+        out = coin < thresholds_[column] ? column : aliases_[column];
+        return true;
+    }
+}
@@ -0,0 +1,631 @@
+#include "randkey/batch.hpp"
+
+#include "randkey/generator.hpp"
+#include "randkey/output_writer.hpp"
+#include "randkey/trace.hpp"
+#include "randkey/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 可拆分作业的切块大小（密钥数）：足够摊薄任务开销，又让多个线程能分担同一个大作业
+        constexpr std::size_t CHUNK_KEYS = 1U << 16U;
+
+        /// @brief 仅支持作业文件所需的 JSON 子集：对象、字符串、字符串数组
+        class JsonLine
+        {
+        public:
+            explicit JsonLine(std::string_view text) : text_(text) {}
+
+            template <typename OnMember>
+            void parse_object(OnMember &&on_member)
+            {
+                expect('{');
+                if (peek() == '}')
+                {
+                    ++pos_;
+                }
+                else
+                {
+                    for (;;)
+                    {
+                        const std::string key = parse_string();
+                        expect(':');
+                        on_member(key, *this);
+                        if (peek() == ',')
+                        {
+                            ++pos_;
+                            continue;
+                        }
+                        expect('}');
+                        break;
+                    }
+                }
+                if (peek() != '\0')
+                {
+                    fail();
+                }
+            }
+
+            bool next_is_array()
+            {
+                return peek() == '[';
+            }
+
+            std::vector<std::string> parse_string_array()
+            {
+                std::vector<std::string> values;
+                expect('[');
+                if (peek() == ']')
+                {
+                    ++pos_;
+                    return values;
+                }
+                for (;;)
+                {
+                    values.push_back(parse_string());
+                    if (peek() == ',')
+                    {
+                        ++pos_;
+                        continue;
+                    }
+                    expect(']');
+                    return values;
+                }
+            }
+
+            std::string parse_string()
+            {
+                expect('"');
+                std::string value;
+                while (pos_ < text_.size() && text_[pos_] != '"')
+                {
+                    const char ch = text_[pos_++];
+                    if (ch != '\\')
+                    {
+                        value.push_back(ch);
+                        continue;
+                    }
+                    if (pos_ >= text_.size())
+                    {
+                        fail();
+                    }
+                    switch (const char escaped = text_[pos_++])
+                    {
+                    case '"':
+                    case '\\':
+                    case '/':
+                        value.push_back(escaped);
+                        break;
+                    case 'b':
+                        value.push_back('\b');
+                        break;
+                    case 'f':
+                        value.push_back('\f');
+                        break;
+                    case 'n':
+                        value.push_back('\n');
+                        break;
+                    case 'r':
+                        value.push_back('\r');
+                        break;
+                    case 't':
+                        value.push_back('\t');
+                        break;
+                    case 'u':
+                        append_utf8(value, parse_code_point());
+                        break;
+                    default:
+                        fail();
+                    }
+                }
+                expect('"');
+                return value;
+            }
+
+        private:
+            [[noreturn]] void fail() const
+            {
+                throw std::runtime_error("error_batch_json:" + std::to_string(pos_ + 1));
+            }
+
+            char peek()
+            {
+                while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r'))
+                {
+                    ++pos_;
+                }
+                return pos_ < text_.size() ? text_[pos_] : '\0';
+            }
+
+            void expect(char ch)
+            {
+                if (peek() != ch)
+                {
+                    fail();
+                }
+                ++pos_;
+            }
+
+            std::uint32_t parse_hex4()
+            {
+                if (pos_ + 4 > text_.size())
+                {
+                    fail();
+                }
+                std::uint32_t value = 0;
+                for (int i = 0; i < 4; ++i)
+                {
+                    const char ch = text_[pos_++];
+                    value <<= 4U;
+                    if (ch >= '0' && ch <= '9')
+                    {
+                        value |= static_cast<std::uint32_t>(ch - '0');
+                    }
+                    else if (ch >= 'a' && ch <= 'f')
+                    {
+                        value |= static_cast<std::uint32_t>(ch - 'a' + 10);
+                    }
+                    else if (ch >= 'A' && ch <= 'F')
+                    {
+                        value |= static_cast<std::uint32_t>(ch - 'A' + 10);
+                    }
+                    else
+                    {
+                        fail();
+                    }
+                }
+                return value;
+            }
+
+            std::uint32_t parse_code_point()
+            {
+                const std::uint32_t high = parse_hex4();
+                if (high < 0xD800U || high > 0xDFFFU)
+                {
+                    return high;
+                }
+                // 代理对：必须紧跟 \uDC00-\uDFFF
+                if (high > 0xDBFFU || pos_ + 2 > text_.size() || text_[pos_] != '\\' || text_[pos_ + 1] != 'u')
+                {
+                    fail();
+                }
+                pos_ += 2;
+                const std::uint32_t low = parse_hex4();
+                if (low < 0xDC00U || low > 0xDFFFU)
+                {
+                    fail();
+                }
+                return 0x10000U + ((high - 0xD800U) << 10U) + (low - 0xDC00U);
+            }
+
+            static void append_utf8(std::string &out, std::uint32_t cp)
+            {
+                if (cp < 0x80U)
+                {
+                    out.push_back(static_cast<char>(cp));
+                }
+                else if (cp < 0x800U)
+                {
+                    out.push_back(static_cast<char>(0xC0U | (cp >> 6U)));
+                    out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+                }
+                else if (cp < 0x10000U)
+                {
+                    out.push_back(static_cast<char>(0xE0U | (cp >> 12U)));
+                    out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+                    out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+                }
+                else
+                {
+                    out.push_back(static_cast<char>(0xF0U | (cp >> 18U)));
+                    out.push_back(static_cast<char>(0x80U | ((cp >> 12U) & 0x3FU)));
+                    out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+                    out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+                }
+            }
+
+            std::string_view text_;
+            std::size_t pos_{0};
+        };
+
+        /// @brief 字符集表的内容键：token 以 NUL 分隔，随后是权重的位模式
+        std::u32string charset_key(const CompiledCharset &charset)
+        {
+            std::u32string key;
+            key.push_back(charset.weighted ? U'W' : U'U');
+            for (const auto &token : charset.tokens)
+            {
+                key.append(token);
+                key.push_back(U'\0');
+            }
+            if (charset.weighted)
+            {
+                for (double weight : charset.weights)
+                {
+                    const auto bits = std::bit_cast<std::uint64_t>(weight);
+                    key.push_back(static_cast<char32_t>(bits >> 32U));
+                    key.push_back(static_cast<char32_t>(bits & 0xFFFFFFFFU));
+                }
+            }
+            return key;
+        }
+
+        /// @brief 单个作业的运行状态：切块按序提交到输出文件
+        struct JobState
+        {
+            std::size_t line{0};
+            GenerationOptions options{};
+            std::optional<std::uint64_t> deterministic_seed{};
+            std::optional<std::uint64_t> mixing_seed{};
+            std::size_t chunks{1};
+
+            std::mutex mutex{};
+            std::size_t next_commit{0};
+            std::map<std::size_t, std::string> pending{};
+            std::ofstream out{};
+            std::atomic<bool> failed{false};
+            std::string error{};
+        };
+
+        void wipe(std::string &buffer)
+        {
+            std::fill(buffer.begin(), buffer.end(), '\0');
+            buffer.clear();
+        }
+
+        void record_failure(JobState &job, const std::string &error)
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (!job.failed.exchange(true))
+            {
+                job.error = error;
+            }
+            for (auto &entry : job.pending)
+            {
+                wipe(entry.second);
+            }
+            job.pending.clear();
+        }
+
+        /// @brief 单块作业：直接流式写入文件，不在内存中缓存整份输出
+        void run_whole(JobState &job)
+        {
+            const auto &path = job.options.output_path.value();
+            std::ofstream out(path, std::ios::binary);
+            if (!out)
+            {
+                throw std::runtime_error("error_write_file:" + path.string());
+            }
+            {
+                OutputWriter writer(out);
+                RandomKeyGenerator().generate(job.options, writer, job.deterministic_seed, job.mixing_seed);
+            }
+            out.flush();
+            if (!out)
+            {
+                throw std::runtime_error("error_write_file:" + path.string());
+            }
+        }
+
+        /// @brief 把已完成的块按序写入文件；调用方持有 job.mutex
+        void commit_ready(JobState &job)
+        {
+            const auto &path = job.options.output_path.value();
+            for (auto it = job.pending.find(job.next_commit); it != job.pending.end();
+                 it = job.pending.find(job.next_commit))
+            {
+                if (!job.out.is_open())
+                {
+                    job.out.open(path, std::ios::binary);
+                }
+                {
+                    trace::Span span("write", it->second.size());
+                    job.out.write(it->second.data(), static_cast<std::streamsize>(it->second.size()));
+                }
+                wipe(it->second);
+                job.pending.erase(it);
+                ++job.next_commit;
+                if (!job.out)
+                {
+                    throw std::runtime_error("error_write_file:" + path.string());
+                }
+            }
+
+            if (job.next_commit == job.chunks)
+            {
+                job.out.close();
+                if (job.out.fail())
+                {
+                    throw std::runtime_error("error_write_file:" + path.string());
+                }
+            }
+        }
+
+        /// @brief 生成第 chunk 块；先把下一块作为任务压入本线程队列，空闲线程可以窃取它，
+        ///        因此同一作业的块大致按序推进，待提交的缓存块数不超过线程数
+        void run_chunk(WorkStealingPool &pool, JobState &job, std::size_t chunk)
+        {
+            if (job.failed.load())
+            {
+                return;
+            }
+            if (chunk + 1 < job.chunks)
+            {
+                pool.submit([&pool, &job, chunk] { run_chunk(pool, job, chunk + 1); });
+            }
+
+            try
+            {
+                if (job.chunks == 1)
+                {
+                    run_whole(job);
+                    return;
+                }
+
+                GenerationOptions options = job.options;
+                options.start_index = job.options.start_index + chunk * CHUNK_KEYS;
+                options.count = std::min(CHUNK_KEYS, job.options.count - chunk * CHUNK_KEYS);
+
+                std::string buffer;
+                {
+                    StringSink sink(buffer);
+                    std::ostream stream(&sink);
+                    OutputWriter writer(stream);
+                    RandomKeyGenerator().generate(options, writer, job.deterministic_seed, job.mixing_seed);
+                }
+
+                std::lock_guard<std::mutex> lock(job.mutex);
+                if (job.failed.load())
+                {
+                    wipe(buffer);
+                    return;
+                }
+                job.pending.emplace(chunk, std::move(buffer));
+                commit_ready(job);
+            }
+            catch (const std::exception &ex)
+            {
+                record_failure(job, ex.what());
+            }
+        }
+
+        /// @brief 去重、排序、排除与断点依赖整批语义，不能按下标区间拆分；
+        ///        uuid7/ulid 的单调性依赖同一个格式化器，标识符作业同样整体执行
+        bool splittable(const GenerationOptions &options)
+        {
+            return !options.unique && !options.sorted && !options.exclude_file.has_value() &&
+                   options.checkpoint_interval == 0 && options.id_format == IdFormat::None;
+        }
+    }
+
+    ParsedArguments parse_batch_job(std::string_view line)
+    {
+        std::vector<std::string> args;
+        std::optional<std::string> output;
+
+        JsonLine json(line);
+        json.parse_object([&](const std::string &key, JsonLine &value) {
+            if (key == "args")
+            {
+                if (value.next_is_array())
+                {
+                    args = value.parse_string_array();
+                }
+                else
+                {
+                    std::istringstream fields(value.parse_string());
+                    args.clear();
+                    for (std::string token; fields >> token;)
+                    {
+                        args.push_back(std::move(token));
+                    }
+                }
+            }
+            else if (key == "output")
+            {
+                output = value.parse_string();
+            }
+            else
+            {
+                throw std::runtime_error("error_batch_key:" + key);
+            }
+        });
+
+        if (output.has_value())
+        {
+            args.emplace_back("--output");
+            args.push_back(std::move(output.value()));
+        }
+
+        std::vector<const char *> argv{"randkey"};
+        for (const auto &arg : args)
+        {
+            argv.push_back(arg.c_str());
+        }
+        ParsedArguments parsed = ArgumentParser().parse(static_cast<int>(argv.size()), argv.data());
+
+        // 作业之间并发执行，只能写各自的文件；--resume 依赖交互式重跑，不适用于批处理
+        if (parsed.options.target != OutputTarget::File || parsed.resume || parsed.request_help ||
+            parsed.request_version)
+        {
+            throw std::runtime_error("error_batch_output");
+        }
+        // 大作业按区间分块并发生成，附加输出无法保持顺序
+        if (!parsed.options.tee_targets.empty())
+        {
+            throw std::runtime_error("error_output_format_mode");
+        }
+        // 追踪覆盖整个进程，只能作为 `randkey batch --trace` 给出
+        if (parsed.options.trace_path.has_value())
+        {
+            throw std::runtime_error("error_batch_trace");
+        }
+        return parsed;
+    }
+
+    std::vector<BatchJob> load_batch_jobs(const std::filesystem::path &path, std::vector<BatchFailure> &failures)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("error_batch_file:" + path.string());
+        }
+
+        std::vector<BatchJob> jobs;
+        std::set<std::filesystem::path> outputs;
+        std::size_t line_number = 0;
+        for (std::string line; std::getline(file, line);)
+        {
+            ++line_number;
+            const auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+
+            try
+            {
+                BatchJob job{line_number, parse_batch_job(line)};
+                const auto &output = job.arguments.options.output_path.value();
+                if (!outputs.insert(std::filesystem::absolute(output).lexically_normal()).second)
+                {
+                    throw std::runtime_error("error_batch_duplicate_output:" + output.string());
+                }
+                if (std::filesystem::exists(output) && !job.arguments.options.force_overwrite)
+                {
+                    throw std::runtime_error("error_output_exists:" + output.string());
+                }
+                jobs.push_back(std::move(job));
+            }
+            catch (const std::exception &ex)
+            {
+                failures.push_back(BatchFailure{line_number, ex.what()});
+            }
+        }
+        return jobs;
+    }
+
+    BatchReport run_batch(std::vector<BatchJob> jobs, std::size_t threads)
+    {
+        BatchReport report;
+        report.jobs = jobs.size();
+
+        // 相同内容的字符集只物化一次，所有作业及其切块共享同一张只读表
+        std::map<std::u32string, std::shared_ptr<const CompiledCharset>> charsets;
+        std::vector<std::unique_ptr<JobState>> states;
+        states.reserve(jobs.size());
+        for (auto &job : jobs)
+        {
+            auto state = std::make_unique<JobState>();
+            state->line = job.line;
+            state->options = std::move(job.arguments.options);
+            state->deterministic_seed = job.arguments.deterministic_seed;
+            state->mixing_seed = job.arguments.mixing_seed;
+
+            auto compiled = state->options.registry.compile();
+            auto [it, inserted] = charsets.emplace(charset_key(*compiled), compiled);
+            state->options.compiled_charset = it->second;
+
+            if (splittable(state->options) && state->options.count > CHUNK_KEYS)
+            {
+                state->chunks = (state->options.count + CHUNK_KEYS - 1) / CHUNK_KEYS;
+            }
+            report.keys += state->options.count;
+            states.push_back(std::move(state));
+        }
+        report.charset_tables = charsets.size();
+
+        // 大作业先提交：它们的后续块最先被其他线程窃取，小作业填补空隙
+        std::vector<JobState *> order;
+        order.reserve(states.size());
+        for (auto &state : states)
+        {
+            order.push_back(state.get());
+        }
+        std::stable_sort(order.begin(), order.end(), [](const JobState *a, const JobState *b) {
+            return a->options.count > b->options.count;
+        });
+
+        {
+            WorkStealingPool pool(threads);
+            for (JobState *job : order)
+            {
+                pool.submit([&pool, job] { run_chunk(pool, *job, 0); });
+            }
+            pool.wait();
+        }
+
+        for (const auto &state : states)
+        {
+            if (state->failed.load())
+            {
+                report.keys -= state->options.count;
+                report.failures.push_back(BatchFailure{state->line, state->error});
+            }
+        }
+        return report;
+    }
+
+    BatchArguments parse_batch_arguments(const std::vector<std::string> &args)
+    {
+        BatchArguments result;
+        bool has_jobs = false;
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            const std::string &arg = args[i];
+            if (arg == "--threads")
+            {
+                if (i + 1 >= args.size())
+                {
+                    throw std::runtime_error("error_missing_arg:" + arg);
+                }
+                const std::string &text = args[++i];
+                const bool digits = !text.empty() && text.size() < 6 &&
+                                    std::all_of(text.begin(), text.end(), [](char ch) { return ch >= '0' && ch <= '9'; });
+                if (!digits || std::stoul(text) == 0)
+                {
+                    throw std::runtime_error("error_batch_threads");
+                }
+                result.threads = std::stoul(text);
+            }
+            else if (arg == "--trace")
+            {
+                if (i + 1 >= args.size())
+                {
+                    throw std::runtime_error("error_missing_arg:" + arg);
+                }
+                result.trace = std::filesystem::path(args[++i]);
+            }
+            else if (!has_jobs && !arg.starts_with("--"))
+            {
+                result.jobs = std::filesystem::path(arg);
+                has_jobs = true;
+            }
+            else
+            {
+                throw std::runtime_error("error_unknown_flag:" + arg);
+            }
+        }
+
+        if (!has_jobs)
+        {
+            throw std::runtime_error("error_batch_usage");
+        }
+        return result;
+    }
+}
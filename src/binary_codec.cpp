@@ -0,0 +1,186 @@
+#include "randkey/binary_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::string_view HEX_ALPHABET = "0123456789abcdef";
+        constexpr std::string_view BASE32_ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+        constexpr std::string_view BASE64_ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        constexpr std::string_view BASE64URL_ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        /// @brief 每个字节对应两个十六进制字符，整表查找避免逐半字节分支
+        constexpr std::array<char, 512> HEX_PAIRS = [] {
+            std::array<char, 512> table{};
+            for (std::size_t i = 0; i < 256; ++i)
+            {
+                table[i * 2] = HEX_ALPHABET[i >> 4U];
+                table[i * 2 + 1] = HEX_ALPHABET[i & 0x0FU];
+            }
+            return table;
+        }();
+
+        std::uint32_t byte_at(std::span<const std::byte> data, std::size_t index)
+        {
+            return static_cast<std::uint32_t>(std::to_integer<unsigned char>(data[index]));
+        }
+
+        void append_hex(std::string &out, std::span<const std::byte> data)
+        {
+            const std::size_t start = out.size();
+            out.resize(start + data.size() * 2);
+            char *dst = out.data() + start;
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                const std::uint32_t value = byte_at(data, i);
+                dst[i * 2] = HEX_PAIRS[value * 2];
+                dst[i * 2 + 1] = HEX_PAIRS[value * 2 + 1];
+            }
+        }
+
+        void append_base64(std::string &out, std::span<const std::byte> data, std::string_view alphabet, bool pad)
+        {
+            const std::size_t full = data.size() / 3;
+            const std::size_t start = out.size();
+            out.resize(start + full * 4);
+            char *dst = out.data() + start;
+
+            for (std::size_t i = 0; i < full; ++i)
+            {
+                const std::uint32_t group = (byte_at(data, i * 3) << 16U) |
+                                            (byte_at(data, i * 3 + 1) << 8U) |
+                                            byte_at(data, i * 3 + 2);
+                dst[i * 4] = alphabet[(group >> 18U) & 0x3FU];
+                dst[i * 4 + 1] = alphabet[(group >> 12U) & 0x3FU];
+                dst[i * 4 + 2] = alphabet[(group >> 6U) & 0x3FU];
+                dst[i * 4 + 3] = alphabet[group & 0x3FU];
+            }
+
+            const std::size_t rest = data.size() - full * 3;
+            if (rest == 0)
+            {
+                return;
+            }
+
+            std::uint32_t group = byte_at(data, full * 3) << 16U;
+            if (rest == 2)
+            {
+                group |= byte_at(data, full * 3 + 1) << 8U;
+            }
+
+            out.push_back(alphabet[(group >> 18U) & 0x3FU]);
+            out.push_back(alphabet[(group >> 12U) & 0x3FU]);
+            if (rest == 2)
+            {
+                out.push_back(alphabet[(group >> 6U) & 0x3FU]);
+            }
+            if (pad)
+            {
+                out.append(rest == 1 ? 2 : 1, '=');
+            }
+        }
+
+        void append_base32(std::string &out, std::span<const std::byte> data)
+        {
+            std::size_t index = 0;
+            while (index < data.size())
+            {
+                const std::size_t chunk = std::min<std::size_t>(5, data.size() - index);
+                std::uint64_t group = 0;
+                for (std::size_t i = 0; i < 5; ++i)
+                {
+                    group <<= 8U;
+                    if (i < chunk)
+                    {
+                        group |= byte_at(data, index + i);
+                    }
+                }
+
+                // 1..5 个输入字节分别产生 2/4/5/7/8 个有效字符，其余位置填充 '='
+                constexpr std::array<std::size_t, 6> SYMBOLS = {0, 2, 4, 5, 7, 8};
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    if (i < SYMBOLS[chunk])
+                    {
+                        out.push_back(BASE32_ALPHABET[(group >> (35U - i * 5U)) & 0x1FU]);
+                    }
+                    else
+                    {
+                        out.push_back('=');
+                    }
+                }
+                index += chunk;
+            }
+        }
+    }
+
+    BinaryEncoding parse_binary_encoding(std::u32string_view name)
+    {
+        if (name == U"binary" || name == U"raw")
+        {
+            return BinaryEncoding::Binary;
+        }
+        if (name == U"hex")
+        {
+            return BinaryEncoding::Hex;
+        }
+        if (name == U"base32")
+        {
+            return BinaryEncoding::Base32;
+        }
+        if (name == U"base64")
+        {
+            return BinaryEncoding::Base64;
+        }
+        if (name == U"base64url")
+        {
+            return BinaryEncoding::Base64Url;
+        }
+        throw std::runtime_error("error_binary_encoding");
+    }
+
+    std::size_t encoded_size(std::size_t input_size, BinaryEncoding encoding) noexcept
+    {
+        switch (encoding)
+        {
+        case BinaryEncoding::Binary:
+            return input_size;
+        case BinaryEncoding::Hex:
+            return input_size * 2;
+        case BinaryEncoding::Base32:
+            return (input_size + 4) / 5 * 8;
+        case BinaryEncoding::Base64:
+            return (input_size + 2) / 3 * 4;
+        case BinaryEncoding::Base64Url:
+            return (input_size * 4 + 2) / 3;
+        }
+        return input_size;
+    }
+
+    void append_encoded(std::string &out, std::span<const std::byte> data, BinaryEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case BinaryEncoding::Binary:
+            out.append(reinterpret_cast<const char *>(data.data()), data.size());
+            break;
+        case BinaryEncoding::Hex:
+            append_hex(out, data);
+            break;
+        case BinaryEncoding::Base32:
+            append_base32(out, data);
+            break;
+        case BinaryEncoding::Base64:
+            append_base64(out, data, BASE64_ALPHABET, true);
+            break;
+        case BinaryEncoding::Base64Url:
+            append_base64(out, data, BASE64URL_ALPHABET, false);
+            break;
+        }
+    }
+}
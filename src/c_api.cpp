@@ -0,0 +1,202 @@
+#include "randkey/randkey.h"
+
+#include "randkey/key_plan.hpp"
+#include "randkey/options.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct randkey_plan
+{
+    randkey::KeyPlan plan;
+};
+
+struct randkey_engine
+{
+    std::mutex mutex;
+    randkey::KeyEngine engine;
+};
+
+namespace
+{
+    thread_local std::string last_error;
+
+    /// @brief 未传入句柄时每个线程使用自己的引擎，无需加锁
+    randkey::KeyEngine &thread_engine()
+    {
+        thread_local randkey::KeyEngine engine;
+        return engine;
+    }
+
+    randkey_status fail(randkey_status status, const char *error)
+    {
+        last_error.assign(error);
+        return status;
+    }
+
+    /// @brief 把 C++ 异常转换为状态码：异常不能跨越 C ABI 边界
+    template <typename Body>
+    randkey_status guarded(Body &&body) noexcept
+    {
+        try
+        {
+            last_error.clear();
+            return body();
+        }
+        catch (const std::bad_alloc &)
+        {
+            return fail(RANDKEY_ERROR_INTERNAL, "error_out_of_memory");
+        }
+        catch (const std::runtime_error &ex)
+        {
+            const std::string_view what = ex.what();
+            const bool internal = what.starts_with("error_random_device");
+            return fail(internal ? RANDKEY_ERROR_INTERNAL : RANDKEY_ERROR_ARGUMENT, ex.what());
+        }
+        catch (const std::exception &ex)
+        {
+            return fail(RANDKEY_ERROR_INTERNAL, ex.what());
+        }
+        catch (...)
+        {
+            return fail(RANDKEY_ERROR_INTERNAL, "error_internal");
+        }
+    }
+
+    template <typename Body>
+    randkey_status with_engine(randkey_engine *engine, Body &&body)
+    {
+        if (engine == nullptr)
+        {
+            return body(thread_engine());
+        }
+        std::lock_guard<std::mutex> lock(engine->mutex);
+        return body(engine->engine);
+    }
+}
+
+extern "C"
+{
+    const char *randkey_version(void)
+    {
+        return RANDKEY_VERSION;
+    }
+
+    const char *randkey_last_error(void)
+    {
+        return last_error.c_str();
+    }
+
+    randkey_status randkey_plan_create(const char *const *args, size_t arg_count, randkey_plan **out_plan)
+    {
+        return guarded([&] {
+            if (out_plan == nullptr || (args == nullptr && arg_count != 0))
+            {
+                return fail(RANDKEY_ERROR_ARGUMENT, "error_null_argument");
+            }
+            *out_plan = nullptr;
+
+            std::vector<const char *> argv{"randkey"};
+            argv.insert(argv.end(), args, args + arg_count);
+            const randkey::ParsedArguments parsed =
+                randkey::ArgumentParser().parse(static_cast<int>(argv.size()), argv.data());
+            if (parsed.deterministic_seed.has_value() || parsed.mixing_seed.has_value() || parsed.resume ||
+                parsed.shard.has_value() || parsed.request_help || parsed.request_version)
+            {
+                return fail(RANDKEY_ERROR_ARGUMENT, "error_plan_option");
+            }
+
+            *out_plan = new randkey_plan{randkey::KeyPlan::compile(parsed.options)};
+            return RANDKEY_OK;
+        });
+    }
+
+    void randkey_plan_destroy(randkey_plan *plan)
+    {
+        delete plan;
+    }
+
+    size_t randkey_plan_max_key_bytes(const randkey_plan *plan)
+    {
+        return plan == nullptr ? 0 : plan->plan.max_key_bytes();
+    }
+
+    randkey_status randkey_engine_create(randkey_engine **out_engine)
+    {
+        return guarded([&] {
+            if (out_engine == nullptr)
+            {
+                return fail(RANDKEY_ERROR_ARGUMENT, "error_null_argument");
+            }
+            *out_engine = new randkey_engine{};
+            return RANDKEY_OK;
+        });
+    }
+
+    void randkey_engine_destroy(randkey_engine *engine)
+    {
+        delete engine;
+    }
+
+    randkey_status randkey_generate_into(const randkey_plan *plan,
+                                         randkey_engine *engine,
+                                         char *buffer,
+                                         size_t capacity,
+                                         size_t *out_length)
+    {
+        return guarded([&] {
+            if (plan == nullptr || out_length == nullptr || (buffer == nullptr && capacity != 0))
+            {
+                return fail(RANDKEY_ERROR_ARGUMENT, "error_null_argument");
+            }
+            return with_engine(engine, [&](randkey::KeyEngine &state) {
+                *out_length = plan->plan.generate_into(state, buffer, capacity);
+                if (*out_length > capacity)
+                {
+                    std::fill(buffer, buffer + capacity, '\0');
+                    return RANDKEY_ERROR_BUFFER_TOO_SMALL;
+                }
+                return RANDKEY_OK;
+            });
+        });
+    }
+
+    randkey_status randkey_generate_many_into(const randkey_plan *plan,
+                                              randkey_engine *engine,
+                                              size_t count,
+                                              char *buffer,
+                                              size_t capacity,
+                                              size_t *out_length)
+    {
+        return guarded([&] {
+            if (plan == nullptr || out_length == nullptr || (buffer == nullptr && capacity != 0))
+            {
+                return fail(RANDKEY_ERROR_ARGUMENT, "error_null_argument");
+            }
+            *out_length = 0;
+            return with_engine(engine, [&](randkey::KeyEngine &state) {
+                std::size_t used = 0;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const std::size_t room = capacity - used;
+                    const std::size_t length = plan->plan.generate_into(state, buffer + used, room);
+                    if (length >= room)
+                    {
+                        // 放不下密钥及其换行：丢弃这一条残留字节
+                        std::fill(buffer + used, buffer + capacity, '\0');
+                        *out_length = used;
+                        return RANDKEY_ERROR_BUFFER_TOO_SMALL;
+                    }
+                    buffer[used + length] = '\n';
+                    used += length + 1;
+                }
+                *out_length = used;
+                return RANDKEY_OK;
+            });
+        });
+    }
+}
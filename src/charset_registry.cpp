@@ -1,10 +1,14 @@
 #include "randkey/charset_registry.hpp"
 
 #include "randkey/encoding.hpp"
+#include "randkey/trace.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace randkey
 {
@@ -14,27 +18,76 @@ namespace randkey
         constexpr std::u32string_view UPPERCASE = U"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
         constexpr std::u32string_view DIGITS = U"0123456789";
         constexpr std::u32string_view SPECIAL = U"!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+        constexpr std::u32string_view HEX = U"0123456789abcdef";
+        constexpr std::u32string_view BASE32 = U"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+        constexpr std::u32string_view BASE64 = U"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        constexpr std::u32string_view BASE64URL = U"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        // 内置字符集均为 ASCII，位图在编译期构造
+        constexpr CharsetBitmap LOWERCASE_BITS{LOWERCASE};
+        constexpr CharsetBitmap UPPERCASE_BITS{UPPERCASE};
+        constexpr CharsetBitmap DIGITS_BITS{DIGITS};
+        constexpr CharsetBitmap SPECIAL_BITS{SPECIAL};
+        constexpr CharsetBitmap HEX_BITS{HEX};
+        constexpr CharsetBitmap BASE32_BITS{BASE32};
+        constexpr CharsetBitmap BASE64_BITS{BASE64};
+        constexpr CharsetBitmap BASE64URL_BITS{BASE64URL};
     }
 
     CharsetRegistry::CharsetRegistry() = default;
 
-    void CharsetRegistry::include(BuiltinCharset kind)
+    std::u32string_view CharsetRegistry::builtin_characters(BuiltinCharset kind) noexcept
     {
         switch (kind)
         {
         case BuiltinCharset::Lowercase:
-            add_characters(LOWERCASE);
-            break;
+            return LOWERCASE;
         case BuiltinCharset::Uppercase:
-            add_characters(UPPERCASE);
-            break;
+            return UPPERCASE;
         case BuiltinCharset::Digits:
-            add_characters(DIGITS);
-            break;
+            return DIGITS;
         case BuiltinCharset::Special:
-            add_characters(SPECIAL);
-            break;
+            return SPECIAL;
+        case BuiltinCharset::Hex:
+            return HEX;
+        case BuiltinCharset::Base32:
+            return BASE32;
+        case BuiltinCharset::Base64:
+            return BASE64;
+        case BuiltinCharset::Base64Url:
+            return BASE64URL;
         }
+        return {};
+    }
+
+    const CharsetBitmap &CharsetRegistry::builtin_bitmap(BuiltinCharset kind) noexcept
+    {
+        switch (kind)
+        {
+        case BuiltinCharset::Lowercase:
+            return LOWERCASE_BITS;
+        case BuiltinCharset::Uppercase:
+            return UPPERCASE_BITS;
+        case BuiltinCharset::Digits:
+            return DIGITS_BITS;
+        case BuiltinCharset::Special:
+            return SPECIAL_BITS;
+        case BuiltinCharset::Hex:
+            return HEX_BITS;
+        case BuiltinCharset::Base32:
+            return BASE32_BITS;
+        case BuiltinCharset::Base64:
+            return BASE64_BITS;
+        case BuiltinCharset::Base64Url:
+            return BASE64URL_BITS;
+        }
+        return LOWERCASE_BITS;
+    }
+
+    void CharsetRegistry::include(BuiltinCharset kind)
+    {
+        characters_ |= builtin_bitmap(kind);
+        order_.push_back(Entry{EntryKind::Builtin, kind, 0});
     }
 
     void CharsetRegistry::include_all_builtins()
@@ -47,20 +100,27 @@ namespace randkey
 
     void CharsetRegistry::add_characters(std::u32string_view chars)
     {
+        if (chars.empty())
+        {
+            return;
+        }
+
         for (char32_t c : chars)
         {
-            std::u32string token(1, c);
-            append_unique_token(std::move(token));
+            characters_.set(c);
         }
+        order_.push_back(Entry{EntryKind::Characters, BuiltinCharset::Lowercase, runs_.size()});
+        runs_.emplace_back(chars);
     }
 
     void CharsetRegistry::add_token(std::u32string token)
     {
-        append_unique_token(std::move(token));
+        append_token(std::move(token), 1.0, false);
     }
 
     void CharsetRegistry::add_from_file(const std::filesystem::path &path, bool treat_line_as_token)
     {
+        trace::Span span("registry_load");
         std::ifstream file(path, std::ios::binary);
         if (!file)
         {
@@ -87,32 +147,206 @@ namespace randkey
         }
     }
 
+    void CharsetRegistry::add_weighted_token(std::u32string token, double weight)
+    {
+        if (!std::isfinite(weight) || weight <= 0.0)
+        {
+            throw std::runtime_error("error_weight");
+        }
+
+        weighted_ = true;
+        append_token(std::move(token), weight, true);
+    }
+
+    void CharsetRegistry::add_weighted_file(const std::filesystem::path &path)
+    {
+        trace::Span span("registry_load");
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("error_charset_file:" + path.string());
+        }
+
+        std::string line;
+        std::size_t line_number = 0;
+        while (std::getline(file, line))
+        {
+            ++line_number;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            const auto tab = line.rfind('\t');
+            double weight = 1.0;
+            if (tab != std::string::npos)
+            {
+                const std::string text = line.substr(tab + 1);
+                char *end = nullptr;
+                weight = std::strtod(text.c_str(), &end);
+                if (text.empty() || end != text.c_str() + text.size() || !std::isfinite(weight) || weight <= 0.0)
+                {
+                    throw std::runtime_error("error_weight_file:" + path.string() + ":" + std::to_string(line_number));
+                }
+                line.resize(tab);
+            }
+
+            auto converted = locale_to_utf32(line);
+            if (converted.empty())
+            {
+                continue;
+            }
+            add_weighted_token(std::move(converted), weight);
+        }
+    }
+
+    void CharsetRegistry::exclude_characters(std::u32string_view chars)
+    {
+        for (char32_t c : chars)
+        {
+            excluded_.set(c);
+        }
+    }
+
+    bool CharsetRegistry::has_exclusions() const noexcept
+    {
+        return !excluded_.empty();
+    }
+
+    CharsetBitmap CharsetRegistry::characters() const
+    {
+        return characters_ - excluded_;
+    }
+
+    bool CharsetRegistry::contains(char32_t ch) const noexcept
+    {
+        return characters_.test(ch) && !excluded_.test(ch);
+    }
+
+    bool CharsetRegistry::weighted() const noexcept
+    {
+        return weighted_;
+    }
+
     void CharsetRegistry::ensure_default()
     {
-        if (!tokens_.empty())
+        if (!order_.empty())
         {
             return;
         }
 
-        add_characters(LOWERCASE);
-        add_characters(DIGITS);
+        include(BuiltinCharset::Lowercase);
+        include(BuiltinCharset::Digits);
     }
 
     std::vector<std::u32string> CharsetRegistry::materialize() const
     {
-        return tokens_;
+        return replay().tokens;
+    }
+
+    std::vector<double> CharsetRegistry::materialize_weights() const
+    {
+        return replay().weights;
     }
 
-    void CharsetRegistry::append_unique_token(std::u32string token)
+    std::shared_ptr<const CompiledCharset> CharsetRegistry::compile() const
+    {
+        trace::Span span("charset_compile");
+        if (order_.empty())
+        {
+            CharsetRegistry registry;
+            registry.excluded_ = excluded_;
+            registry.ensure_default();
+            return std::make_shared<CompiledCharset>(registry.replay());
+        }
+        return std::make_shared<CompiledCharset>(replay());
+    }
+
+    void CharsetRegistry::append_token(std::u32string token, double weight, bool accumulate)
     {
         if (token.empty())
         {
             return;
         }
 
-        if (seen_.insert(token).second)
+        if (token.size() == 1)
+        {
+            characters_.set(token[0]);
+        }
+        order_.push_back(Entry{EntryKind::Token, BuiltinCharset::Lowercase, tokens_.size()});
+        tokens_.push_back(TokenEntry{std::move(token), weight, accumulate});
+    }
+
+    CompiledCharset CharsetRegistry::replay() const
+    {
+        CompiledCharset compiled;
+        compiled.weighted = weighted_;
+
+        // 单码点用位图去重，只有加权时才需要回查位置以累加权重
+        CharsetBitmap emitted;
+        std::unordered_map<char32_t, std::size_t> single_index;
+        std::unordered_map<std::u32string, std::size_t> token_index;
+
+        auto emit_single = [&](char32_t ch, double weight, bool accumulate) {
+            if (excluded_.test(ch))
+            {
+                return;
+            }
+            if (!emitted.test(ch))
+            {
+                emitted.set(ch);
+                if (weighted_)
+                {
+                    single_index.emplace(ch, compiled.tokens.size());
+                }
+                compiled.tokens.emplace_back(1, ch);
+                compiled.weights.push_back(weight);
+            }
+            else if (accumulate)
+            {
+                compiled.weights[single_index.at(ch)] += weight;
+            }
+        };
+
+        for (const Entry &entry : order_)
         {
-            tokens_.push_back(std::move(token));
+            switch (entry.kind)
+            {
+            case EntryKind::Builtin:
+                for (char32_t ch : builtin_characters(entry.builtin))
+                {
+                    emit_single(ch, 1.0, false);
+                }
+                break;
+            case EntryKind::Characters:
+                for (char32_t ch : runs_[entry.index])
+                {
+                    emit_single(ch, 1.0, false);
+                }
+                break;
+            case EntryKind::Token:
+            {
+                const TokenEntry &token = tokens_[entry.index];
+                if (token.token.size() == 1)
+                {
+                    emit_single(token.token[0], token.weight, token.accumulate);
+                    break;
+                }
+                const auto [it, inserted] = token_index.emplace(token.token, compiled.tokens.size());
+                if (inserted)
+                {
+                    compiled.tokens.push_back(token.token);
+                    compiled.weights.push_back(token.weight);
+                }
+                else if (token.accumulate)
+                {
+                    compiled.weights[it->second] += token.weight;
+                }
+                break;
+            }
+            }
         }
+
+        return compiled;
     }
 }
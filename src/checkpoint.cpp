@@ -0,0 +1,219 @@
+#include "randkey/checkpoint.hpp"
+
+#include "randkey/platform/file_sync.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::string_view CHECKPOINT_MAGIC = "randkey-checkpoint 1";
+
+        constexpr std::uint64_t DIGEST_PRIME = 0x100000001B3ULL;
+
+        std::uint64_t absorb(std::uint64_t state, std::uint64_t word) noexcept
+        {
+            state ^= word;
+            state *= DIGEST_PRIME;
+            return (state << 29U) | (state >> 35U);
+        }
+
+        std::uint64_t finalize(std::uint64_t value) noexcept
+        {
+            value ^= value >> 33U;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33U;
+            value *= 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33U;
+            return value;
+        }
+    }
+
+    void RunningDigest::update(std::string_view data) noexcept
+    {
+        total_ += data.size();
+        std::size_t offset = 0;
+
+        // 先补齐上次剩余的半个字
+        while (pending_bytes_ != 0 && offset < data.size())
+        {
+            pending_ |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[offset++])) << (8U * pending_bytes_);
+            if (++pending_bytes_ == 8)
+            {
+                state_ = absorb(state_, pending_);
+                pending_ = 0;
+                pending_bytes_ = 0;
+            }
+        }
+
+        for (; offset + 8 <= data.size(); offset += 8)
+        {
+            std::uint64_t word = 0;
+            for (unsigned i = 0; i < 8; ++i)
+            {
+                word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[offset + i])) << (8U * i);
+            }
+            state_ = absorb(state_, word);
+        }
+
+        for (; offset < data.size(); ++offset)
+        {
+            pending_ |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[offset])) << (8U * pending_bytes_);
+            ++pending_bytes_;
+        }
+    }
+
+    std::uint64_t RunningDigest::value() const noexcept
+    {
+        std::uint64_t state = state_;
+        if (pending_bytes_ != 0)
+        {
+            state = absorb(state, pending_);
+        }
+        return finalize(state ^ total_);
+    }
+
+    std::uint64_t RunningDigest::bytes() const noexcept
+    {
+        return total_;
+    }
+
+    std::filesystem::path Checkpoint::path_for(const std::filesystem::path &output)
+    {
+        return std::filesystem::path(output).concat(".ckpt");
+    }
+
+    std::filesystem::path Checkpoint::temp_path_for(const std::filesystem::path &path)
+    {
+        return std::filesystem::path(path).concat(".tmp");
+    }
+
+    void Checkpoint::save(const std::filesystem::path &path) const
+    {
+        const auto temp = temp_path_for(path);
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out << CHECKPOINT_MAGIC << '\n'
+                << "next_index " << next_index << '\n'
+                << "bytes " << bytes << '\n'
+                << "digest " << digest << '\n'
+                << "config " << config << '\n';
+            if (deterministic_seed.has_value())
+            {
+                out << "seed " << deterministic_seed.value() << '\n';
+            }
+            out.flush();
+            if (!out)
+            {
+                throw std::runtime_error("error_checkpoint_write:" + path.string());
+            }
+        }
+
+        // 临时文件先落盘再改名，改名后再落盘目录：掉电后看到的断点要么是旧的，要么是完整的新断点
+        std::error_code ec;
+        if (!platform::sync_file(temp))
+        {
+            throw std::runtime_error("error_checkpoint_write:" + path.string());
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec || !platform::sync_parent_directory(path))
+        {
+            throw std::runtime_error("error_checkpoint_write:" + path.string());
+        }
+    }
+
+    Checkpoint Checkpoint::load(const std::filesystem::path &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string line;
+        if (!in || !std::getline(in, line) || line != CHECKPOINT_MAGIC)
+        {
+            throw std::runtime_error("error_checkpoint:" + path.string());
+        }
+
+        Checkpoint checkpoint;
+        unsigned seen = 0;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            std::string name;
+            std::uint64_t value = 0;
+            if (!(fields >> name >> value))
+            {
+                throw std::runtime_error("error_checkpoint:" + path.string());
+            }
+
+            if (name == "next_index")
+            {
+                checkpoint.next_index = value;
+                seen |= 1U;
+            }
+            else if (name == "bytes")
+            {
+                checkpoint.bytes = value;
+                seen |= 2U;
+            }
+            else if (name == "digest")
+            {
+                checkpoint.digest = value;
+                seen |= 4U;
+            }
+            else if (name == "config")
+            {
+                checkpoint.config = value;
+                seen |= 8U;
+            }
+            else if (name == "seed")
+            {
+                checkpoint.deterministic_seed = value;
+            }
+        }
+
+        if (seen != 15U)
+        {
+            throw std::runtime_error("error_checkpoint:" + path.string());
+        }
+        return checkpoint;
+    }
+
+    void truncate_to_checkpoint(const std::filesystem::path &output, const Checkpoint &checkpoint, RunningDigest &digest)
+    {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(output, ec);
+        if (ec || size < checkpoint.bytes)
+        {
+            throw std::runtime_error("error_checkpoint_mismatch:" + output.string());
+        }
+
+        {
+            std::ifstream in(output, std::ios::binary);
+            std::vector<char> buffer(1U << 20U);
+            std::uint64_t remaining = checkpoint.bytes;
+            while (remaining > 0 && in)
+            {
+                const std::size_t take = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, buffer.size()));
+                in.read(buffer.data(), static_cast<std::streamsize>(take));
+                const std::size_t got = static_cast<std::size_t>(in.gcount());
+                digest.update(std::string_view(buffer.data(), got));
+                remaining -= got;
+            }
+            if (remaining != 0 || digest.value() != checkpoint.digest)
+            {
+                throw std::runtime_error("error_checkpoint_mismatch:" + output.string());
+            }
+        }
+
+        std::filesystem::resize_file(output, checkpoint.bytes, ec);
+        if (ec)
+        {
+            throw std::runtime_error("error_write_file:" + output.string());
+        }
+    }
+}
@@ -0,0 +1,402 @@
+#include "randkey/constraints.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 计数表占用 O(L²·2^k) 内存（L 为长度、k 为类别数），超过此长度改为整键拒绝采样
+        constexpr std::size_t TABLE_MAX_LENGTH = 1024;
+
+        /// @brief 整键拒绝采样可接受的最大漏类概率（并集上界），保证期望重抽不超过 1 次
+        constexpr double MAX_MISS_PROBABILITY = 0.5;
+
+        /// @brief 最小化的无符号大整数（小端 32 位分块），仅支持计数所需的运算
+        struct BigUInt
+        {
+            std::vector<std::uint32_t> limbs;
+
+            void normalize()
+            {
+                while (!limbs.empty() && limbs.back() == 0)
+                {
+                    limbs.pop_back();
+                }
+            }
+
+            bool is_zero() const noexcept
+            {
+                return limbs.empty();
+            }
+
+            std::size_t bit_length() const noexcept
+            {
+                if (limbs.empty())
+                {
+                    return 0;
+                }
+                std::uint32_t top = limbs.back();
+                std::size_t bits = 0;
+                while (top != 0)
+                {
+                    ++bits;
+                    top >>= 1U;
+                }
+                return (limbs.size() - 1) * 32 + bits;
+            }
+        };
+
+        int compare(const BigUInt &a, const BigUInt &b)
+        {
+            if (a.limbs.size() != b.limbs.size())
+            {
+                return a.limbs.size() < b.limbs.size() ? -1 : 1;
+            }
+            for (std::size_t i = a.limbs.size(); i-- > 0;)
+            {
+                if (a.limbs[i] != b.limbs[i])
+                {
+                    return a.limbs[i] < b.limbs[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        void add_in_place(BigUInt &a, const BigUInt &b)
+        {
+            if (a.limbs.size() < b.limbs.size())
+            {
+                a.limbs.resize(b.limbs.size(), 0);
+            }
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < a.limbs.size(); ++i)
+            {
+                const std::uint64_t sum = static_cast<std::uint64_t>(a.limbs[i]) +
+                                          (i < b.limbs.size() ? b.limbs[i] : 0U) + carry;
+                a.limbs[i] = static_cast<std::uint32_t>(sum);
+                carry = sum >> 32U;
+            }
+            if (carry != 0)
+            {
+                a.limbs.push_back(static_cast<std::uint32_t>(carry));
+            }
+        }
+
+        /// @brief a -= b，要求 a >= b
+        void subtract_in_place(BigUInt &a, const BigUInt &b)
+        {
+            std::int64_t borrow = 0;
+            for (std::size_t i = 0; i < a.limbs.size(); ++i)
+            {
+                std::int64_t diff = static_cast<std::int64_t>(a.limbs[i]) -
+                                    static_cast<std::int64_t>(i < b.limbs.size() ? b.limbs[i] : 0U) - borrow;
+                borrow = diff < 0 ? 1 : 0;
+                if (diff < 0)
+                {
+                    diff += static_cast<std::int64_t>(1) << 32U;
+                }
+                a.limbs[i] = static_cast<std::uint32_t>(diff);
+            }
+            a.normalize();
+        }
+
+        BigUInt multiply_small(const BigUInt &a, std::uint32_t factor)
+        {
+            BigUInt result;
+            if (factor == 0 || a.is_zero())
+            {
+                return result;
+            }
+            result.limbs.resize(a.limbs.size() + 1, 0);
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < a.limbs.size(); ++i)
+            {
+                const std::uint64_t product = static_cast<std::uint64_t>(a.limbs[i]) * factor + carry;
+                result.limbs[i] = static_cast<std::uint32_t>(product);
+                carry = product >> 32U;
+            }
+            result.limbs[a.limbs.size()] = static_cast<std::uint32_t>(carry);
+            result.normalize();
+            return result;
+        }
+
+        /// @brief 拒绝采样得到 [0, upper) 内的均匀大整数
+        BigUInt random_below(const BigUInt &upper, const ConstrainedSampler::WordSource &source)
+        {
+            const std::size_t bits = upper.bit_length();
+            const std::size_t limb_count = (bits + 31) / 32;
+            const std::uint32_t top_mask = (bits % 32 == 0) ? 0xFFFFFFFFU : ((1U << (bits % 32)) - 1U);
+
+            BigUInt value;
+            while (true)
+            {
+                value.limbs.assign(limb_count, 0);
+                for (std::size_t i = 0; i < limb_count; i += 2)
+                {
+                    const std::uint64_t word = source();
+                    value.limbs[i] = static_cast<std::uint32_t>(word);
+                    if (i + 1 < limb_count)
+                    {
+                        value.limbs[i + 1] = static_cast<std::uint32_t>(word >> 32U);
+                    }
+                }
+                value.limbs.back() &= top_mask;
+                value.normalize();
+                if (compare(value, upper) < 0)
+                {
+                    return value;
+                }
+            }
+        }
+
+        std::size_t uniform_below(std::size_t upper, const ConstrainedSampler::WordSource &source)
+        {
+            const std::uint64_t range = std::numeric_limits<std::uint64_t>::max();
+            const std::uint64_t bound = static_cast<std::uint64_t>(upper);
+            const std::uint64_t threshold = range - (range % bound);
+            while (true)
+            {
+                const std::uint64_t value = source();
+                if (value < threshold)
+                {
+                    return static_cast<std::size_t>(value % bound);
+                }
+            }
+        }
+    }
+
+    struct ConstrainedSampler::Tables
+    {
+        std::size_t masks{0};
+        /// @brief counts[r * masks + M] = f(r, M)
+        std::vector<BigUInt> counts;
+        std::vector<std::uint32_t> class_sizes;
+        std::vector<std::uint32_t> free_sizes;
+
+        const BigUInt &f(std::size_t remaining, std::size_t mask) const
+        {
+            return counts[remaining * masks + mask];
+        }
+    };
+
+    std::vector<BuiltinCharset> parse_required_classes(std::u32string_view list)
+    {
+        std::vector<BuiltinCharset> result;
+        std::size_t start = 0;
+        while (start <= list.size())
+        {
+            const std::size_t comma = std::min(list.find(U',', start), list.size());
+            const std::u32string_view name = list.substr(start, comma - start);
+
+            BuiltinCharset kind{};
+            if (name == U"lower")
+            {
+                kind = BuiltinCharset::Lowercase;
+            }
+            else if (name == U"upper")
+            {
+                kind = BuiltinCharset::Uppercase;
+            }
+            else if (name == U"digit" || name == U"digits")
+            {
+                kind = BuiltinCharset::Digits;
+            }
+            else if (name == U"special")
+            {
+                kind = BuiltinCharset::Special;
+            }
+            else
+            {
+                throw std::runtime_error("error_require_class");
+            }
+
+            if (std::find(result.begin(), result.end(), kind) == result.end())
+            {
+                result.push_back(kind);
+            }
+            start = comma + 1;
+        }
+        return result;
+    }
+
+    ConstrainedSampler::ConstrainedSampler(const std::vector<std::u32string> &tokens,
+                                           const std::vector<BuiltinCharset> &required,
+                                           std::size_t length)
+        : length_(length), token_count_(tokens.size()), tables_(std::make_unique<Tables>())
+    {
+        const std::size_t classes = required.size();
+        if (classes > length_)
+        {
+            throw std::runtime_error("error_require_length");
+        }
+
+        // 单字符 token 归入第一个包含它的类别（按内置位图判定），其余 token 不属于任何类别
+        class_tokens_.assign(classes, {});
+        token_class_.assign(token_count_, classes);
+        for (std::size_t i = 0; i < token_count_; ++i)
+        {
+            if (tokens[i].size() != 1)
+            {
+                continue;
+            }
+            for (std::size_t c = 0; c < classes; ++c)
+            {
+                if (CharsetRegistry::builtin_bitmap(required[c]).test(tokens[i][0]))
+                {
+                    token_class_[i] = c;
+                    class_tokens_[c].push_back(i);
+                    break;
+                }
+            }
+        }
+
+        for (const auto &members : class_tokens_)
+        {
+            if (members.empty())
+            {
+                throw std::runtime_error("error_require_missing");
+            }
+        }
+
+        if (length_ > TABLE_MAX_LENGTH)
+        {
+            // 长密钥几乎总能覆盖全部类别：整键均匀抽取并拒绝缺类者，内存与长度无关
+            double miss = 0.0;
+            for (const auto &members : class_tokens_)
+            {
+                const double share = static_cast<double>(members.size()) / static_cast<double>(token_count_);
+                miss += std::pow(1.0 - share, static_cast<double>(length_));
+            }
+            if (miss > MAX_MISS_PROBABILITY)
+            {
+                throw std::runtime_error("error_require_too_long");
+            }
+            tables_.reset();
+            return;
+        }
+
+        auto &tables = *tables_;
+        tables.masks = std::size_t{1} << classes;
+        tables.class_sizes.resize(classes);
+        for (std::size_t c = 0; c < classes; ++c)
+        {
+            tables.class_sizes[c] = static_cast<std::uint32_t>(class_tokens_[c].size());
+        }
+
+        // 对每个缺失集合 M，“自由”token 为不属于 M 中任何类别的 token
+        tables.free_sizes.resize(tables.masks);
+        other_tokens_.assign(tables.masks, {});
+        for (std::size_t mask = 0; mask < tables.masks; ++mask)
+        {
+            for (std::size_t i = 0; i < token_count_; ++i)
+            {
+                const std::size_t c = token_class_[i];
+                if (c == classes || (mask & (std::size_t{1} << c)) == 0)
+                {
+                    other_tokens_[mask].push_back(i);
+                }
+            }
+            tables.free_sizes[mask] = static_cast<std::uint32_t>(other_tokens_[mask].size());
+        }
+
+        // f(0, M) = [M = ∅]；f(r, M) = free(M)·f(r-1, M) + Σ_{c∈M} size(c)·f(r-1, M\{c})
+        tables.counts.resize((length_ + 1) * tables.masks);
+        tables.counts[0].limbs = {1};
+        for (std::size_t r = 1; r <= length_; ++r)
+        {
+            for (std::size_t mask = 0; mask < tables.masks; ++mask)
+            {
+                BigUInt value = multiply_small(tables.f(r - 1, mask), tables.free_sizes[mask]);
+                for (std::size_t c = 0; c < classes; ++c)
+                {
+                    const std::size_t bit = std::size_t{1} << c;
+                    if ((mask & bit) != 0)
+                    {
+                        add_in_place(value, multiply_small(tables.f(r - 1, mask & ~bit), tables.class_sizes[c]));
+                    }
+                }
+                tables.counts[r * tables.masks + mask] = std::move(value);
+            }
+        }
+    }
+
+    ConstrainedSampler::~ConstrainedSampler() = default;
+    ConstrainedSampler::ConstrainedSampler(ConstrainedSampler &&) noexcept = default;
+    ConstrainedSampler &ConstrainedSampler::operator=(ConstrainedSampler &&) noexcept = default;
+
+    void ConstrainedSampler::sample(const WordSource &source, std::vector<std::size_t> &out) const
+    {
+        const std::size_t classes = class_tokens_.size();
+        out.resize(length_);
+
+        if (!tables_)
+        {
+            // 整键拒绝采样：在满足约束的密钥集合上同样精确均匀
+            const std::size_t all_classes = (std::size_t{1} << classes) - 1;
+            for (;;)
+            {
+                std::size_t covered = 0;
+                for (std::size_t position = 0; position < length_; ++position)
+                {
+                    out[position] = uniform_below(token_count_, source);
+                    const std::size_t c = token_class_[out[position]];
+                    if (c < classes)
+                    {
+                        covered |= std::size_t{1} << c;
+                    }
+                }
+                if (covered == all_classes)
+                {
+                    return;
+                }
+            }
+        }
+
+        const auto &tables = *tables_;
+
+        std::size_t mask = tables.masks - 1;
+        for (std::size_t position = 0; position < length_; ++position)
+        {
+            if (mask == 0)
+            {
+                out[position] = uniform_below(token_count_, source);
+                continue;
+            }
+
+            const std::size_t remaining = length_ - position;
+            BigUInt pick = random_below(tables.f(remaining, mask), source);
+
+            const BigUInt free_weight = multiply_small(tables.f(remaining - 1, mask), tables.free_sizes[mask]);
+            if (compare(pick, free_weight) < 0)
+            {
+                const auto &pool = other_tokens_[mask];
+                out[position] = pool[uniform_below(pool.size(), source)];
+                continue;
+            }
+            subtract_in_place(pick, free_weight);
+
+            for (std::size_t c = 0; c < classes; ++c)
+            {
+                const std::size_t bit = std::size_t{1} << c;
+                if ((mask & bit) == 0)
+                {
+                    continue;
+                }
+
+                const BigUInt weight = multiply_small(tables.f(remaining - 1, mask & ~bit), tables.class_sizes[c]);
+                if (compare(pick, weight) < 0)
+                {
+                    const auto &pool = class_tokens_[c];
+                    out[position] = pool[uniform_below(pool.size(), source)];
+                    mask &= ~bit;
+                    break;
+                }
+                subtract_in_place(pick, weight);
+            }
+        }
+    }
+}
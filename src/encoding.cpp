@@ -1,26 +1,42 @@
 #include "randkey/encoding.hpp"
 
 #include "randkey/platform/encoding.hpp"
+#include "randkey/run_stats.hpp"
 
 namespace randkey
 {
+    namespace
+    {
+        template <typename Result>
+        Result counted(Result result)
+        {
+            stats::add(stats::Counter::Transcodes);
+            stats::add(stats::Counter::TranscodedBytes, result.size() * sizeof(typename Result::value_type));
+            return result;
+        }
+    }
+
     std::u32string utf8_to_utf32(std::string_view input)
     {
-        return platform::utf8_to_utf32(input);
+        stats::ScopedTimer timer(stats::Stage::Transcode);
+        return counted(platform::utf8_to_utf32(input));
     }
 
     std::string utf32_to_utf8(std::u32string_view input)
     {
-        return platform::utf32_to_utf8(input);
+        stats::ScopedTimer timer(stats::Stage::Transcode);
+        return counted(platform::utf32_to_utf8(input));
     }
 
     std::u32string locale_to_utf32(std::string_view input)
     {
-        return platform::locale_to_utf32(input);
+        stats::ScopedTimer timer(stats::Stage::Transcode);
+        return counted(platform::locale_to_utf32(input));
     }
 
     std::string utf32_to_locale(std::u32string_view input)
     {
-        return platform::utf32_to_locale(input);
+        stats::ScopedTimer timer(stats::Stage::Transcode);
+        return counted(platform::utf32_to_locale(input));
     }
 }
@@ -0,0 +1,283 @@
+#include "randkey/exclusion_index.hpp"
+
+#include "randkey/encoding.hpp"
+#include "randkey/fingerprint_set.hpp"
+#include "randkey/trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::array<char, 8> INDEX_MAGIC{'R', 'K', 'X', 'I', 'D', 'X', '0', '1'};
+
+        /// @brief 每个 Bloom 块 8 个 64 位字（一条缓存行），每个字各置 1 位
+        constexpr std::size_t BLOCK_WORDS = 8;
+        constexpr std::size_t BITS_PER_KEY = 12;
+
+        /// @brief 各字的位置盐值（奇数乘数，取乘积高 6 位作为位下标）
+        constexpr std::array<std::uint32_t, BLOCK_WORDS> BLOCK_SALTS{
+            0x47B6137BU, 0x44974D91U, 0x8824AD5BU, 0xA2B7289DU,
+            0x705495C7U, 0x2DF1424BU, 0x9EFC4947U, 0x5C6BFB31U};
+
+        struct IndexHeader
+        {
+            std::array<char, 8> magic;
+            std::uint64_t source_size;
+            std::int64_t source_mtime;
+            std::uint64_t key_count;
+            std::uint64_t filter_blocks;
+            std::uint64_t reserved[3];
+        };
+        static_assert(sizeof(IndexHeader) == 64);
+
+        std::uint64_t mix64(std::uint64_t value) noexcept
+        {
+            value ^= value >> 33U;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33U;
+            value *= 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33U;
+            return value;
+        }
+
+        std::size_t block_count(std::size_t keys) noexcept
+        {
+            return std::max<std::size_t>(1, (keys * BITS_PER_KEY + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64));
+        }
+
+        std::size_t block_of(std::uint64_t hash, std::size_t blocks) noexcept
+        {
+            return static_cast<std::size_t>(((hash >> 32U) * static_cast<std::uint64_t>(blocks)) >> 32U);
+        }
+
+        std::uint64_t bit_of(std::uint64_t hash, std::size_t word) noexcept
+        {
+            const std::uint32_t low = static_cast<std::uint32_t>(hash) * BLOCK_SALTS[word];
+            return 1ULL << (low >> 26U);
+        }
+
+        std::int64_t modification_stamp(const std::filesystem::path &path)
+        {
+            std::error_code ec;
+            const auto stamp = std::filesystem::last_write_time(path, ec);
+            return ec ? 0 : static_cast<std::int64_t>(stamp.time_since_epoch().count());
+        }
+
+        template <typename Char>
+        bool is_ascii(std::basic_string_view<Char> key) noexcept
+        {
+            return std::all_of(key.begin(), key.end(), [](Char ch) {
+                return static_cast<std::uint32_t>(ch) < 0x80U;
+            });
+        }
+
+        void collect_lines(std::string_view data, std::vector<std::uint64_t> &fingerprints)
+        {
+            const char *line = data.data();
+            const char *end = line + data.size();
+            while (line < end)
+            {
+                const void *found = std::memchr(line, '\n', static_cast<std::size_t>(end - line));
+                const char *next = found ? static_cast<const char *>(found) : end;
+
+                std::size_t length = static_cast<std::size_t>(next - line);
+                if (length > 0 && line[length - 1] == '\r')
+                {
+                    --length;
+                }
+                if (length > 0)
+                {
+                    fingerprints.push_back(KeyFingerprint::of(std::string_view(line, length)).primary);
+                }
+
+                line = next + 1;
+            }
+        }
+    }
+
+    ExclusionIndex ExclusionIndex::open(const std::filesystem::path &keys)
+    {
+        trace::Span span("index_load");
+        std::error_code ec;
+        const auto source_size = std::filesystem::file_size(keys, ec);
+        if (ec)
+        {
+            throw std::runtime_error("error_exclude_file:" + keys.string());
+        }
+        const std::int64_t source_mtime = modification_stamp(keys);
+        const auto path = index_path(keys);
+
+        // 优先映射已有索引：校验魔数、源文件元数据与整体长度
+        if (std::filesystem::exists(path, ec))
+        {
+            try
+            {
+                auto file = platform::MappedFile::open(path);
+                const auto bytes = file.bytes();
+                IndexHeader header{};
+                if (bytes.size() >= sizeof(header))
+                {
+                    std::memcpy(&header, bytes.data(), sizeof(header));
+                    const std::uint64_t words = header.filter_blocks * BLOCK_WORDS + header.key_count;
+                    if (header.magic == INDEX_MAGIC && header.source_size == source_size &&
+                        header.source_mtime == source_mtime && header.filter_blocks > 0 &&
+                        bytes.size() == sizeof(header) + words * sizeof(std::uint64_t))
+                    {
+                        ExclusionIndex index;
+                        const auto *base = reinterpret_cast<const std::uint64_t *>(bytes.data() + sizeof(header));
+                        index.filter_ = std::span<const std::uint64_t>(base, header.filter_blocks * BLOCK_WORDS);
+                        index.sorted_ = std::span<const std::uint64_t>(base + index.filter_.size(), header.key_count);
+                        index.mapped_.emplace(std::move(file));
+                        return index;
+                    }
+                }
+            }
+            catch (const std::runtime_error &)
+            {
+                // 索引损坏或不可读时退回重建
+            }
+        }
+
+        std::vector<std::uint64_t> fingerprints;
+        {
+            const auto source = platform::MappedFile::open(keys);
+            const auto bytes = source.bytes();
+            fingerprints.reserve(bytes.size() / 8 + 1);
+            collect_lines(std::string_view(reinterpret_cast<const char *>(bytes.data()), bytes.size()), fingerprints);
+        }
+
+        ExclusionIndex index;
+        index.adopt(std::move(fingerprints));
+
+        // 写回失败（如只读目录）不影响本次使用，下次运行时再重建
+        const auto temp = std::filesystem::path(path).concat(".tmp");
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (out)
+            {
+                IndexHeader header{};
+                header.magic = INDEX_MAGIC;
+                header.source_size = source_size;
+                header.source_mtime = source_mtime;
+                header.key_count = index.sorted_.size();
+                header.filter_blocks = index.filter_.size() / BLOCK_WORDS;
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char *>(index.storage_.data()),
+                          static_cast<std::streamsize>(index.storage_.size() * sizeof(std::uint64_t)));
+            }
+            if (!out)
+            {
+                out.close();
+                std::filesystem::remove(temp, ec);
+                return index;
+            }
+        }
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(temp, ec);
+        }
+
+        return index;
+    }
+
+    ExclusionIndex ExclusionIndex::from_keys(const std::vector<std::string> &keys)
+    {
+        std::vector<std::uint64_t> fingerprints;
+        fingerprints.reserve(keys.size());
+        for (const auto &key : keys)
+        {
+            fingerprints.push_back(KeyFingerprint::of(std::string_view(key)).primary);
+        }
+
+        ExclusionIndex index;
+        index.adopt(std::move(fingerprints));
+        return index;
+    }
+
+    std::filesystem::path ExclusionIndex::index_path(const std::filesystem::path &keys)
+    {
+        return std::filesystem::path(keys).concat(".rkx");
+    }
+
+    bool ExclusionIndex::contains(std::u32string_view key) const
+    {
+        // ASCII 密钥按码点与按字节得到的指纹相同，免去转码
+        if (is_ascii(key))
+        {
+            return contains_fingerprint(KeyFingerprint::of(key).primary);
+        }
+        return contains(std::string_view(utf32_to_locale(key)));
+    }
+
+    bool ExclusionIndex::contains(std::string_view key) const noexcept
+    {
+        return contains_fingerprint(KeyFingerprint::of(key).primary);
+    }
+
+    std::size_t ExclusionIndex::size() const noexcept
+    {
+        return sorted_.size();
+    }
+
+    bool ExclusionIndex::mapped() const noexcept
+    {
+        return mapped_.has_value();
+    }
+
+    bool ExclusionIndex::contains_fingerprint(std::uint64_t fingerprint) const noexcept
+    {
+        if (sorted_.empty())
+        {
+            return false;
+        }
+
+        const std::uint64_t hash = mix64(fingerprint);
+        const std::uint64_t *block = filter_.data() + block_of(hash, filter_.size() / BLOCK_WORDS) * BLOCK_WORDS;
+        for (std::size_t word = 0; word < BLOCK_WORDS; ++word)
+        {
+            if ((block[word] & bit_of(hash, word)) == 0)
+            {
+                return false;
+            }
+        }
+
+        return std::binary_search(sorted_.begin(), sorted_.end(), fingerprint);
+    }
+
+    void ExclusionIndex::adopt(std::vector<std::uint64_t> fingerprints)
+    {
+        std::sort(fingerprints.begin(), fingerprints.end());
+        fingerprints.erase(std::unique(fingerprints.begin(), fingerprints.end()), fingerprints.end());
+
+        // 过滤器与有序数组共用一块存储（布局与索引文件正文一致），原地后移指纹以免构建时双份占用
+        const std::size_t count = fingerprints.size();
+        const std::size_t blocks = block_count(count);
+        const std::size_t filter_words = blocks * BLOCK_WORDS;
+        fingerprints.resize(filter_words + count);
+        std::move_backward(fingerprints.begin(), fingerprints.begin() + static_cast<std::ptrdiff_t>(count), fingerprints.end());
+        std::fill(fingerprints.begin(), fingerprints.begin() + static_cast<std::ptrdiff_t>(filter_words), 0);
+        storage_ = std::move(fingerprints);
+
+        for (std::size_t i = filter_words; i < storage_.size(); ++i)
+        {
+            const std::uint64_t hash = mix64(storage_[i]);
+            std::uint64_t *block = storage_.data() + block_of(hash, blocks) * BLOCK_WORDS;
+            for (std::size_t word = 0; word < BLOCK_WORDS; ++word)
+            {
+                block[word] |= bit_of(hash, word);
+            }
+        }
+
+        mapped_.reset();
+        filter_ = std::span<const std::uint64_t>(storage_.data(), filter_words);
+        sorted_ = std::span<const std::uint64_t>(storage_.data() + filter_words, count);
+    }
+}
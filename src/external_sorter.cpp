@@ -0,0 +1,358 @@
+#include "randkey/external_sorter.hpp"
+
+#include "randkey/platform/private_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 记录打包：高 40 位为块内偏移，低 24 位为长度
+        constexpr unsigned LENGTH_BITS = 24;
+        constexpr std::uint64_t LENGTH_MASK = (1ULL << LENGTH_BITS) - 1;
+
+        /// @brief 每条记录在块内的固定开销：打包记录 + 排序条目与其基数排序暂存
+        constexpr std::size_t RECORD_OVERHEAD = sizeof(std::uint64_t) + 4 * sizeof(std::uint64_t);
+
+        /// @brief 单次归并同时打开的段数上限，超过时先做中间归并
+        constexpr std::size_t MAX_FAN_IN = 128;
+
+        constexpr std::size_t MIN_READ_BUFFER = 1U << 16U;
+
+        std::uint64_t prefix_of(std::string_view key) noexcept
+        {
+            std::uint64_t prefix = 0;
+            const std::size_t take = std::min<std::size_t>(8, key.size());
+            for (std::size_t i = 0; i < take; ++i)
+            {
+                prefix |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[i])) << (56U - 8U * i);
+            }
+            return prefix;
+        }
+
+        /// @brief 顺序读取一个溢出段：每条记录为 32 位长度 + 字节
+        class RunReader
+        {
+        public:
+            RunReader(const std::filesystem::path &path, std::size_t buffer_bytes)
+                : buffer_(std::make_unique<char[]>(buffer_bytes))
+            {
+                stream_.rdbuf()->pubsetbuf(buffer_.get(), static_cast<std::streamsize>(buffer_bytes));
+                stream_.open(path, std::ios::binary);
+                if (!stream_)
+                {
+                    throw std::runtime_error("error_sort_spill");
+                }
+            }
+
+            bool next()
+            {
+                std::uint32_t length = 0;
+                if (!stream_.read(reinterpret_cast<char *>(&length), sizeof(length)))
+                {
+                    return false;
+                }
+                current_.resize(length);
+                if (!stream_.read(current_.data(), static_cast<std::streamsize>(length)))
+                {
+                    throw std::runtime_error("error_sort_spill");
+                }
+                return true;
+            }
+
+            const std::string &current() const noexcept
+            {
+                return current_;
+            }
+
+        private:
+            std::unique_ptr<char[]> buffer_;
+            std::ifstream stream_;
+            std::string current_;
+        };
+
+        class RunWriter
+        {
+        public:
+            RunWriter(const std::filesystem::path &path, std::size_t buffer_bytes)
+                : buffer_(std::make_unique<char[]>(buffer_bytes))
+            {
+                stream_.rdbuf()->pubsetbuf(buffer_.get(), static_cast<std::streamsize>(buffer_bytes));
+                stream_.open(path, std::ios::binary | std::ios::trunc);
+                if (!stream_)
+                {
+                    throw std::runtime_error("error_sort_spill");
+                }
+            }
+
+            void write(std::string_view key)
+            {
+                const std::uint32_t length = static_cast<std::uint32_t>(key.size());
+                stream_.write(reinterpret_cast<const char *>(&length), sizeof(length));
+                stream_.write(key.data(), static_cast<std::streamsize>(key.size()));
+            }
+
+            void close()
+            {
+                stream_.close();
+                if (!stream_)
+                {
+                    throw std::runtime_error("error_sort_spill");
+                }
+            }
+
+        private:
+            std::unique_ptr<char[]> buffer_;
+            std::ofstream stream_;
+        };
+    }
+
+    ExternalSorter::ExternalSorter(std::size_t memory_limit, std::filesystem::path temp_directory)
+        : memory_limit_(std::max(memory_limit, MIN_MEMORY_LIMIT)),
+          temp_directory_(std::move(temp_directory))
+    {
+    }
+
+    ExternalSorter::~ExternalSorter()
+    {
+        for (const auto &run : runs_)
+        {
+            platform::wipe_and_remove(run);
+        }
+        if (!run_directory_.empty())
+        {
+            std::error_code ec;
+            std::filesystem::remove(run_directory_, ec);
+        }
+    }
+
+    void ExternalSorter::push(std::string_view key)
+    {
+        if (key.size() > LENGTH_MASK)
+        {
+            throw std::runtime_error("error_sort_spill");
+        }
+
+        // 预算对半分给键字节与记录，首次写入时一次性预留，避免扩容造成峰值翻倍
+        const std::size_t arena_budget = memory_limit_ / 2;
+        const std::size_t record_budget = memory_limit_ / 2 / RECORD_OVERHEAD;
+        if (arena_.capacity() < arena_budget)
+        {
+            arena_.reserve(arena_budget);
+            records_.reserve(record_budget);
+        }
+
+        if (!records_.empty() && (arena_.size() + key.size() > arena_budget || records_.size() >= record_budget))
+        {
+            spill();
+        }
+
+        records_.push_back((static_cast<std::uint64_t>(arena_.size()) << LENGTH_BITS) | static_cast<std::uint64_t>(key.size()));
+        arena_.append(key);
+    }
+
+    void ExternalSorter::finish(const std::function<void(std::string_view)> &emit)
+    {
+        if (runs_.empty())
+        {
+            drain_chunk(emit);
+            return;
+        }
+
+        if (!records_.empty())
+        {
+            spill();
+        }
+        std::string().swap(arena_);
+        std::vector<std::uint64_t>().swap(records_);
+
+        // 段数过多时分批做中间归并，限制同时打开的文件数
+        while (runs_.size() > MAX_FAN_IN)
+        {
+            const std::vector<std::filesystem::path> batch(runs_.begin(), runs_.begin() + MAX_FAN_IN);
+            const auto merged = next_run_path();
+            {
+                RunWriter writer(merged, memory_limit_ / 2);
+                merge(batch, memory_limit_ / 2 / MAX_FAN_IN, [&](std::string_view key) { writer.write(key); });
+                writer.close();
+            }
+
+            for (const auto &run : batch)
+            {
+                platform::wipe_and_remove(run);
+            }
+            runs_.erase(runs_.begin(), runs_.begin() + MAX_FAN_IN);
+            runs_.push_back(merged);
+        }
+
+        merge(runs_, memory_limit_ / runs_.size(), emit);
+
+        for (const auto &run : runs_)
+        {
+            platform::wipe_and_remove(run);
+        }
+        runs_.clear();
+    }
+
+    std::size_t ExternalSorter::spilled_runs() const noexcept
+    {
+        return total_runs_;
+    }
+
+    std::string_view ExternalSorter::record(std::uint64_t entry) const noexcept
+    {
+        return std::string_view(arena_.data() + (entry >> LENGTH_BITS), static_cast<std::size_t>(entry & LENGTH_MASK));
+    }
+
+    void ExternalSorter::sort_chunk(std::vector<SortEntry> &entries) const
+    {
+        entries.resize(records_.size());
+        for (std::size_t i = 0; i < records_.size(); ++i)
+        {
+            entries[i] = SortEntry{prefix_of(record(records_[i])), records_[i]};
+        }
+
+        // LSD 基数排序前缀：从最低字节到最高字节，所有条目落在同一桶的趟次直接跳过
+        std::vector<SortEntry> scratch(entries.size());
+        for (unsigned shift = 0; shift < 64; shift += 8)
+        {
+            std::array<std::size_t, 256> counts{};
+            for (const auto &entry : entries)
+            {
+                ++counts[(entry.prefix >> shift) & 0xFFU];
+            }
+            if (std::find(counts.begin(), counts.end(), entries.size()) != counts.end())
+            {
+                continue;
+            }
+
+            std::size_t offset = 0;
+            for (auto &count : counts)
+            {
+                const std::size_t bucket = count;
+                count = offset;
+                offset += bucket;
+            }
+            for (const auto &entry : entries)
+            {
+                scratch[counts[(entry.prefix >> shift) & 0xFFU]++] = entry;
+            }
+            entries.swap(scratch);
+        }
+
+        // 前缀相同的区间按整键补排（随机密钥中极少出现）
+        for (std::size_t begin = 0; begin < entries.size();)
+        {
+            std::size_t end = begin + 1;
+            while (end < entries.size() && entries[end].prefix == entries[begin].prefix)
+            {
+                ++end;
+            }
+            if (end - begin > 1)
+            {
+                std::sort(entries.begin() + static_cast<std::ptrdiff_t>(begin),
+                          entries.begin() + static_cast<std::ptrdiff_t>(end),
+                          [this](const SortEntry &left, const SortEntry &right) {
+                              return record(left.record) < record(right.record);
+                          });
+            }
+            begin = end;
+        }
+    }
+
+    void ExternalSorter::drain_chunk(const std::function<void(std::string_view)> &emit)
+    {
+        std::vector<SortEntry> entries;
+        sort_chunk(entries);
+
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            const std::string_view key = record(entries[i].record);
+            if (i > 0 && key == record(entries[i - 1].record))
+            {
+                continue;
+            }
+            emit(key);
+        }
+
+        arena_.clear();
+        records_.clear();
+    }
+
+    void ExternalSorter::spill()
+    {
+        const auto path = next_run_path();
+        runs_.push_back(path);
+        ++total_runs_;
+
+        RunWriter writer(path, MIN_READ_BUFFER);
+        drain_chunk([&](std::string_view key) { writer.write(key); });
+        writer.close();
+    }
+
+    std::filesystem::path ExternalSorter::next_run_path()
+    {
+        // 段文件放在首次溢出时创建的私有目录（0700）内，并以 0600 独占创建，其他本地用户无法读取或抢先占位
+        if (run_directory_.empty())
+        {
+            run_directory_ = platform::create_private_directory(temp_directory_, "randkey-sort-");
+        }
+
+        auto path = run_directory_ / (std::to_string(run_serial_++) + ".run");
+        platform::create_private_file(path);
+        return path;
+    }
+
+    void ExternalSorter::merge(const std::vector<std::filesystem::path> &runs,
+                               std::size_t buffer_bytes,
+                               const std::function<void(std::string_view)> &emit) const
+    {
+        std::vector<std::unique_ptr<RunReader>> readers;
+        readers.reserve(runs.size());
+        for (const auto &run : runs)
+        {
+            readers.push_back(std::make_unique<RunReader>(run, std::max(buffer_bytes, MIN_READ_BUFFER)));
+        }
+
+        auto greater = [&](std::size_t left, std::size_t right) {
+            return readers[left]->current() > readers[right]->current();
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+        for (std::size_t i = 0; i < readers.size(); ++i)
+        {
+            if (readers[i]->next())
+            {
+                heap.push(i);
+            }
+        }
+
+        // 各段内部已去重，跨段重复只可能与上一条输出相同
+        std::string last;
+        bool has_last = false;
+        while (!heap.empty())
+        {
+            const std::size_t top = heap.top();
+            heap.pop();
+
+            const std::string &key = readers[top]->current();
+            if (!has_last || key != last)
+            {
+                emit(key);
+                last = key;
+                has_last = true;
+            }
+
+            if (readers[top]->next())
+            {
+                heap.push(top);
+            }
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include "randkey/fingerprint_set.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <thread>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::uint64_t HASHED_TAG = 1ULL << 63U;
+        constexpr std::size_t EXACT_MAX_LENGTH = 8;
+
+        std::uint64_t mix64(std::uint64_t value) noexcept
+        {
+            value ^= value >> 30U;
+            value *= 0xBF58476D1CE4E5B9ULL;
+            value ^= value >> 27U;
+            value *= 0x94D049BB133111EBULL;
+            value ^= value >> 31U;
+            return value;
+        }
+
+        template <typename Char>
+        KeyFingerprint fingerprint_of(std::basic_string_view<Char> key) noexcept
+        {
+            KeyFingerprint result;
+
+            bool ascii = key.size() <= EXACT_MAX_LENGTH;
+            for (std::size_t i = 0; ascii && i < key.size(); ++i)
+            {
+                ascii = static_cast<std::uint32_t>(key[i]) < 0x80U;
+            }
+
+            if (ascii)
+            {
+                // 前导哨兵位区分长度，最多 1 + 8*7 = 57 位，最高位保持为 0
+                std::uint64_t packed = 1;
+                for (Char ch : key)
+                {
+                    packed = (packed << 7U) | static_cast<std::uint64_t>(ch);
+                }
+                result.primary = packed;
+                result.secondary = 1;
+                return result;
+            }
+
+            // 两个不同初值的 FNV-1a，经 mix64 打散
+            std::uint64_t first = 0xCBF29CE484222325ULL;
+            std::uint64_t second = 0x84222325CBF29CE4ULL ^ static_cast<std::uint64_t>(key.size());
+            for (Char ch : key)
+            {
+                const std::uint64_t unit = static_cast<std::uint64_t>(static_cast<std::uint32_t>(ch));
+                first = (first ^ unit) * 0x100000001B3ULL;
+                second = (second ^ (unit + 0x9E3779B97F4A7C15ULL)) * 0x100000001B3ULL;
+            }
+
+            result.primary = mix64(first) | HASHED_TAG;
+            result.secondary = mix64(second);
+            if (result.secondary == 0)
+            {
+                result.secondary = 1;
+            }
+            return result;
+        }
+    }
+
+    KeyFingerprint KeyFingerprint::of(std::u32string_view key) noexcept
+    {
+        return fingerprint_of(key);
+    }
+
+    KeyFingerprint KeyFingerprint::of(std::string_view key) noexcept
+    {
+        return fingerprint_of(key);
+    }
+
+    bool KeyFingerprint::exact() const noexcept
+    {
+        return (primary & HASHED_TAG) == 0;
+    }
+
+    FingerprintSet::FingerprintSet(std::size_t expected)
+        : capacity_(std::bit_ceil(std::max<std::size_t>(16, expected + expected / 3 + 1))),
+          primary_(std::make_unique<std::atomic<std::uint64_t>[]>(capacity_)),
+          secondary_(std::make_unique<std::atomic<std::uint64_t>[]>(capacity_))
+    {
+    }
+
+    bool FingerprintSet::insert(const KeyFingerprint &fingerprint)
+    {
+        const std::size_t mask = capacity_ - 1;
+        std::size_t slot = static_cast<std::size_t>(mix64(fingerprint.primary)) & mask;
+
+        for (std::size_t probes = 0; probes < capacity_; ++probes, slot = (slot + 1) & mask)
+        {
+            std::uint64_t current = primary_[slot].load(std::memory_order_acquire);
+            if (current == 0)
+            {
+                if (primary_[slot].compare_exchange_strong(current, fingerprint.primary, std::memory_order_acq_rel))
+                {
+                    secondary_[slot].store(fingerprint.secondary, std::memory_order_release);
+                    size_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                // 竞争失败：current 已更新为对方写入的值，继续按已占用槽位处理
+            }
+
+            if (current != fingerprint.primary)
+            {
+                continue;
+            }
+
+            // 占用者可能尚未写入 secondary，短暂等待其发布
+            std::uint64_t other = secondary_[slot].load(std::memory_order_acquire);
+            while (other == 0)
+            {
+                std::this_thread::yield();
+                other = secondary_[slot].load(std::memory_order_acquire);
+            }
+            if (other == fingerprint.secondary)
+            {
+                return false;
+            }
+        }
+
+        throw std::runtime_error("error_unique_exhausted");
+    }
+
+    bool FingerprintSet::contains(const KeyFingerprint &fingerprint) const noexcept
+    {
+        const std::size_t mask = capacity_ - 1;
+        std::size_t slot = static_cast<std::size_t>(mix64(fingerprint.primary)) & mask;
+
+        for (std::size_t probes = 0; probes < capacity_; ++probes, slot = (slot + 1) & mask)
+        {
+            const std::uint64_t current = primary_[slot].load(std::memory_order_acquire);
+            if (current == 0)
+            {
+                return false;
+            }
+            if (current == fingerprint.primary &&
+                secondary_[slot].load(std::memory_order_acquire) == fingerprint.secondary)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t FingerprintSet::size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t FingerprintSet::capacity() const noexcept
+    {
+        return capacity_;
+    }
+}
@@ -1,9 +1,21 @@
 #include "randkey/generator.hpp"
 
+#include "randkey/alias_table.hpp"
+#include "randkey/constraints.hpp"
 #include "randkey/encoding.hpp"
+#include "randkey/exclusion_index.hpp"
+#include "randkey/external_sorter.hpp"
+#include "randkey/fingerprint_set.hpp"
+#include "randkey/id_format.hpp"
+#include "randkey/key_sampling.hpp"
+#include "randkey/pattern.hpp"
+#include "randkey/wordlist.hpp"
 #include "randkey/random_engine.hpp"
+#include "randkey/trace.hpp"
 
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <random>
 #include <stdexcept>
 #include <vector>
@@ -25,21 +37,347 @@ namespace randkey
             }
             return value;
         }
+
+        /// @brief 去重/排除模式下单个密钥的最大重新生成次数，超过即视为密钥空间耗尽
+        constexpr std::size_t UNIQUE_MAX_ATTEMPTS = 1024;
+
+        /// @brief 第 attempt 次重新生成使用下标 index + attempt * RETRY_STRIDE：
+        ///        与批量大小无关，分片运行时同一全局下标的重试序列保持一致
+        constexpr std::size_t RETRY_STRIDE = (std::numeric_limits<std::size_t>::max() / UNIQUE_MAX_ATTEMPTS) + 1;
+
+        /// @brief 原始字节模式每次向随机源请求的块大小
+        constexpr std::size_t RAW_CHUNK_BYTES = 1U << 16U;
+
+        std::uint64_t splitmix64(std::uint64_t &state)
+        {
+            std::uint64_t z = (state += GOLDEN);
+            z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31U);
+        }
+
+        void store_u64(std::span<std::byte> out, std::uint64_t value)
+        {
+            for (std::size_t i = 0; i < out.size(); ++i)
+            {
+                out[i] = static_cast<std::byte>(value >> (8U * i));
+            }
+        }
+
+        void fill_from_engine(std::span<std::byte> out, std::mt19937_64 &engine)
+        {
+            for (std::size_t offset = 0; offset < out.size(); offset += sizeof(std::uint64_t))
+            {
+                const std::size_t take = std::min(sizeof(std::uint64_t), out.size() - offset);
+                store_u64(out.subspan(offset, take), engine());
+            }
+        }
+
+        /// @brief 将混合种子派生的 splitmix64 流异或到安全随机字节上（均匀分布保持不变）
+        void xor_splitmix(std::span<std::byte> out, std::uint64_t state)
+        {
+            for (std::size_t offset = 0; offset < out.size(); offset += sizeof(std::uint64_t))
+            {
+                const std::size_t take = std::min(sizeof(std::uint64_t), out.size() - offset);
+                std::uint64_t mask = splitmix64(state);
+                for (std::size_t i = 0; i < take; ++i)
+                {
+                    out[offset + i] ^= static_cast<std::byte>(mask >> (8U * i));
+                }
+            }
+        }
+
+        void append_token(std::u32string &result, const std::u32string &token)
+        {
+            if (token.size() == 1)
+            {
+                result.push_back(token[0]);
+            }
+            else
+            {
+                result.append(token);
+            }
+        }
+
+        /// @brief 确定性模式：使用 mt19937_64 从 tokens 中抽取 count 个追加到 result
+        void append_deterministic(std::u32string &result,
+                                  const std::vector<std::u32string> &tokens,
+                                  std::size_t count,
+                                  std::mt19937_64 &engine)
+        {
+            std::uniform_int_distribution<std::size_t> distribution(0, tokens.size() - 1);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                append_token(result, tokens[distribution(engine)]);
+            }
+        }
+
+        /// @brief 安全模式：从 tokens 中抽取 count 个追加到 result
+        /// @param position 本段在密钥中的起始抽取位置，用于混合种子扰动
+        /// @param offset_seed 混合种子按密钥索引派生的偏移，无混合种子时为空
+        void append_secure(std::u32string &result,
+                           const std::vector<std::u32string> &tokens,
+                           std::size_t count,
+                           std::size_t position,
+                           std::optional<std::uint64_t> offset_seed,
+                           SecureRandomStream &random)
+        {
+            const std::uint64_t token_count = static_cast<std::uint64_t>(tokens.size());
+            auto apply_tweak = [&](std::size_t offset, std::uint64_t raw) {
+                std::size_t choice = static_cast<std::size_t>(raw);
+                if (offset_seed.has_value() && token_count > 1)
+                {
+                    const std::uint64_t tweak = (offset_seed.value() + static_cast<std::uint64_t>(position + offset)) % token_count;
+                    choice = static_cast<std::size_t>((choice + tweak) % token_count);
+                }
+                return choice;
+            };
+
+            sampling::for_each_uniform_index(token_count, count, random, [&](std::size_t offset, std::uint64_t raw) {
+                append_token(result, tokens[apply_tweak(offset, raw)]);
+            });
+        }
+
+        /// @brief 为第 index 个密钥构造 64 位随机字来源并交给 body
+        /// @details 确定性模式使用按索引派生的 mt19937_64；混合种子异或到安全随机字上而非平移下标，
+        ///          从而不破坏别名表、约束采样等依赖下标结构的抽样
+        template <typename Body>
+        void with_word_source(std::optional<std::uint64_t> deterministic_seed_only,
+                              std::optional<std::uint64_t> mixing_seed,
+                              std::size_t index,
+                              SecureRandomStream &random,
+                              Body &&body)
+        {
+            if (deterministic_seed_only.has_value())
+            {
+                std::mt19937_64 engine(deterministic_seed_only.value() + static_cast<std::uint64_t>(index) * GOLDEN);
+                body([&]() -> std::uint64_t { return engine(); });
+            }
+            else if (mixing_seed.has_value())
+            {
+                std::uint64_t state = mixing_seed.value() + static_cast<std::uint64_t>(index) * GOLDEN;
+                body([&]() -> std::uint64_t { return random.next_u64() ^ splitmix64(state); });
+            }
+            else
+            {
+                body([&]() -> std::uint64_t { return random.next_u64(); });
+            }
+        }
     }
 
     GenerationOutcome RandomKeyGenerator::generate(const GenerationOptions &options,
                                                    std::optional<std::uint64_t> deterministic_seed_only,
                                                    std::optional<std::uint64_t> mixing_seed) const
     {
-        GenerationOptions effective = options;
-        effective.registry.ensure_default();
-        const auto tokens = effective.registry.materialize();
+        if (options.raw_bytes > 0 && options.raw_encoding == BinaryEncoding::Binary)
+        {
+            throw std::runtime_error("error_raw_binary_stream");
+        }
 
-        if (tokens.empty())
+        GenerationOutcome outcome = prepare_outcome(deterministic_seed_only, mixing_seed);
+        outcome.keys.reserve(options.count);
+
+        produce(
+            options, outcome,
+            [&](std::u32string_view key) { outcome.keys.emplace_back(key); },
+            [&](std::string_view encoded) { outcome.keys.push_back(locale_to_utf32(encoded)); });
+
+        return outcome;
+    }
+
+    GenerationOutcome RandomKeyGenerator::generate(const GenerationOptions &options,
+                                                   OutputWriter &writer,
+                                                   std::optional<std::uint64_t> deterministic_seed_only,
+                                                   std::optional<std::uint64_t> mixing_seed,
+                                                   const std::function<void(std::uint64_t)> &on_checkpoint) const
+    {
+        trace::Span span("generate", options.count);
+        GenerationOutcome outcome = prepare_outcome(deterministic_seed_only, mixing_seed);
+        const bool binary = options.raw_bytes > 0 && options.raw_encoding == BinaryEncoding::Binary;
+        writer.emit_hash(options.emit_hash, options.hash_only);
+
+        // 各模式每个下标恰好写出一个密钥，按写出数量即可得到断点下标
+        std::uint64_t emitted = 0;
+        auto after_key = [&] {
+            if (options.checkpoint_interval != 0 && on_checkpoint && ++emitted % options.checkpoint_interval == 0)
+            {
+                writer.flush();
+                on_checkpoint(static_cast<std::uint64_t>(options.start_index) + emitted);
+            }
+        };
+
+        produce(
+            options, outcome,
+            [&](std::u32string_view key) {
+                writer.write_key(key);
+                after_key();
+            },
+            [&](std::string_view encoded) {
+                if (binary)
+                {
+                    writer.write_bytes(encoded);
+                }
+                else
+                {
+                    writer.write_line(encoded);
+                }
+                after_key();
+            });
+        writer.flush();
+
+        return outcome;
+    }
+
+    void RandomKeyGenerator::produce(const GenerationOptions &options,
+                                     GenerationOutcome &outcome,
+                                     const std::function<void(std::u32string_view)> &on_key,
+                                     const std::function<void(std::string_view)> &on_encoded)
+    {
+        if (!options.sorted)
         {
-            throw std::runtime_error("error_charset_empty");
+            produce_direct(options, outcome, on_key, on_encoded);
+            return;
+        }
+
+        ExternalSorter sorter(options.memory_limit,
+                              options.temp_directory.value_or(std::filesystem::temp_directory_path()));
+        std::string narrow;
+        produce_direct(
+            options, outcome,
+            [&](std::u32string_view key) {
+                // 与 OutputWriter 一致：纯 ASCII 直接收窄，否则转为本地编码，按输出字节排序
+                if (std::all_of(key.begin(), key.end(), [](char32_t ch) { return ch < 0x80U; }))
+                {
+                    narrow.assign(key.begin(), key.end());
+                    sorter.push(narrow);
+                }
+                else
+                {
+                    sorter.push(utf32_to_locale(key));
+                }
+            },
+            [&](std::string_view encoded) { sorter.push(encoded); });
+        sorter.finish(on_encoded);
+    }
+
+    void RandomKeyGenerator::produce_direct(const GenerationOptions &options,
+                                            GenerationOutcome &outcome,
+                                            const std::function<void(std::u32string_view)> &on_key,
+                                            const std::function<void(std::string_view)> &on_encoded)
+    {
+        if (options.raw_bytes > 0)
+        {
+            generate_raw(options, outcome, on_encoded);
+            return;
+        }
+
+        if (options.id_format != IdFormat::None)
+        {
+            generate_ids(options, outcome, on_encoded);
+            return;
+        }
+
+        std::optional<FingerprintSet> seen;
+        if (options.unique)
+        {
+            seen.emplace(options.count);
+        }
+
+        std::optional<ExclusionIndex> excluded;
+        if (options.exclude_file.has_value())
+        {
+            excluded.emplace(ExclusionIndex::open(options.exclude_file.value()));
+        }
+
+        // 先查排除索引再登记去重集合，被排除的密钥不占用集合容量
+        auto accept = [&](auto key) {
+            return (!excluded || !excluded->contains(key)) && (!seen || seen->insert(key));
+        };
+
+        if (options.passphrase_wordlist.has_value())
+        {
+            const Wordlist wordlist = Wordlist::load(options.passphrase_wordlist.value());
+            outcome.entropy_bits = wordlist.bits_per_word() * static_cast<double>(options.words);
+            std::function<bool(std::string_view)> accept_phrase;
+            if (seen || excluded)
+            {
+                accept_phrase = [&](std::string_view phrase) { return accept(phrase); };
+            }
+            generate_passphrases(options, wordlist, outcome, accept_phrase, on_encoded);
+            return;
+        }
+
+        // 被拒绝时按 RETRY_STRIDE 重新派生抽取序列：不与其他下标的序列重叠，确定性输出仍可复现
+        auto emit = [&](std::size_t index, auto &&make) {
+            if (!seen && !excluded)
+            {
+                on_key(make(index));
+                return;
+            }
+            for (std::size_t attempt = 0; attempt < UNIQUE_MAX_ATTEMPTS; ++attempt)
+            {
+                const std::u32string key = make(index + attempt * RETRY_STRIDE);
+                if (accept(std::u32string_view(key)))
+                {
+                    on_key(key);
+                    return;
+                }
+            }
+            throw std::runtime_error("error_unique_exhausted");
+        };
+
+        const std::size_t first = options.start_index;
+        const std::size_t last = first + options.count;
+        SecureRandomStream random;
+        if (options.pattern.has_value())
+        {
+            const PatternPlan plan = PatternPlan::compile(options.pattern.value(), options.registry);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                emit(i, [&](std::size_t index) {
+                    return generate_pattern_single(plan, outcome.deterministic_seed, outcome.mixing_seed, index, random);
+                });
+            }
+            return;
         }
 
+        const auto charset = prepare_charset(options);
+        const auto &tokens = charset->tokens;
+        if (!options.required_classes.empty())
+        {
+            const ConstrainedSampler sampler(tokens, options.required_classes, options.length);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                emit(i, [&](std::size_t index) {
+                    return generate_constrained_single(sampler, tokens, outcome.deterministic_seed, outcome.mixing_seed, index, random);
+                });
+            }
+            return;
+        }
+
+        if (charset->weighted)
+        {
+            const AliasTable table(charset->weights);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                emit(i, [&](std::size_t index) {
+                    return generate_weighted_single(table, tokens, options.length, outcome.deterministic_seed, outcome.mixing_seed, index, random);
+                });
+            }
+            return;
+        }
+
+        for (std::size_t i = first; i < last; ++i)
+        {
+            emit(i, [&](std::size_t index) {
+                return generate_single(tokens, options.length, outcome.deterministic_seed, outcome.mixing_seed, index, random);
+            });
+        }
+    }
+
+    GenerationOutcome RandomKeyGenerator::prepare_outcome(std::optional<std::uint64_t> deterministic_seed_only,
+                                                          std::optional<std::uint64_t> mixing_seed)
+    {
         GenerationOutcome outcome{};
         outcome.deterministic_seed = deterministic_seed_only;
 
@@ -52,24 +390,154 @@ namespace randkey
             throw std::logic_error("error_conflicting_seed");
         }
 
-        outcome.keys.reserve(effective.count);
-        for (std::size_t i = 0; i < effective.count; ++i)
+        return outcome;
+    }
+
+    std::shared_ptr<const CompiledCharset> RandomKeyGenerator::prepare_charset(const GenerationOptions &options)
+    {
+        auto charset = options.compiled_charset ? options.compiled_charset : options.registry.compile();
+        if (charset->tokens.empty())
         {
-            outcome.keys.push_back(generate_single(tokens,
-                                                   effective.length,
-                                                   deterministic_seed_only,
-                                                   outcome.mixing_seed,
-                                                   i));
+            throw std::runtime_error("error_charset_empty");
         }
 
-        return outcome;
+        return charset;
+    }
+
+    void RandomKeyGenerator::for_each_random_block(const GenerationOutcome &outcome,
+                                                   std::size_t block_bytes,
+                                                   std::size_t first_index,
+                                                   std::size_t count,
+                                                   const std::function<void(std::span<const std::byte>)> &consume)
+    {
+        const std::size_t blocks_per_chunk = std::max<std::size_t>(1, RAW_CHUNK_BYTES / block_bytes);
+        std::vector<std::byte> chunk;
+
+        for (std::size_t done = 0; done < count; done += blocks_per_chunk)
+        {
+            const std::size_t batch = std::min(blocks_per_chunk, count - done);
+            const std::size_t first = first_index + done;
+            chunk.resize(batch * block_bytes);
+
+            if (outcome.deterministic_seed.has_value())
+            {
+                for (std::size_t k = 0; k < batch; ++k)
+                {
+                    const std::uint64_t seed = outcome.deterministic_seed.value() + static_cast<std::uint64_t>(first + k) * GOLDEN;
+                    std::mt19937_64 engine(seed);
+                    fill_from_engine(std::span<std::byte>(chunk).subspan(k * block_bytes, block_bytes), engine);
+                }
+            }
+            else
+            {
+                SecureRandom::fill(chunk);
+                if (outcome.mixing_seed.has_value())
+                {
+                    for (std::size_t k = 0; k < batch; ++k)
+                    {
+                        std::uint64_t state = outcome.mixing_seed.value() + static_cast<std::uint64_t>(first + k) * GOLDEN;
+                        xor_splitmix(std::span<std::byte>(chunk).subspan(k * block_bytes, block_bytes), state);
+                    }
+                }
+            }
+
+            for (std::size_t k = 0; k < batch; ++k)
+            {
+                consume(std::span<const std::byte>(chunk.data() + k * block_bytes, block_bytes));
+            }
+        }
+
+        std::fill(chunk.begin(), chunk.end(), std::byte{0});
+    }
+
+    void RandomKeyGenerator::generate_raw(const GenerationOptions &options,
+                                          const GenerationOutcome &outcome,
+                                          const std::function<void(std::string_view)> &emit)
+    {
+        std::string encoded;
+        encoded.reserve(encoded_size(options.raw_bytes, options.raw_encoding));
+
+        for_each_random_block(outcome, options.raw_bytes, options.start_index, options.count, [&](std::span<const std::byte> key) {
+            if (options.raw_encoding == BinaryEncoding::Binary)
+            {
+                emit(std::string_view(reinterpret_cast<const char *>(key.data()), key.size()));
+                return;
+            }
+
+            encoded.clear();
+            append_encoded(encoded, key, options.raw_encoding);
+            emit(encoded);
+        });
+    }
+
+    void RandomKeyGenerator::generate_ids(const GenerationOptions &options,
+                                          const GenerationOutcome &outcome,
+                                          const std::function<void(std::string_view)> &emit)
+    {
+        IdFormatter formatter(options.id_format);
+        std::string text;
+        text.reserve(formatter.text_size());
+
+        // 时间戳按块读取一次即可：单调逻辑保证同一毫秒内的标识符仍然严格递增
+        std::size_t produced = 0;
+        std::uint64_t now = IdFormatter::now_unix_ms();
+        for_each_random_block(outcome, IdFormatter::RANDOM_BYTES, options.start_index, options.count, [&](std::span<const std::byte> random) {
+            if ((produced++ & 0x3FFU) == 0)
+            {
+                now = IdFormatter::now_unix_ms();
+            }
+
+            text.clear();
+            formatter.append_next(random.first<IdFormatter::RANDOM_BYTES>(), now, text);
+            emit(text);
+        });
+    }
+
+    void RandomKeyGenerator::generate_passphrases(const GenerationOptions &options,
+                                                  const Wordlist &wordlist,
+                                                  const GenerationOutcome &outcome,
+                                                  const std::function<bool(std::string_view)> &accept,
+                                                  const std::function<void(std::string_view)> &emit)
+    {
+        const std::string separator = utf32_to_locale(options.separator);
+        const std::uint64_t size = static_cast<std::uint64_t>(wordlist.size());
+        SecureRandomStream random;
+        std::string phrase;
+        auto compose = [&](std::size_t index) {
+            phrase.clear();
+            with_word_source(outcome.deterministic_seed, outcome.mixing_seed, index, random, [&](auto &&source) {
+                sampling::for_each_word_index(size, options.words, source, [&](std::size_t w, std::size_t word) {
+                    if (w > 0)
+                    {
+                        phrase.append(separator);
+                    }
+                    phrase.append(wordlist.word(word));
+                });
+            });
+        };
+
+        const std::size_t end = options.start_index + options.count;
+        for (std::size_t i = options.start_index; i < end; ++i)
+        {
+            compose(i);
+            for (std::size_t attempt = 1; accept && !accept(phrase); ++attempt)
+            {
+                if (attempt == UNIQUE_MAX_ATTEMPTS)
+                {
+                    throw std::runtime_error("error_unique_exhausted");
+                }
+                compose(i + attempt * RETRY_STRIDE);
+            }
+            emit(phrase);
+        }
     }
 
     std::u32string RandomKeyGenerator::generate_single(const std::vector<std::u32string> &tokens,
                                                        std::size_t length,
                                                        std::optional<std::uint64_t> deterministic_seed_only,
                                                        std::optional<std::uint64_t> mixing_seed,
-                                                       std::size_t index)
+                                                       std::size_t index,
+                                                       SecureRandomStream &random)
     {
         if (tokens.empty())
         {
@@ -81,33 +549,90 @@ namespace randkey
         {
             const std::uint64_t seed = deterministic_seed_only.value() + static_cast<std::uint64_t>(index) * GOLDEN;
             std::mt19937_64 engine(seed);
-            std::uniform_int_distribution<std::size_t> distribution(0, tokens.size() - 1);
+            append_deterministic(result, tokens, length, engine);
+            return result;
+        }
 
-            for (std::size_t i = 0; i < length; ++i)
+        const std::optional<std::uint64_t> offset_seed = mixing_seed.has_value()
+                                                             ? std::optional<std::uint64_t>(mixing_seed.value() + static_cast<std::uint64_t>(index) * GOLDEN)
+                                                             : std::nullopt;
+        append_secure(result, tokens, length, 0, offset_seed, random);
+        return result;
+    }
+
+    std::u32string RandomKeyGenerator::generate_pattern_single(const PatternPlan &plan,
+                                                               std::optional<std::uint64_t> deterministic_seed_only,
+                                                               std::optional<std::uint64_t> mixing_seed,
+                                                               std::size_t index,
+                                                               SecureRandomStream &random)
+    {
+        std::u32string result;
+        const auto &tables = plan.tables();
+
+        if (deterministic_seed_only.has_value())
+        {
+            const std::uint64_t seed = deterministic_seed_only.value() + static_cast<std::uint64_t>(index) * GOLDEN;
+            std::mt19937_64 engine(seed);
+            for (const auto &segment : plan.segments())
             {
-                const std::u32string &token = tokens[distribution(engine)];
-                result.insert(result.end(), token.begin(), token.end());
+                if (segment.repeat == 0)
+                {
+                    result.append(segment.literal);
+                    continue;
+                }
+                append_deterministic(result, tables[segment.table], segment.repeat, engine);
             }
             return result;
         }
 
-        const std::uint64_t offset_seed = mixing_seed.has_value() ? (mixing_seed.value() + static_cast<std::uint64_t>(index) * GOLDEN) : 0ULL;
-
-        for (std::size_t i = 0; i < length; ++i)
+        const std::optional<std::uint64_t> offset_seed = mixing_seed.has_value()
+                                                             ? std::optional<std::uint64_t>(mixing_seed.value() + static_cast<std::uint64_t>(index) * GOLDEN)
+                                                             : std::nullopt;
+        std::size_t position = 0;
+        for (const auto &segment : plan.segments())
         {
-            const std::uint64_t raw = SecureRandom::uniform(static_cast<std::uint64_t>(tokens.size()));
-            std::size_t choice = static_cast<std::size_t>(raw);
-
-            if (mixing_seed.has_value() && tokens.size() > 1)
+            if (segment.repeat == 0)
             {
-                const std::uint64_t tweak = (offset_seed + static_cast<std::uint64_t>(i)) % static_cast<std::uint64_t>(tokens.size());
-                choice = static_cast<std::size_t>((choice + tweak) % static_cast<std::uint64_t>(tokens.size()));
+                result.append(segment.literal);
+                continue;
             }
-
-            const std::u32string &token = tokens[choice];
-            result.insert(result.end(), token.begin(), token.end());
+            append_secure(result, tables[segment.table], segment.repeat, position, offset_seed, random);
+            position += segment.repeat;
         }
+        return result;
+    }
 
+    std::u32string RandomKeyGenerator::generate_constrained_single(const ConstrainedSampler &sampler,
+                                                                   const std::vector<std::u32string> &tokens,
+                                                                   std::optional<std::uint64_t> deterministic_seed_only,
+                                                                   std::optional<std::uint64_t> mixing_seed,
+                                                                   std::size_t index,
+                                                                   SecureRandomStream &random)
+    {
+        std::vector<std::size_t> choices;
+        std::u32string result;
+        with_word_source(deterministic_seed_only, mixing_seed, index, random, [&](auto &&source) {
+            sampling::for_each_constrained_index(sampler, choices, source, [&](std::size_t choice) {
+                append_token(result, tokens[choice]);
+            });
+        });
+        return result;
+    }
+
+    std::u32string RandomKeyGenerator::generate_weighted_single(const AliasTable &table,
+                                                                const std::vector<std::u32string> &tokens,
+                                                                std::size_t length,
+                                                                std::optional<std::uint64_t> deterministic_seed_only,
+                                                                std::optional<std::uint64_t> mixing_seed,
+                                                                std::size_t index,
+                                                                SecureRandomStream &random)
+    {
+        std::u32string result;
+        with_word_source(deterministic_seed_only, mixing_seed, index, random, [&](auto &&source) {
+            sampling::for_each_weighted_index(table, length, source, [&](std::size_t choice) {
+                append_token(result, tokens[choice]);
+            });
+        });
         return result;
     }
 }
@@ -8,7 +8,10 @@ namespace randkey::i18n
         catalog.insert("en-US",
                        {
                            {"help_title", "RandKey - Secure Random Key Generator"},
-                           {"help_usage", "Usage: randkey [options]"},
+                           {"help_usage", "Usage: randkey [options]\n"
+                                          "       randkey serve --socket <path> [--profiles <file>] [--pool <n>] [--shm <name>]\n"
+                                          "       randkey batch <jobs.jsonl> [--threads <n>] [--trace <file>]\n"
+                                          "       randkey verify --input <file> [charset options] [--length <n>] [--require <classes>]"},
                            {"help_options", "Options:\n"
                                              "  -h, --help            Show this help message\n"
                                              "  --version             Show version information\n"
@@ -16,21 +19,120 @@ namespace randkey::i18n
                                              "  -s, --seed <n>        Mix deterministic seed with hardware entropy\n"
                                              "  -l, --length <n>      Set length of each key (default 12)\n"
                                              "  -c, --count <n>       Number of keys to generate (default 1)\n"
+                                             "      --raw-bytes <n>   Emit n random bytes per key, bypassing character sets\n"
+                                             "      --raw-encoding <e> Raw key encoding: binary|hex|base32|base64|base64url\n"
+                                             "      --id <format>     Generate identifiers: uuid4|uuid7|ulid\n"
+                                             "      --passphrase <file> Generate passphrases from a wordlist (one word per line)\n"
+                                             "      --words <n>       Words per passphrase (default 6)\n"
+                                             "      --separator <s>   Passphrase word separator (default space)\n"
+                                             "  -p, --pattern <tpl>   Generate from template, e.g. AAAA-9999-XXXX\n"
+                                             "                        (9 a A x X h H ! ? placeholders, {n} repeats, \\ escapes)\n"
                                              "  -all, --all           Include all built-in character sets\n"
                                              "  -aa, --lower          Include lowercase letters\n"
                                              "  -aA, --upper          Include uppercase letters\n"
                                              "  -a0, --digits         Include digits\n"
                                              "  -a!, --special        Include special characters\n"
+                                             "      --hex             Include hex alphabet (0-9a-f)\n"
+                                             "      --base32          Include RFC 4648 base32 alphabet\n"
+                                             "      --base64          Include base64 alphabet\n"
+                                             "      --base64url       Include URL-safe base64 alphabet\n"
+                                             "      --require <list>  Require at least one of each class: lower,upper,digit,special\n"
+                                             "      --start-index <n> Index of the first key (default 0)\n"
+                                             "      --checkpoint <n>  Record a checkpoint (<output>.ckpt) every n keys\n"
+                                             "      --resume          Continue an interrupted --output run from its checkpoint\n"
+                                             "      --shard <i/n>     Generate shard i (0-based) of n slices of --count\n"
+                                             "      --unique          Regenerate duplicates so every key in the batch is distinct\n"
+                                             "      --exclude-file <keys> Regenerate keys already listed in file (index cached as <keys>.rkx)\n"
+                                             "      --sorted          Output keys in ascending byte order with duplicates removed\n"
+                                             "      --mem-limit <n>   Memory budget for --sorted, K/M/G suffixes (default 256M)\n"
+                                             "      --temp-dir <dir>  Directory for --sorted spill runs (default: system temp directory)\n"
                                              "  -ai, --append <chars> Append custom characters\n"
                                              "  -at, --append-token <token> Append multi-character token\n"
                                              "  -af, --append-file <file> Append characters from file\n"
                                              "  -aft, --append-file-token <file> Append tokens (per line) from file\n"
+                                             "  -afw, --append-file-weighted <file> Append weighted tokens (token<TAB>weight per line)\n"
+                                             "      --exclude <chars> Remove characters from the final charset (e.g. 0O1lI)\n"
+                                             "      --emit-hash <alg> Append each key's digest as key<TAB>hex (sha256 or blake3)\n"
+                                             "      --hash-only       With --emit-hash, output only the digest\n"
                                              "  -o, --output <file>   Write results to file\n"
+                                             "      --output-format <fmt>:<file> Also write the same keys to file (text|csv|sha256|blake3|sha256-bin), repeatable\n"
                                              "      --force           Overwrite output file if exists\n"
-                                             "      --show-seed       Print the seed used for generation"},
+                                             "      --show-seed       Print the seed used for generation\n"
+                                             "      --stats           Print throughput, entropy reads, rejection rate, peak RSS and stage times to stderr\n"
+                                             "      --stats-json      Same as --stats, as one JSON object\n"
+                                             "      --trace <file>    Write pipeline stage spans as Chrome trace-event JSON"},
                            {"error_seed", "Error: invalid seed value"},
                            {"error_length", "Error: length must be a positive integer"},
                            {"error_count", "Error: count must be a positive integer"},
+                           {"error_raw_bytes", "Error: raw byte count must be a positive integer"},
+                           {"error_binary_encoding", "Error: unknown raw encoding (expected binary, hex, base32, base64 or base64url)"},
+                           {"error_raw_binary_stream", "Error: binary raw output is only available when streaming"},
+                           {"error_id_format", "Error: unknown identifier format (expected uuid4, uuid7 or ulid)"},
+                           {"error_conflicting_mode", "Error: only one of --raw-bytes, --id, --pattern and --passphrase can be used"},
+                           {"error_pattern", "Error: invalid pattern near position"},
+                           {"error_require_class", "Error: unknown required class (expected lower, upper, digit or special)"},
+                           {"error_require_missing", "Error: a required class has no characters in the active charset"},
+                           {"error_require_length", "Error: key length is shorter than the number of required classes"},
+                           {"error_require_too_long", "Error: with --require, keys longer than 1024 need every required class to be common enough in the charset"},
+                           {"error_require_mode", "Error: --require only applies to character set generation"},
+                           {"error_exclude_chars_mode", "Error: --exclude only applies to character set generation"},
+                           {"error_hash_algorithm", "Error: unknown hash algorithm (expected sha256 or blake3)"},
+                           {"error_stats_disabled", "Error: this build was configured without --stats support (RANDKEY_ENABLE_STATS=OFF)"},
+                           {"error_batch_trace", "Error: pass --trace to randkey batch itself, not to individual jobs"},
+                           {"error_hash_only", "Error: --hash-only requires --emit-hash"},
+                           {"error_hash_mode", "Error: --emit-hash does not apply to binary raw output"},
+                           {"error_output_format", "Error: --output-format expects <format>:<file> with format text, csv, sha256, blake3 or sha256-bin"},
+                           {"error_output_format_mode", "Error: --output-format cannot be combined with binary raw output, checkpoints or batch jobs"},
+                           {"error_output_format_path", "Error: each output must go to a different file"},
+                           {"error_weight", "Error: token weight must be a positive finite number"},
+                           {"error_weight_file", "Error: invalid weight in file"},
+                           {"error_require_weighted", "Error: --require cannot be combined with weighted tokens"},
+                           {"error_words", "Error: word count must be a positive integer"},
+                           {"error_unique_mode", "Error: --unique does not apply to --raw-bytes or --id"},
+                           {"error_unique_exhausted", "Error: not enough distinct keys left for --unique/--exclude-file"},
+                           {"error_exclude_mode", "Error: --exclude-file does not apply to --raw-bytes or --id"},
+                           {"error_exclude_file", "Error: failed to read exclusion key file"},
+                           {"error_mem_limit", "Error: invalid memory limit (e.g. 512M, 2G)"},
+                           {"error_start_index", "Error: start index must be a non-negative integer"},
+                           {"error_checkpoint_interval", "Error: checkpoint interval must be a positive integer"},
+                           {"error_checkpoint_mode", "Error: --checkpoint/--resume require --output and cannot be combined with --unique or --sorted"},
+                           {"error_checkpoint", "Error: checkpoint file is missing or malformed"},
+                           {"error_checkpoint_write", "Error: failed to write checkpoint file"},
+                           {"error_checkpoint_mismatch", "Error: checkpoint does not match this command or output file"},
+                           {"error_shard", "Error: invalid shard (expected i/n with 0 <= i < n, not combined with --start-index)"},
+                           {"error_shard_mode", "Error: --shard/--start-index cannot be combined with --unique or --sorted"},
+                           {"error_sort_spill", "Error: failed to write or read temporary sort runs"},
+                           {"error_temp_dir", "Error: cannot create a private temporary directory under"},
+                           {"error_serve_usage", "Error: serve requires --socket <path>"},
+                           {"error_serve_socket", "Error: unable to listen on local socket"},
+                           {"error_serve_connect", "Error: unable to talk to key server at"},
+                           {"error_serve_unsupported", "Error: serve mode is not supported on this platform"},
+                           {"error_serve_profile", "Error: invalid or unsupported serve profile"},
+                           {"error_serve_pool", "Error: pool size must be a positive integer"},
+                           {"error_serve_request", "Error: malformed key request"},
+                           {"error_serve_stopped", "Error: key server is shutting down"},
+                           {"error_ring_name", "Error: shared memory name must be non-empty and contain no '/'"},
+                           {"error_ring_open", "Error: unable to create or open shared memory key ring"},
+                           {"error_ring_closed", "Error: shared memory key ring has been closed by the server"},
+                           {"error_ring_key_size", "Error: key is too long for a shared memory ring slot"},
+                           {"error_batch_usage", "Error: batch requires a job file (randkey batch <jobs.jsonl>)"},
+                           {"error_batch_file", "Error: unable to read job file"},
+                           {"error_batch_json", "Error: malformed job line near column"},
+                           {"error_batch_key", "Error: unknown job field"},
+                           {"error_batch_output", "Error: each job must write to its own --output file"},
+                           {"error_batch_duplicate_output", "Error: output file is already used by another job"},
+                           {"error_batch_threads", "Error: thread count must be a positive integer"},
+                           {"error_verify_usage", "Error: verify requires --input <file>"},
+                           {"error_verify_mode", "Error: verify only checks character set policies (not --pattern, --passphrase, --raw-bytes or --id)"},
+                           {"error_verify_tokens", "Error: verify does not support multi-character tokens"},
+                           {"error_verify_input", "Error: unable to read key file"},
+                           {"verify_empty", "empty line"},
+                           {"verify_encoding", "invalid UTF-8 at character"},
+                           {"verify_charset", "character outside the charset at position"},
+                           {"verify_length", "length does not match --length, actual"},
+                           {"verify_required", "missing a character class required by --require"},
+                           {"error_plan_option", "Error: seeds, --unique, --sorted, --exclude-file, --checkpoint, ranges and --output do not apply to single-key plans"},
+                           {"error_wordlist_empty", "Error: wordlist contains no words"},
                            {"error_missing_output_path", "Error: output path is required when --output is specified"},
                            {"error_unexpected_output_path", "Error: output path is only valid when using --output"},
                            {"error_conflicting_seed", "Error: --seed and --seed-only cannot be used together"},
@@ -43,12 +145,26 @@ namespace randkey::i18n
                            {"error_write_file", "Error: unable to write output file"},
                            {"info_seed_deterministic", "Deterministic seed:"},
                            {"info_seed_mixing", "Mixing seed:"},
+                           {"info_entropy", "Entropy per passphrase (bits):"},
+                           {"info_stats_keys", "Keys:"},
+                           {"info_stats_bytes", "Output bytes:"},
+                           {"info_stats_entropy", "Entropy reads / bytes:"},
+                           {"info_stats_rejections", "Uniform rejections / draws:"},
+                           {"info_stats_transcodes", "Encoding conversions:"},
+                           {"info_stats_writes", "Output writes:"},
+                           {"info_stats_rss", "Peak RSS:"},
+                           {"info_stats_stages", "Time (ms):"},
+                           {"info_verify_keys", "Keys checked:"},
+                           {"info_verify_violations", "Violations:"},
                        });
 
         catalog.insert("zh-CN",
                        {
                            {"help_title", "RandKey - 安全随机密钥生成器"},
-                           {"help_usage", "用法: randkey [选项]"},
+                           {"help_usage", "用法: randkey [选项]\n"
+                                          "      randkey serve --socket <路径> [--profiles <文件>] [--pool <n>] [--shm <名称>]\n"
+                                          "      randkey batch <作业文件.jsonl> [--threads <n>] [--trace <文件>]\n"
+                                          "      randkey verify --input <文件> [字符集选项] [--length <n>] [--require <类别>]"},
                            {"help_options", "选项:\n"
                                              "  -h, --help            显示帮助信息\n"
                                              "  --version             显示版本号\n"
@@ -56,21 +172,120 @@ namespace randkey::i18n
                                              "  -s, --seed <n>        使用确定性种子并混合硬件熵\n"
                                              "  -l, --length <n>      设置每个密钥长度（默认 12）\n"
                                              "  -c, --count <n>       生成密钥数量（默认 1）\n"
+                                             "      --raw-bytes <n>   每个密钥输出 n 个随机字节，不经过字符集\n"
+                                             "      --raw-encoding <e> 原始字节编码：binary|hex|base32|base64|base64url\n"
+                                             "      --id <格式>       生成标识符：uuid4|uuid7|ulid\n"
+                                             "      --passphrase <文件> 从词表生成口令（每行一个单词）\n"
+                                             "      --words <n>       每条口令的单词数（默认 6）\n"
+                                             "      --separator <s>   口令单词分隔符（默认空格）\n"
+                                             "  -p, --pattern <模板>  按模板生成，如 AAAA-9999-XXXX\n"
+                                             "                        （占位符 9 a A x X h H ! ?，{n} 重复，\\ 转义）\n"
                                              "  -all, --all           包含全部内置字符集\n"
                                              "  -aa, --lower          包含小写字母\n"
                                              "  -aA, --upper          包含大写字母\n"
                                              "  -a0, --digits         包含数字\n"
                                              "  -a!, --special        包含特殊字符\n"
+                                             "      --hex             包含十六进制字母表（0-9a-f）\n"
+                                             "      --base32          包含 RFC 4648 Base32 字母表\n"
+                                             "      --base64          包含 Base64 字母表\n"
+                                             "      --base64url       包含 URL 安全的 Base64 字母表\n"
+                                             "      --require <列表>  每类至少包含一个：lower,upper,digit,special\n"
+                                             "      --start-index <n> 首个密钥的下标（默认 0）\n"
+                                             "      --checkpoint <n>  每生成 n 个密钥记录一次断点（<输出文件>.ckpt）\n"
+                                             "      --resume          从断点继续被中断的 --output 任务\n"
+                                             "      --shard <i/n>     将 --count 均分为 n 片，只生成第 i 片（从 0 起）\n"
+                                             "      --unique          批内去重，重复的密钥会重新生成\n"
+                                             "      --exclude-file <文件> 重新生成已在文件中出现的密钥（索引缓存为 <文件>.rkx）\n"
+                                             "      --sorted          按字节序升序输出并去除重复\n"
+                                             "      --mem-limit <n>   --sorted 的内存预算，支持 K/M/G 后缀（默认 256M）\n"
+                                             "      --temp-dir <dir>  --sorted 溢出段所在目录（默认系统临时目录）\n"
                                              "  -ai, --append <字符>  添加自定义字符\n"
                                              "  -at, --append-token <短语> 添加多字符短语\n"
                                              "  -af, --append-file <文件> 从文件追加字符\n"
                                              "  -aft, --append-file-token <文件> 按行追加短语\n"
+                                             "  -afw, --append-file-weighted <文件> 按行追加加权短语（token<TAB>权重）\n"
+                                             "      --exclude <字符>  从最终字符集中剔除这些字符（如 0O1lI）\n"
+                                             "      --emit-hash <算法> 每行附带密钥摘要 key<TAB>hex（sha256 或 blake3）\n"
+                                             "      --hash-only       与 --emit-hash 合用，只输出摘要\n"
                                              "  -o, --output <文件>   将结果写入文件\n"
+                                             "      --output-format <格式>:<文件> 同一批密钥另写一份到文件（text|csv|sha256|blake3|sha256-bin），可重复\n"
                                              "      --force           若文件存在则覆盖写入\n"
-                                             "      --show-seed       输出所使用的种子"},
+                                             "      --show-seed       输出所使用的种子\n"
+                                             "      --stats           结束时在 stderr 输出吞吐、随机源读取、拒绝率、峰值内存与各阶段耗时\n"
+                                             "      --stats-json      同 --stats，输出为单个 JSON 对象\n"
+                                             "      --trace <文件>    将各流水线阶段的区间导出为 Chrome trace-event JSON"},
                            {"error_seed", "错误: 种子无效"},
                            {"error_length", "错误: 长度必须是正整数"},
                            {"error_count", "错误: 数量必须是正整数"},
+                           {"error_raw_bytes", "错误: 原始字节数必须是正整数"},
+                           {"error_binary_encoding", "错误: 未知的原始字节编码（可选 binary、hex、base32、base64、base64url）"},
+                           {"error_raw_binary_stream", "错误: 二进制原始输出仅支持流式写出"},
+                           {"error_id_format", "错误: 未知的标识符格式（可选 uuid4、uuid7、ulid）"},
+                           {"error_conflicting_mode", "错误: --raw-bytes、--id、--pattern 与 --passphrase 只能选择其一"},
+                           {"error_pattern", "错误: 模板语法错误，位置"},
+                           {"error_require_class", "错误: 未知的必选类别（可选 lower、upper、digit、special）"},
+                           {"error_require_missing", "错误: 当前字符集中缺少某个必选类别的字符"},
+                           {"error_require_length", "错误: 密钥长度小于必选类别数量"},
+                           {"error_require_too_long", "错误: 使用 --require 且长度超过 1024 时，每个必选类别在字符集中的占比不能过小"},
+                           {"error_require_mode", "错误: --require 仅适用于字符集生成模式"},
+                           {"error_exclude_chars_mode", "错误: --exclude 仅适用于字符集生成模式"},
+                           {"error_hash_algorithm", "错误: 未知的摘要算法（可选 sha256、blake3）"},
+                           {"error_stats_disabled", "错误: 当前构建未启用 --stats（RANDKEY_ENABLE_STATS=OFF）"},
+                           {"error_batch_trace", "错误: --trace 应传给 randkey batch 本身，而不是单个作业"},
+                           {"error_hash_only", "错误: --hash-only 需要与 --emit-hash 同时使用"},
+                           {"error_hash_mode", "错误: --emit-hash 不适用于二进制原始输出"},
+                           {"error_output_format", "错误: --output-format 的格式应为 <格式>:<文件>，格式可选 text、csv、sha256、blake3、sha256-bin"},
+                           {"error_output_format_mode", "错误: --output-format 不能与二进制原始输出、断点或批处理作业同时使用"},
+                           {"error_output_format_path", "错误: 各输出必须写入不同的文件"},
+                           {"error_weight", "错误: 权重必须是有限正数"},
+                           {"error_weight_file", "错误: 文件中的权重无效"},
+                           {"error_require_weighted", "错误: --require 不能与加权短语同时使用"},
+                           {"error_words", "错误: 单词数必须是正整数"},
+                           {"error_unique_mode", "错误: --unique 不适用于 --raw-bytes 或 --id"},
+                           {"error_unique_exhausted", "错误: 剩余的不同密钥数量不足以满足 --unique/--exclude-file"},
+                           {"error_exclude_mode", "错误: --exclude-file 不适用于 --raw-bytes 或 --id"},
+                           {"error_exclude_file", "错误: 无法读取排除密钥文件"},
+                           {"error_mem_limit", "错误: 内存上限无效（例如 512M、2G）"},
+                           {"error_start_index", "错误: 起始下标必须是非负整数"},
+                           {"error_checkpoint_interval", "错误: 断点间隔必须是正整数"},
+                           {"error_checkpoint_mode", "错误: --checkpoint/--resume 需要 --output，且不能与 --unique 或 --sorted 同时使用"},
+                           {"error_checkpoint", "错误: 断点文件缺失或格式错误"},
+                           {"error_checkpoint_write", "错误: 写入断点文件失败"},
+                           {"error_checkpoint_mismatch", "错误: 断点与当前命令或输出文件不匹配"},
+                           {"error_shard", "错误: 分片无效（应为 i/n 且 0 <= i < n，且不能与 --start-index 同时使用）"},
+                           {"error_shard_mode", "错误: --shard/--start-index 不能与 --unique 或 --sorted 同时使用"},
+                           {"error_sort_spill", "错误: 读写排序临时文件失败"},
+                           {"error_temp_dir", "错误: 无法在以下目录中创建私有临时目录:"},
+                           {"error_serve_usage", "错误: serve 需要 --socket <路径>"},
+                           {"error_serve_socket", "错误: 无法监听本地套接字"},
+                           {"error_serve_connect", "错误: 无法与密钥服务通信"},
+                           {"error_serve_unsupported", "错误: 当前平台不支持服务模式"},
+                           {"error_serve_profile", "错误: 服务配置无效或不受支持"},
+                           {"error_serve_pool", "错误: 池大小必须是正整数"},
+                           {"error_serve_request", "错误: 密钥请求格式错误"},
+                           {"error_serve_stopped", "错误: 密钥服务正在关闭"},
+                           {"error_ring_name", "错误: 共享内存名称不能为空且不能包含 '/'"},
+                           {"error_ring_open", "错误: 无法创建或打开共享内存密钥环"},
+                           {"error_ring_closed", "错误: 共享内存密钥环已被服务端关闭"},
+                           {"error_ring_key_size", "错误: 密钥超出共享内存环槽位长度"},
+                           {"error_batch_usage", "错误: batch 需要作业文件（randkey batch <作业文件.jsonl>）"},
+                           {"error_batch_file", "错误: 无法读取作业文件"},
+                           {"error_batch_json", "错误: 作业行格式错误，列"},
+                           {"error_batch_key", "错误: 未知的作业字段"},
+                           {"error_batch_output", "错误: 每个作业必须通过 --output 写入各自的文件"},
+                           {"error_batch_duplicate_output", "错误: 输出文件已被其他作业使用"},
+                           {"error_batch_threads", "错误: 线程数必须是正整数"},
+                           {"error_verify_usage", "错误: verify 需要 --input <文件>"},
+                           {"error_verify_mode", "错误: verify 只校验字符集策略（不支持 --pattern、--passphrase、--raw-bytes 或 --id）"},
+                           {"error_verify_tokens", "错误: verify 不支持多字符短语"},
+                           {"error_verify_input", "错误: 无法读取密钥文件"},
+                           {"verify_empty", "空行"},
+                           {"verify_encoding", "UTF-8 编码无效，位置"},
+                           {"verify_charset", "字符不在字符集中，位置"},
+                           {"verify_length", "长度与 --length 不符，实际"},
+                           {"verify_required", "缺少 --require 要求的字符类别"},
+                           {"error_plan_option", "错误: 种子、--unique、--sorted、--exclude-file、--checkpoint、区间与 --output 不适用于单密钥计划"},
+                           {"error_wordlist_empty", "错误: 词表为空"},
                            {"error_missing_output_path", "错误: 使用 --output 时必须提供文件路径"},
                            {"error_unexpected_output_path", "错误: 仅在使用 --output 时才能提供文件路径"},
                            {"error_conflicting_seed", "错误: --seed 与 --seed-only 不能同时使用"},
@@ -83,6 +298,17 @@ namespace randkey::i18n
                            {"error_write_file", "错误: 写入输出文件失败"},
                            {"info_seed_deterministic", "确定性种子:"},
                            {"info_seed_mixing", "混合种子:"},
+                           {"info_entropy", "每条口令熵（比特）:"},
+                           {"info_stats_keys", "密钥数:"},
+                           {"info_stats_bytes", "输出字节:"},
+                           {"info_stats_entropy", "随机源读取次数 / 字节:"},
+                           {"info_stats_rejections", "均匀抽样拒绝 / 成功:"},
+                           {"info_stats_transcodes", "编码转换次数:"},
+                           {"info_stats_writes", "输出写入次数:"},
+                           {"info_stats_rss", "峰值常驻内存:"},
+                           {"info_stats_stages", "耗时（毫秒）:"},
+                           {"info_verify_keys", "已校验密钥:"},
+                           {"info_verify_violations", "违规:"},
                        });
 
         return catalog;
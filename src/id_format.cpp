@@ -0,0 +1,199 @@
+#include "randkey/id_format.hpp"
+
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::string_view HEX_ALPHABET = "0123456789abcdef";
+        constexpr std::string_view CROCKFORD_ALPHABET = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+        constexpr std::uint64_t MAX_TIMESTAMP = (1ULL << 48U) - 1;
+        constexpr std::uint16_t UUID_COUNTER_MAX = 0x0FFF;
+        /// @brief 新毫秒内计数器起点只取 11 位随机数，保留一半空间给同毫秒递增
+        constexpr std::uint16_t UUID_COUNTER_SEED_MASK = 0x07FF;
+
+        /// @brief 每个字节对应两个十六进制字符，整表查找替代逐半字节转换
+        constexpr std::array<char, 512> HEX_PAIRS = [] {
+            std::array<char, 512> table{};
+            for (std::size_t i = 0; i < 256; ++i)
+            {
+                table[i * 2] = HEX_ALPHABET[i >> 4U];
+                table[i * 2 + 1] = HEX_ALPHABET[i & 0x0FU];
+            }
+            return table;
+        }();
+
+        std::uint8_t byte_at(std::span<const std::byte, IdFormatter::RANDOM_BYTES> random, std::size_t index)
+        {
+            return std::to_integer<std::uint8_t>(random[index]);
+        }
+
+        std::uint64_t load_be(std::span<const std::byte, IdFormatter::RANDOM_BYTES> random, std::size_t offset, std::size_t size)
+        {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                value = (value << 8U) | byte_at(random, offset + i);
+            }
+            return value;
+        }
+
+        /// @brief 取 128 位整数 (high:low) 中从 shift 位开始的 5 位
+        std::uint32_t take5(std::uint64_t high, std::uint64_t low, unsigned shift)
+        {
+            if (shift >= 64)
+            {
+                return static_cast<std::uint32_t>((high >> (shift - 64U)) & 0x1FU);
+            }
+            if (shift + 5U <= 64U)
+            {
+                return static_cast<std::uint32_t>((low >> shift) & 0x1FU);
+            }
+            return static_cast<std::uint32_t>(((low >> shift) | (high << (64U - shift))) & 0x1FU);
+        }
+    }
+
+    IdFormat parse_id_format(std::u32string_view name)
+    {
+        if (name == U"uuid4" || name == U"uuidv4")
+        {
+            return IdFormat::UuidV4;
+        }
+        if (name == U"uuid7" || name == U"uuidv7")
+        {
+            return IdFormat::UuidV7;
+        }
+        if (name == U"ulid")
+        {
+            return IdFormat::Ulid;
+        }
+        throw std::runtime_error("error_id_format");
+    }
+
+    IdFormatter::IdFormatter(IdFormat format)
+        : format_(format)
+    {
+        if (format_ == IdFormat::None)
+        {
+            throw std::invalid_argument("IdFormatter 需要具体的标识符格式");
+        }
+    }
+
+    std::uint64_t IdFormatter::now_unix_ms()
+    {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+    }
+
+    void IdFormatter::append_next(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out)
+    {
+        if (format_ == IdFormat::Ulid)
+        {
+            append_ulid(random, unix_ms & MAX_TIMESTAMP, out);
+        }
+        else
+        {
+            append_uuid(random, unix_ms & MAX_TIMESTAMP, out);
+        }
+    }
+
+    std::size_t IdFormatter::text_size() const noexcept
+    {
+        return format_ == IdFormat::Ulid ? 26 : 36;
+    }
+
+    void IdFormatter::append_uuid(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out)
+    {
+        std::array<std::uint8_t, 16> bytes{};
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+        {
+            bytes[i] = byte_at(random, i);
+        }
+
+        if (format_ == IdFormat::UuidV7)
+        {
+            // RFC 9562 6.2 方法 1：rand_a 作为 12 位计数器，同毫秒内递增，溢出时借用下一毫秒
+            if (unix_ms > last_ms_)
+            {
+                last_ms_ = unix_ms;
+                counter_ = static_cast<std::uint16_t>(load_be(random, 6, 2) & UUID_COUNTER_SEED_MASK);
+            }
+            else if (counter_ == UUID_COUNTER_MAX)
+            {
+                ++last_ms_;
+                counter_ = static_cast<std::uint16_t>(load_be(random, 6, 2) & UUID_COUNTER_SEED_MASK);
+            }
+            else
+            {
+                ++counter_;
+            }
+
+            for (std::size_t i = 0; i < 6; ++i)
+            {
+                bytes[i] = static_cast<std::uint8_t>(last_ms_ >> (40U - 8U * i));
+            }
+            bytes[6] = static_cast<std::uint8_t>(0x70U | ((counter_ >> 8U) & 0x0FU));
+            bytes[7] = static_cast<std::uint8_t>(counter_ & 0xFFU);
+        }
+        else
+        {
+            bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0FU) | 0x40U);
+        }
+        bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3FU) | 0x80U);
+
+        const std::size_t start = out.size();
+        out.resize(start + 36);
+        char *dst = out.data() + start;
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+        {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+            {
+                dst[pos++] = '-';
+            }
+            dst[pos++] = HEX_PAIRS[bytes[i] * 2U];
+            dst[pos++] = HEX_PAIRS[bytes[i] * 2U + 1U];
+        }
+    }
+
+    void IdFormatter::append_ulid(std::span<const std::byte, RANDOM_BYTES> random, std::uint64_t unix_ms, std::string &out)
+    {
+        // ULID 单调规范：同毫秒内 80 位随机部分加一，溢出时借用下一毫秒并重新取随机数
+        bool fresh = unix_ms > last_ms_;
+        if (!fresh)
+        {
+            ++ulid_low_;
+            if (ulid_low_ == 0)
+            {
+                ulid_high_ = (ulid_high_ + 1U) & 0xFFFFU;
+                if (ulid_high_ == 0)
+                {
+                    unix_ms = last_ms_ + 1;
+                    fresh = true;
+                }
+            }
+        }
+
+        if (fresh)
+        {
+            last_ms_ = unix_ms;
+            ulid_high_ = load_be(random, 0, 2);
+            ulid_low_ = load_be(random, 2, 8);
+        }
+
+        const std::uint64_t high = (last_ms_ << 16U) | ulid_high_;
+        const std::uint64_t low = ulid_low_;
+
+        const std::size_t start = out.size();
+        out.resize(start + 26);
+        char *dst = out.data() + start;
+        for (unsigned i = 0; i < 26; ++i)
+        {
+            dst[i] = CROCKFORD_ALPHABET[take5(high, low, 125U - 5U * i)];
+        }
+    }
+}
@@ -0,0 +1,456 @@
+#include "randkey/key_hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDKEY_HASH_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::array<std::uint32_t, 64> SHA256_K = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        // SHA-256 初始值，BLAKE3 的 IV 与之相同
+        constexpr std::array<std::uint32_t, 8> IV = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+        };
+
+        constexpr std::size_t SHA256_LANES = 8;
+
+        constexpr std::uint32_t rotr(std::uint32_t value, unsigned bits) noexcept
+        {
+            return (value >> bits) | (value << (32U - bits));
+        }
+
+        std::uint32_t load_be32(const unsigned char *bytes) noexcept
+        {
+            return (static_cast<std::uint32_t>(bytes[0]) << 24U) | (static_cast<std::uint32_t>(bytes[1]) << 16U) |
+                   (static_cast<std::uint32_t>(bytes[2]) << 8U) | static_cast<std::uint32_t>(bytes[3]);
+        }
+
+        std::uint32_t load_le32(const unsigned char *bytes) noexcept
+        {
+            return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8U) |
+                   (static_cast<std::uint32_t>(bytes[2]) << 16U) | (static_cast<std::uint32_t>(bytes[3]) << 24U);
+        }
+
+        std::size_t sha256_blocks(std::size_t size) noexcept
+        {
+            return (size + 9 + 63) / 64;
+        }
+
+        /// @brief 构造消息的第 index 个填充块（0x80 结束符 + 末块 64 位大端比特长度）
+        void sha256_padded_block(std::string_view data, std::size_t index, std::size_t blocks, unsigned char out[64]) noexcept
+        {
+            const std::size_t begin = index * 64;
+            std::memset(out, 0, 64);
+            if (begin < data.size())
+            {
+                std::memcpy(out, data.data() + begin, std::min<std::size_t>(64, data.size() - begin));
+            }
+            if (data.size() >= begin && data.size() < begin + 64)
+            {
+                out[data.size() - begin] = 0x80;
+            }
+            if (index + 1 == blocks)
+            {
+                const std::uint64_t bits = static_cast<std::uint64_t>(data.size()) * 8U;
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    out[63 - i] = static_cast<unsigned char>(bits >> (8U * i));
+                }
+            }
+        }
+
+        void sha256_compress(std::array<std::uint32_t, 8> &state, const unsigned char block[64]) noexcept
+        {
+            std::array<std::uint32_t, 64> w{};
+            for (std::size_t t = 0; t < 16; ++t)
+            {
+                w[t] = load_be32(block + 4 * t);
+            }
+            for (std::size_t t = 16; t < 64; ++t)
+            {
+                const std::uint32_t s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3U);
+                const std::uint32_t s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10U);
+                w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+            }
+
+            std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (std::size_t t = 0; t < 64; ++t)
+            {
+                const std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[t] + w[t];
+                const std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+            state[4] += e;
+            state[5] += f;
+            state[6] += g;
+            state[7] += h;
+        }
+
+#if defined(RANDKEY_HASH_AVX2)
+        __attribute__((target("avx2"))) inline __m256i rotr_lanes(__m256i value, int bits) noexcept
+        {
+            return _mm256_or_si256(_mm256_srli_epi32(value, bits), _mm256_slli_epi32(value, 32 - bits));
+        }
+
+        /// @brief 8 路多缓冲 SHA-256：8 条块数相同的消息逐块转置为 8 个 32 位通道并行压缩
+        __attribute__((target("avx2"))) void sha256_x8(const std::string_view *data, std::size_t blocks, KeyDigest *out) noexcept
+        {
+            __m256i state[8];
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                state[i] = _mm256_set1_epi32(static_cast<int>(IV[i]));
+            }
+
+            alignas(32) std::uint32_t words[16][SHA256_LANES];
+            unsigned char block[64];
+            __m256i w[64];
+            for (std::size_t index = 0; index < blocks; ++index)
+            {
+                for (std::size_t lane = 0; lane < SHA256_LANES; ++lane)
+                {
+                    sha256_padded_block(data[lane], index, blocks, block);
+                    for (std::size_t t = 0; t < 16; ++t)
+                    {
+                        words[t][lane] = load_be32(block + 4 * t);
+                    }
+                }
+                for (std::size_t t = 0; t < 16; ++t)
+                {
+                    w[t] = _mm256_load_si256(reinterpret_cast<const __m256i *>(words[t]));
+                }
+                for (std::size_t t = 16; t < 64; ++t)
+                {
+                    const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr_lanes(w[t - 15], 7), rotr_lanes(w[t - 15], 18)),
+                                                        _mm256_srli_epi32(w[t - 15], 3));
+                    const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr_lanes(w[t - 2], 17), rotr_lanes(w[t - 2], 19)),
+                                                        _mm256_srli_epi32(w[t - 2], 10));
+                    w[t] = _mm256_add_epi32(_mm256_add_epi32(w[t - 16], s0), _mm256_add_epi32(w[t - 7], s1));
+                }
+
+                __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+                __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+                for (std::size_t t = 0; t < 64; ++t)
+                {
+                    const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr_lanes(e, 6), rotr_lanes(e, 11)), rotr_lanes(e, 25));
+                    const __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                    const __m256i t1 = _mm256_add_epi32(
+                        _mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(choose, w[t])),
+                        _mm256_set1_epi32(static_cast<int>(SHA256_K[t])));
+                    const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr_lanes(a, 2), rotr_lanes(a, 13)), rotr_lanes(a, 22));
+                    const __m256i majority = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(a, b), _mm256_and_si256(a, c)),
+                                                              _mm256_and_si256(b, c));
+                    const __m256i t2 = _mm256_add_epi32(sigma0, majority);
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = _mm256_add_epi32(d, t1);
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = _mm256_add_epi32(t1, t2);
+                }
+                state[0] = _mm256_add_epi32(state[0], a);
+                state[1] = _mm256_add_epi32(state[1], b);
+                state[2] = _mm256_add_epi32(state[2], c);
+                state[3] = _mm256_add_epi32(state[3], d);
+                state[4] = _mm256_add_epi32(state[4], e);
+                state[5] = _mm256_add_epi32(state[5], f);
+                state[6] = _mm256_add_epi32(state[6], g);
+                state[7] = _mm256_add_epi32(state[7], h);
+            }
+
+            alignas(32) std::uint32_t lanes[8][SHA256_LANES];
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[i]), state[i]);
+            }
+            for (std::size_t lane = 0; lane < SHA256_LANES; ++lane)
+            {
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    out[lane][4 * i] = static_cast<std::uint8_t>(lanes[i][lane] >> 24U);
+                    out[lane][4 * i + 1] = static_cast<std::uint8_t>(lanes[i][lane] >> 16U);
+                    out[lane][4 * i + 2] = static_cast<std::uint8_t>(lanes[i][lane] >> 8U);
+                    out[lane][4 * i + 3] = static_cast<std::uint8_t>(lanes[i][lane]);
+                }
+            }
+            // 消息调度与块缓冲都由密钥派生
+            std::memset(block, 0, sizeof(block));
+        }
+
+        bool has_avx2() noexcept
+        {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+#endif
+
+        constexpr std::uint32_t BLAKE3_CHUNK_START = 1U << 0U;
+        constexpr std::uint32_t BLAKE3_CHUNK_END = 1U << 1U;
+        constexpr std::uint32_t BLAKE3_PARENT = 1U << 2U;
+        constexpr std::uint32_t BLAKE3_ROOT = 1U << 3U;
+        constexpr std::size_t BLAKE3_CHUNK_BYTES = 1024;
+        constexpr std::array<std::size_t, 16> BLAKE3_PERMUTATION = {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8};
+
+        using Blake3Words = std::array<std::uint32_t, 16>;
+        using Blake3Cv = std::array<std::uint32_t, 8>;
+
+        inline void blake3_g(Blake3Words &s, std::size_t a, std::size_t b, std::size_t c, std::size_t d,
+                             std::uint32_t x, std::uint32_t y) noexcept
+        {
+            s[a] = s[a] + s[b] + x;
+            s[d] = rotr(s[d] ^ s[a], 16);
+            s[c] = s[c] + s[d];
+            s[b] = rotr(s[b] ^ s[c], 12);
+            s[a] = s[a] + s[b] + y;
+            s[d] = rotr(s[d] ^ s[a], 8);
+            s[c] = s[c] + s[d];
+            s[b] = rotr(s[b] ^ s[c], 7);
+        }
+
+        Blake3Words blake3_compress(const Blake3Cv &cv, Blake3Words block, std::uint64_t counter,
+                                    std::uint32_t block_len, std::uint32_t flags) noexcept
+        {
+            Blake3Words s = {cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+                             IV[0], IV[1], IV[2], IV[3],
+                             static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32U),
+                             block_len, flags};
+            for (int round = 0; round < 7; ++round)
+            {
+                blake3_g(s, 0, 4, 8, 12, block[0], block[1]);
+                blake3_g(s, 1, 5, 9, 13, block[2], block[3]);
+                blake3_g(s, 2, 6, 10, 14, block[4], block[5]);
+                blake3_g(s, 3, 7, 11, 15, block[6], block[7]);
+                blake3_g(s, 0, 5, 10, 15, block[8], block[9]);
+                blake3_g(s, 1, 6, 11, 12, block[10], block[11]);
+                blake3_g(s, 2, 7, 8, 13, block[12], block[13]);
+                blake3_g(s, 3, 4, 9, 14, block[14], block[15]);
+
+                Blake3Words permuted{};
+                for (std::size_t i = 0; i < 16; ++i)
+                {
+                    permuted[i] = block[BLAKE3_PERMUTATION[i]];
+                }
+                block = permuted;
+            }
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                s[i] ^= s[i + 8];
+                s[i + 8] ^= cv[i];
+            }
+            return s;
+        }
+
+        /// @brief 尚未决定是否为根节点的压缩输入
+        struct Blake3Output
+        {
+            Blake3Cv cv;
+            Blake3Words block;
+            std::uint64_t counter;
+            std::uint32_t block_len;
+            std::uint32_t flags;
+
+            Blake3Cv chaining_value() const noexcept
+            {
+                const Blake3Words s = blake3_compress(cv, block, counter, block_len, flags);
+                Blake3Cv result{};
+                std::copy_n(s.begin(), 8, result.begin());
+                return result;
+            }
+        };
+
+        Blake3Output blake3_chunk(const unsigned char *data, std::size_t size, std::uint64_t index) noexcept
+        {
+            Blake3Cv cv = IV;
+            const std::size_t blocks = std::max<std::size_t>(1, (size + 63) / 64);
+            for (std::size_t b = 0;; ++b)
+            {
+                unsigned char bytes[64]{};
+                const std::size_t offset = b * 64;
+                const std::size_t length = std::min<std::size_t>(64, size - std::min(size, offset));
+                if (length > 0)
+                {
+                    std::memcpy(bytes, data + offset, length);
+                }
+                Blake3Words words{};
+                for (std::size_t i = 0; i < 16; ++i)
+                {
+                    words[i] = load_le32(bytes + 4 * i);
+                }
+                const std::uint32_t flags = (b == 0 ? BLAKE3_CHUNK_START : 0U) | (b + 1 == blocks ? BLAKE3_CHUNK_END : 0U);
+                if (b + 1 == blocks)
+                {
+                    return Blake3Output{cv, words, index, static_cast<std::uint32_t>(length), flags};
+                }
+                const Blake3Words s = blake3_compress(cv, words, index, 64, flags);
+                std::copy_n(s.begin(), 8, cv.begin());
+            }
+        }
+
+        Blake3Output blake3_parent(const Blake3Cv &left, const Blake3Cv &right) noexcept
+        {
+            Blake3Words block{};
+            std::copy(left.begin(), left.end(), block.begin());
+            std::copy(right.begin(), right.end(), block.begin() + 8);
+            return Blake3Output{IV, block, 0, 64, BLAKE3_PARENT};
+        }
+    }
+
+    KeyHashAlgorithm parse_key_hash_algorithm(std::u32string_view name)
+    {
+        if (name == U"sha256")
+        {
+            return KeyHashAlgorithm::Sha256;
+        }
+        if (name == U"blake3")
+        {
+            return KeyHashAlgorithm::Blake3;
+        }
+        throw std::runtime_error("error_hash_algorithm");
+    }
+
+    KeyDigest sha256(std::string_view data) noexcept
+    {
+        std::array<std::uint32_t, 8> state = IV;
+        const std::size_t blocks = sha256_blocks(data.size());
+        unsigned char block[64];
+        for (std::size_t index = 0; index < blocks; ++index)
+        {
+            sha256_padded_block(data, index, blocks, block);
+            sha256_compress(state, block);
+        }
+        std::memset(block, 0, sizeof(block));
+
+        KeyDigest digest{};
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            digest[4 * i] = static_cast<std::uint8_t>(state[i] >> 24U);
+            digest[4 * i + 1] = static_cast<std::uint8_t>(state[i] >> 16U);
+            digest[4 * i + 2] = static_cast<std::uint8_t>(state[i] >> 8U);
+            digest[4 * i + 3] = static_cast<std::uint8_t>(state[i]);
+        }
+        return digest;
+    }
+
+    KeyDigest blake3(std::string_view data) noexcept
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(data.data());
+        const std::size_t chunks = std::max<std::size_t>(1, (data.size() + BLAKE3_CHUNK_BYTES - 1) / BLAKE3_CHUNK_BYTES);
+
+        // 合并栈深度不超过块数的二进制位数
+        std::array<Blake3Cv, 64> stack{};
+        std::size_t depth = 0;
+        for (std::size_t chunk = 0; chunk + 1 < chunks; ++chunk)
+        {
+            Blake3Cv cv = blake3_chunk(bytes + chunk * BLAKE3_CHUNK_BYTES, BLAKE3_CHUNK_BYTES, chunk).chaining_value();
+            for (std::uint64_t total = chunk + 1; (total & 1U) == 0; total >>= 1U)
+            {
+                cv = blake3_parent(stack[--depth], cv).chaining_value();
+            }
+            stack[depth++] = cv;
+        }
+
+        const std::size_t last = (chunks - 1) * BLAKE3_CHUNK_BYTES;
+        Blake3Output output = blake3_chunk(bytes + last, data.size() - last, chunks - 1);
+        while (depth > 0)
+        {
+            output = blake3_parent(stack[--depth], output.chaining_value());
+        }
+
+        const Blake3Words root = blake3_compress(output.cv, output.block, 0, output.block_len, output.flags | BLAKE3_ROOT);
+        KeyDigest digest{};
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            digest[4 * i] = static_cast<std::uint8_t>(root[i]);
+            digest[4 * i + 1] = static_cast<std::uint8_t>(root[i] >> 8U);
+            digest[4 * i + 2] = static_cast<std::uint8_t>(root[i] >> 16U);
+            digest[4 * i + 3] = static_cast<std::uint8_t>(root[i] >> 24U);
+        }
+        return digest;
+    }
+
+    void hash_keys(KeyHashAlgorithm algorithm, std::span<const std::string_view> keys, std::span<KeyDigest> digests)
+    {
+        if (algorithm == KeyHashAlgorithm::Blake3)
+        {
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                digests[i] = blake3(keys[i]);
+            }
+            return;
+        }
+
+        std::size_t done = 0;
+#if defined(RANDKEY_HASH_AVX2)
+        if (has_avx2())
+        {
+            // 同一批密钥通常等长：连续 8 条块数相同时整组并行，否则退回逐条计算
+            std::array<std::string_view, SHA256_LANES> lanes{};
+            std::array<KeyDigest, SHA256_LANES> results{};
+            while (done + SHA256_LANES <= keys.size())
+            {
+                const std::size_t blocks = sha256_blocks(keys[done].size());
+                bool uniform = true;
+                for (std::size_t lane = 0; lane < SHA256_LANES; ++lane)
+                {
+                    lanes[lane] = keys[done + lane];
+                    uniform = uniform && sha256_blocks(lanes[lane].size()) == blocks;
+                }
+                if (!uniform)
+                {
+                    digests[done] = sha256(keys[done]);
+                    ++done;
+                    continue;
+                }
+                sha256_x8(lanes.data(), blocks, results.data());
+                std::copy(results.begin(), results.end(), digests.begin() + static_cast<std::ptrdiff_t>(done));
+                done += SHA256_LANES;
+            }
+        }
+#endif
+        for (; done < keys.size(); ++done)
+        {
+            digests[done] = sha256(keys[done]);
+        }
+    }
+
+    void append_digest_hex(std::string &out, const KeyDigest &digest)
+    {
+        constexpr char DIGITS[] = "0123456789abcdef";
+        for (std::uint8_t byte : digest)
+        {
+            out.push_back(DIGITS[byte >> 4U]);
+            out.push_back(DIGITS[byte & 0x0FU]);
+        }
+    }
+}
@@ -0,0 +1,361 @@
+#include "randkey/key_plan.hpp"
+
+#include "randkey/alias_table.hpp"
+#include "randkey/binary_codec.hpp"
+#include "randkey/constraints.hpp"
+#include "randkey/encoding.hpp"
+#include "randkey/id_format.hpp"
+#include "randkey/key_sampling.hpp"
+#include "randkey/pattern.hpp"
+#include "randkey/trace.hpp"
+#include "randkey/wordlist.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 预编码为 UTF-8 的 token 表：连续字节 + 偏移，抽样后直接 memcpy
+        class EncodedTable
+        {
+        public:
+            EncodedTable() = default;
+
+            explicit EncodedTable(const std::vector<std::u32string> &tokens)
+            {
+                offsets_.reserve(tokens.size() + 1);
+                offsets_.push_back(0);
+                for (const auto &token : tokens)
+                {
+                    bytes_.append(utf32_to_utf8(token));
+                    offsets_.push_back(bytes_.size());
+                    max_bytes_ = std::max(max_bytes_, offsets_.back() - offsets_[offsets_.size() - 2]);
+                }
+            }
+
+            std::size_t size() const noexcept
+            {
+                return offsets_.empty() ? 0 : offsets_.size() - 1;
+            }
+
+            std::size_t max_bytes() const noexcept
+            {
+                return max_bytes_;
+            }
+
+            std::string_view operator[](std::size_t index) const noexcept
+            {
+                return std::string_view(bytes_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+            }
+
+        private:
+            std::string bytes_;
+            std::vector<std::size_t> offsets_;
+            std::size_t max_bytes_{0};
+        };
+
+        /// @brief 只写入容量以内的部分，同时累计完整长度
+        struct BoundedSink
+        {
+            char *buffer;
+            std::size_t capacity;
+            std::size_t size{0};
+
+            void put(std::string_view bytes) noexcept
+            {
+                if (size < capacity)
+                {
+                    std::memcpy(buffer + size, bytes.data(), std::min(bytes.size(), capacity - size));
+                }
+                size += bytes.size();
+            }
+        };
+
+        enum class PlanKind
+        {
+            Charset,
+            Weighted,
+            Constrained,
+            Pattern,
+            Passphrase,
+            Raw,
+            Id,
+        };
+
+        struct PatternStep
+        {
+            std::string literal;
+            std::size_t table{0};
+            std::size_t repeat{0};
+        };
+
+        struct IdState
+        {
+            std::mutex mutex;
+            IdFormatter formatter;
+
+            explicit IdState(IdFormat format) : formatter(format) {}
+        };
+    }
+
+    struct KeyPlan::State
+    {
+        PlanKind kind{PlanKind::Charset};
+        std::size_t length{0};
+        std::size_t max_key_bytes{0};
+
+        EncodedTable table{};
+        AliasTable alias{};
+        std::optional<ConstrainedSampler> constrained{};
+
+        std::vector<PatternStep> steps{};
+        std::vector<EncodedTable> pattern_tables{};
+
+        std::optional<Wordlist> wordlist{};
+        std::string separator{};
+        std::size_t words{0};
+
+        std::size_t raw_bytes{0};
+        BinaryEncoding encoding{BinaryEncoding::Binary};
+
+        // 标识符的单调性需要跨调用共享状态，格式化器由互斥量保护
+        std::unique_ptr<IdState> id{};
+    };
+
+    KeyEngine::~KeyEngine()
+    {
+        std::fill(text_.begin(), text_.end(), '\0');
+        std::fill(bytes_.begin(), bytes_.end(), std::byte{0});
+    }
+
+    KeyPlan::KeyPlan(std::unique_ptr<State> state) : state_(std::move(state))
+    {
+    }
+
+    KeyPlan::KeyPlan(KeyPlan &&) noexcept = default;
+    KeyPlan &KeyPlan::operator=(KeyPlan &&) noexcept = default;
+    KeyPlan::~KeyPlan() = default;
+
+    KeyPlan KeyPlan::compile(const GenerationOptions &options)
+    {
+        trace::Span span("plan_compile");
+        const bool batch_only = options.unique || options.sorted || options.exclude_file.has_value() ||
+                                options.checkpoint_interval != 0 || options.start_index != 0 ||
+                                options.target != OutputTarget::Stdout || options.emit_hash != KeyHashAlgorithm::None ||
+                                !options.tee_targets.empty() || options.trace_path.has_value();
+        if (batch_only)
+        {
+            throw std::runtime_error("error_plan_option");
+        }
+
+        auto state = std::make_unique<State>();
+        if (options.raw_bytes > 0)
+        {
+            state->kind = PlanKind::Raw;
+            state->raw_bytes = options.raw_bytes;
+            state->encoding = options.raw_encoding;
+            state->max_key_bytes = options.raw_encoding == BinaryEncoding::Binary
+                                       ? options.raw_bytes
+                                       : encoded_size(options.raw_bytes, options.raw_encoding);
+        }
+        else if (options.id_format != IdFormat::None)
+        {
+            state->kind = PlanKind::Id;
+            state->id = std::make_unique<IdState>(options.id_format);
+            state->max_key_bytes = state->id->formatter.text_size();
+        }
+        else if (options.passphrase_wordlist.has_value())
+        {
+            state->kind = PlanKind::Passphrase;
+            state->wordlist = Wordlist::load(options.passphrase_wordlist.value());
+            state->separator = utf32_to_utf8(options.separator);
+            state->words = options.words;
+
+            std::size_t longest = 0;
+            for (std::size_t i = 0; i < state->wordlist->size(); ++i)
+            {
+                longest = std::max(longest, state->wordlist->word(i).size());
+            }
+            state->max_key_bytes = longest * options.words + state->separator.size() * (options.words - 1);
+        }
+        else if (options.pattern.has_value())
+        {
+            state->kind = PlanKind::Pattern;
+            const PatternPlan plan = PatternPlan::compile(options.pattern.value(), options.registry);
+            for (const auto &table : plan.tables())
+            {
+                state->pattern_tables.emplace_back(table);
+            }
+            for (const auto &segment : plan.segments())
+            {
+                PatternStep step{utf32_to_utf8(segment.literal), segment.table, segment.repeat};
+                state->max_key_bytes += segment.repeat == 0
+                                            ? step.literal.size()
+                                            : segment.repeat * state->pattern_tables[segment.table].max_bytes();
+                state->steps.push_back(std::move(step));
+            }
+        }
+        else
+        {
+            const auto charset = options.compiled_charset ? options.compiled_charset : options.registry.compile();
+            if (charset->tokens.empty())
+            {
+                throw std::runtime_error("error_charset_empty");
+            }
+
+            state->table = EncodedTable(charset->tokens);
+            state->length = options.length;
+            state->max_key_bytes = options.length * state->table.max_bytes();
+            if (!options.required_classes.empty())
+            {
+                state->kind = PlanKind::Constrained;
+                state->constrained.emplace(charset->tokens, options.required_classes, options.length);
+            }
+            else if (charset->weighted)
+            {
+                state->kind = PlanKind::Weighted;
+                state->alias = AliasTable(charset->weights);
+            }
+        }
+
+        return KeyPlan(std::move(state));
+    }
+
+    std::size_t KeyPlan::max_key_bytes() const noexcept
+    {
+        return state_->max_key_bytes;
+    }
+
+    std::size_t KeyPlan::generate_into(KeyEngine &engine, char *buffer, std::size_t capacity) const
+    {
+        const State &plan = *state_;
+        SecureRandomStream &random = engine.random_;
+        BoundedSink sink{buffer, capacity};
+
+        switch (plan.kind)
+        {
+        case PlanKind::Charset:
+        {
+            sampling::for_each_uniform_index(plan.table.size(), plan.length, random, [&](std::size_t, std::uint64_t index) {
+                sink.put(plan.table[static_cast<std::size_t>(index)]);
+            });
+            break;
+        }
+        case PlanKind::Weighted:
+        {
+            auto source = [&] { return random.next_u64(); };
+            sampling::for_each_weighted_index(plan.alias, plan.length, source, [&](std::size_t index) {
+                sink.put(plan.table[index]);
+            });
+            break;
+        }
+        case PlanKind::Constrained:
+        {
+            engine.indices_.reserve(plan.length);
+            auto source = [&] { return random.next_u64(); };
+            sampling::for_each_constrained_index(*plan.constrained, engine.indices_, source, [&](std::size_t index) {
+                sink.put(plan.table[index]);
+            });
+            break;
+        }
+        case PlanKind::Pattern:
+        {
+            for (const auto &step : plan.steps)
+            {
+                if (step.repeat == 0)
+                {
+                    sink.put(step.literal);
+                    continue;
+                }
+                const EncodedTable &table = plan.pattern_tables[step.table];
+                sampling::for_each_uniform_index(table.size(), step.repeat, random, [&](std::size_t, std::uint64_t index) {
+                    sink.put(table[static_cast<std::size_t>(index)]);
+                });
+            }
+            break;
+        }
+        case PlanKind::Passphrase:
+        {
+            auto source = [&] { return random.next_u64(); };
+            sampling::for_each_word_index(plan.wordlist->size(), plan.words, source, [&](std::size_t w, std::size_t word) {
+                if (w > 0)
+                {
+                    sink.put(plan.separator);
+                }
+                sink.put(plan.wordlist->word(word));
+            });
+            break;
+        }
+        case PlanKind::Raw:
+        {
+            engine.bytes_.resize(plan.raw_bytes);
+            random.fill(engine.bytes_);
+            if (plan.encoding == BinaryEncoding::Binary)
+            {
+                sink.put(std::string_view(reinterpret_cast<const char *>(engine.bytes_.data()), engine.bytes_.size()));
+                break;
+            }
+            engine.text_.clear();
+            append_encoded(engine.text_, engine.bytes_, plan.encoding);
+            sink.put(engine.text_);
+            break;
+        }
+        case PlanKind::Id:
+        {
+            engine.bytes_.resize(IdFormatter::RANDOM_BYTES);
+            random.fill(engine.bytes_);
+            engine.text_.clear();
+            {
+                std::lock_guard<std::mutex> lock(plan.id->mutex);
+                plan.id->formatter.append_next(std::span<const std::byte, IdFormatter::RANDOM_BYTES>(engine.bytes_.data(), IdFormatter::RANDOM_BYTES),
+                                               IdFormatter::now_unix_ms(),
+                                               engine.text_);
+            }
+            sink.put(engine.text_);
+            break;
+        }
+        }
+
+        return sink.size;
+    }
+
+    std::string KeyPlan::generate(KeyEngine &engine) const
+    {
+        std::string key(max_key_bytes(), '\0');
+        key.resize(std::min(generate_into(engine, key.data(), key.size()), key.size()));
+        return key;
+    }
+
+    KeyView KeyPlan::keys() const
+    {
+        return KeyView(*this);
+    }
+
+    KeyView::KeyView(const KeyPlan &plan)
+        : plan_(&plan), engine_(std::make_unique<KeyEngine>())
+    {
+        current_.reserve(plan.max_key_bytes());
+    }
+
+    KeyView::~KeyView()
+    {
+        std::fill(current_.begin(), current_.end(), '\0');
+    }
+
+    const std::string &KeyView::current()
+    {
+        if (stale_)
+        {
+            // 容量已按最大密钥长度预留，resize 不会重新分配
+            current_.resize(plan_->max_key_bytes());
+            current_.resize(std::min(plan_->generate_into(*engine_, current_.data(), current_.size()), current_.size()));
+            stale_ = false;
+        }
+        return current_;
+    }
+}
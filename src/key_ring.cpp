@@ -0,0 +1,295 @@
+#include "randkey/key_ring.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr char RING_MAGIC[8] = {'R', 'K', 'R', 'I', 'N', 'G', '0', '1'};
+        constexpr std::size_t MAX_SLOTS = 1U << 24U;
+
+        /// @brief 忙等次数：短暂空窗内避免进入内核
+        constexpr int SPIN_LIMIT = 256;
+
+        /// @brief futex 单次休眠上限，兼作关闭与丢失唤醒的兜底
+        constexpr int WAIT_TIMEOUT_MS = 100;
+
+        /// @brief 序号最高位：消费方已锁定槽位、正在拷出
+        constexpr std::uint64_t SLOT_BUSY = 1ULL << 63U;
+
+        /// @brief 区域头部；生产与消费的热点字段各占一条缓存行，避免伪共享
+        struct alignas(64) RingHeader
+        {
+            char magic[8];
+            std::uint32_t slot_count;
+            std::uint32_t slot_bytes;
+            std::atomic<std::uint32_t> closed;
+
+            alignas(64) std::atomic<std::uint64_t> claim_ticket;
+            std::atomic<std::uint32_t> data_signal;
+            std::atomic<std::uint32_t> data_waiters;
+
+            alignas(64) std::atomic<std::uint32_t> space_signal;
+            std::atomic<std::uint32_t> space_waiters;
+        };
+
+        struct RingSlot
+        {
+            std::atomic<std::uint64_t> sequence;
+            std::uint32_t length;
+            std::uint32_t reserved;
+            char bytes[KEY_RING_SLOT_BYTES];
+        };
+
+        static_assert(sizeof(RingSlot) == 256);
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        std::size_t region_size(std::size_t slots)
+        {
+            return sizeof(RingHeader) + slots * sizeof(RingSlot);
+        }
+
+        RingHeader &header_of(const platform::SharedMemory &region)
+        {
+            return *std::launder(reinterpret_cast<RingHeader *>(region.bytes().data()));
+        }
+
+        RingSlot &slot_of(const platform::SharedMemory &region, std::uint64_t ticket)
+        {
+            const RingHeader &header = header_of(region);
+            auto *slots = reinterpret_cast<RingSlot *>(region.bytes().data() + sizeof(RingHeader));
+            return *std::launder(slots + (ticket & (header.slot_count - 1)));
+        }
+
+        void signal(std::atomic<std::uint32_t> &word, const std::atomic<std::uint32_t> &waiters)
+        {
+            word.fetch_add(1, std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_seq_cst) != 0)
+            {
+                platform::wake_address(word);
+            }
+        }
+
+        /// @brief 等待 ready() 成立；give_up() 成立时返回 false
+        template <typename Ready, typename GiveUp>
+        bool await(std::atomic<std::uint32_t> &word, std::atomic<std::uint32_t> &waiters, Ready ready, GiveUp give_up)
+        {
+            for (int spin = 0; spin < SPIN_LIMIT; ++spin)
+            {
+                if (ready())
+                {
+                    return true;
+                }
+                std::this_thread::yield();
+            }
+
+            while (!ready())
+            {
+                if (give_up())
+                {
+                    return false;
+                }
+                waiters.fetch_add(1, std::memory_order_seq_cst);
+                const std::uint32_t observed = word.load(std::memory_order_seq_cst);
+                if (!ready())
+                {
+                    platform::wait_on_address(word, observed, WAIT_TIMEOUT_MS);
+                }
+                waiters.fetch_sub(1, std::memory_order_seq_cst);
+            }
+            return true;
+        }
+    }
+
+    std::string key_ring_name(std::string_view base, std::string_view profile)
+    {
+        std::string name("/");
+        name.append(base);
+        name.push_back('.');
+        name.append(profile);
+        return name;
+    }
+
+    KeyRingProducer::KeyRingProducer(const std::string &name, std::size_t slots, std::chrono::milliseconds abandon_timeout)
+        : abandon_timeout_(abandon_timeout)
+    {
+        const std::size_t count = std::bit_ceil(std::clamp<std::size_t>(slots, 2, MAX_SLOTS));
+        region_ = platform::SharedMemory::create(name, region_size(count));
+
+        auto *header = new (region_.bytes().data()) RingHeader{};
+        std::memcpy(header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+        header->slot_count = static_cast<std::uint32_t>(count);
+        header->slot_bytes = static_cast<std::uint32_t>(KEY_RING_SLOT_BYTES);
+
+        auto *slot = reinterpret_cast<RingSlot *>(region_.bytes().data() + sizeof(RingHeader));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            new (slot + i) RingSlot{};
+            slot[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    KeyRingProducer::~KeyRingProducer()
+    {
+        close();
+
+        // 尚未被领取的密钥随区域一同清零
+        const auto bytes = region_.bytes();
+        if (!bytes.empty())
+        {
+            std::memset(bytes.data() + sizeof(RingHeader), 0, bytes.size() - sizeof(RingHeader));
+        }
+    }
+
+    bool KeyRingProducer::publish(std::string_view key, const std::atomic<bool> &stop)
+    {
+        if (key.size() > KEY_RING_SLOT_BYTES)
+        {
+            throw std::runtime_error("error_ring_key_size");
+        }
+
+        RingHeader &header = header_of(region_);
+        RingSlot &slot = slot_of(region_, next_ticket_);
+        const std::uint64_t ticket = next_ticket_;
+
+        // 上一圈在此槽位发布的密钥若一直无人锁定，说明持票的消费方已退出（如等待中被 Ctrl-C）：
+        // 超时后由生产端收回并清零，否则该槽位永远不会释放，整个环随之停滞
+        const bool lapped = ticket >= header.slot_count;
+        const std::uint64_t abandoned = ticket - header.slot_count + 1;
+        auto deadline = std::chrono::steady_clock::now() + abandon_timeout_;
+        for (;;)
+        {
+            const bool free = await(
+                header.space_signal,
+                header.space_waiters,
+                [&] { return slot.sequence.load(std::memory_order_acquire) == ticket; },
+                [&] {
+                    return stop.load(std::memory_order_relaxed) ||
+                           (lapped && std::chrono::steady_clock::now() >= deadline &&
+                            slot.sequence.load(std::memory_order_acquire) == abandoned);
+                });
+            if (free)
+            {
+                break;
+            }
+            if (stop.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+
+            // 与迟到的消费方竞争同一次锁定：CAS 失败说明对方仍然存活并已取走，继续等待其释放
+            std::uint64_t expected = abandoned;
+            if (slot.sequence.compare_exchange_strong(expected, abandoned | SLOT_BUSY, std::memory_order_acq_rel))
+            {
+                std::memset(slot.bytes, 0, slot.length);
+                slot.length = 0;
+                ++reclaimed_;
+                break;
+            }
+            deadline = std::chrono::steady_clock::now() + abandon_timeout_;
+        }
+
+        std::memcpy(slot.bytes, key.data(), key.size());
+        slot.length = static_cast<std::uint32_t>(key.size());
+        slot.sequence.store(ticket + 1, std::memory_order_seq_cst);
+        ++next_ticket_;
+
+        signal(header.data_signal, header.data_waiters);
+        return true;
+    }
+
+    void KeyRingProducer::close() noexcept
+    {
+        if (region_.bytes().empty())
+        {
+            return;
+        }
+        RingHeader &header = header_of(region_);
+        header.closed.store(1, std::memory_order_seq_cst);
+        header.data_signal.fetch_add(1, std::memory_order_seq_cst);
+        platform::wake_address(header.data_signal);
+    }
+
+    std::size_t KeyRingProducer::slots() const noexcept
+    {
+        return header_of(region_).slot_count;
+    }
+
+    std::uint64_t KeyRingProducer::reclaimed() const noexcept
+    {
+        return reclaimed_;
+    }
+
+    KeyRingClient::KeyRingClient(const std::string &name) : region_(platform::SharedMemory::open(name))
+    {
+        const auto bytes = region_.bytes();
+        if (bytes.size() < sizeof(RingHeader))
+        {
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+
+        const RingHeader &header = header_of(region_);
+        const bool valid = std::memcmp(header.magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0 &&
+                           header.slot_bytes == KEY_RING_SLOT_BYTES &&
+                           std::has_single_bit(header.slot_count) &&
+                           bytes.size() >= region_size(header.slot_count);
+        if (!valid)
+        {
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+    }
+
+    std::size_t KeyRingClient::claim(char *buffer, std::size_t capacity)
+    {
+        RingHeader &header = header_of(region_);
+        for (;;)
+        {
+            const std::uint64_t ticket = header.claim_ticket.fetch_add(1, std::memory_order_relaxed);
+            RingSlot &slot = slot_of(region_, ticket);
+
+            // 序号越过本票号说明生产端已判定本票号被放弃并收回了槽位（本进程曾长时间挂起），换一张票重试
+            const bool ready = await(
+                header.data_signal,
+                header.data_waiters,
+                [&] {
+                    const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                    return sequence == ticket + 1 || (sequence & ~SLOT_BUSY) > ticket + 1;
+                },
+                [&] { return header.closed.load(std::memory_order_acquire) != 0; });
+            if (!ready)
+            {
+                throw std::runtime_error("error_ring_closed");
+            }
+
+            std::uint64_t expected = ticket + 1;
+            if (!slot.sequence.compare_exchange_strong(expected, (ticket + 1) | SLOT_BUSY, std::memory_order_acq_rel))
+            {
+                continue;
+            }
+
+            const std::size_t length = std::min<std::size_t>(slot.length, capacity);
+            std::memcpy(buffer, slot.bytes, length);
+            std::memset(slot.bytes, 0, slot.length);
+            slot.length = 0;
+            slot.sequence.store(ticket + header.slot_count, std::memory_order_seq_cst);
+
+            signal(header.space_signal, header.space_waiters);
+            return length;
+        }
+    }
+
+    std::string KeyRingClient::claim()
+    {
+        std::string key(KEY_RING_SLOT_BYTES, '\0');
+        key.resize(claim(key.data(), key.size()));
+        return key;
+    }
+}
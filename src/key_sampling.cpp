@@ -0,0 +1,83 @@
+#include "randkey/key_sampling.hpp"
+
+namespace randkey::sampling
+{
+    std::size_t random_bytes_for(std::size_t count, unsigned bits)
+    {
+        switch (bits)
+        {
+        case 4:
+            return (count + 1) / 2;
+        case 5:
+            return (count + 7) / 8 * 5;
+        case 6:
+            return (count + 3) / 4 * 3;
+        case 8:
+            return count;
+        default:
+            return (count * bits + 7) / 8 + 2;
+        }
+    }
+
+    void extract_indices(const unsigned char *src, unsigned bits, std::size_t count, std::uint32_t *out)
+    {
+        switch (bits)
+        {
+        case 4:
+            for (std::size_t g = 0; g < (count + 1) / 2; ++g)
+            {
+                out[g * 2] = src[g] >> 4U;
+                out[g * 2 + 1] = src[g] & 0x0FU;
+            }
+            return;
+        case 5:
+            for (std::size_t g = 0; g < (count + 7) / 8; ++g)
+            {
+                const unsigned char *b = src + g * 5;
+                const std::uint64_t group = (static_cast<std::uint64_t>(b[0]) << 32U) |
+                                            (static_cast<std::uint64_t>(b[1]) << 24U) |
+                                            (static_cast<std::uint64_t>(b[2]) << 16U) |
+                                            (static_cast<std::uint64_t>(b[3]) << 8U) |
+                                            static_cast<std::uint64_t>(b[4]);
+                for (std::size_t i = 0; i < 8; ++i)
+                {
+                    out[g * 8 + i] = static_cast<std::uint32_t>((group >> (35U - i * 5U)) & 0x1FU);
+                }
+            }
+            return;
+        case 6:
+            for (std::size_t g = 0; g < (count + 3) / 4; ++g)
+            {
+                const unsigned char *b = src + g * 3;
+                const std::uint32_t group = (static_cast<std::uint32_t>(b[0]) << 16U) |
+                                            (static_cast<std::uint32_t>(b[1]) << 8U) |
+                                            static_cast<std::uint32_t>(b[2]);
+                out[g * 4] = (group >> 18U) & 0x3FU;
+                out[g * 4 + 1] = (group >> 12U) & 0x3FU;
+                out[g * 4 + 2] = (group >> 6U) & 0x3FU;
+                out[g * 4 + 3] = group & 0x3FU;
+            }
+            return;
+        case 8:
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = src[i];
+            }
+            return;
+        default:
+        {
+            const std::uint32_t mask = (1U << bits) - 1U;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::size_t bit = i * bits;
+                const unsigned char *b = src + bit / 8;
+                const std::uint32_t window = (static_cast<std::uint32_t>(b[0]) << 16U) |
+                                             (static_cast<std::uint32_t>(b[1]) << 8U) |
+                                             static_cast<std::uint32_t>(b[2]);
+                out[i] = (window >> (24U - (bit % 8) - bits)) & mask;
+            }
+            return;
+        }
+        }
+    }
+}
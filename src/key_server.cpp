@@ -0,0 +1,417 @@
+#include "randkey/key_server.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::string_view DEFAULT_PROFILE = "default";
+
+        constexpr char STATUS_OK = '\0';
+        constexpr char STATUS_ERROR = '\1';
+
+        /// @brief 后台每批生成的上限，兼顾批量摊销与取用延迟
+        constexpr std::size_t MAX_REFILL_BATCH = 4096;
+
+        /// @brief 命中排除索引时单个密钥的最大重新生成次数，与批量生成一致
+        constexpr std::size_t EXCLUDE_MAX_ATTEMPTS = 1024;
+
+        /// @brief 每次从预取池搬到共享内存环的密钥数
+        constexpr std::size_t RING_FEED_BATCH = 256;
+
+        /// @brief 排除文件由池自行打开，其余选项交给 KeyPlan 编译
+        KeyPlan compile_pool_plan(GenerationOptions options)
+        {
+            options.exclude_file.reset();
+            return KeyPlan::compile(options);
+        }
+
+        std::string error_response(std::string_view key)
+        {
+            std::string response(1, STATUS_ERROR);
+            response.append(key);
+            return response;
+        }
+    }
+
+    ServeProfile parse_serve_profile(std::string_view line)
+    {
+        std::istringstream fields{std::string(line)};
+        std::vector<std::string> tokens;
+        for (std::string token; fields >> token;)
+        {
+            tokens.push_back(std::move(token));
+        }
+        if (tokens.empty())
+        {
+            throw std::runtime_error("error_serve_profile");
+        }
+
+        std::vector<const char *> argv{"randkey"};
+        for (std::size_t i = 1; i < tokens.size(); ++i)
+        {
+            argv.push_back(tokens[i].c_str());
+        }
+
+        const ParsedArguments parsed = ArgumentParser().parse(static_cast<int>(argv.size()), argv.data());
+        const GenerationOptions &options = parsed.options;
+
+        // 确定性种子会让每批重复同样的密钥；--unique 无法在无限的密钥流上兑现；其余选项依赖单次批次语义或文件输出
+        const bool unsuitable = parsed.deterministic_seed.has_value() || parsed.mixing_seed.has_value() ||
+                                options.unique || parsed.resume || parsed.shard.has_value() || options.start_index != 0 ||
+                                options.target != OutputTarget::Stdout || options.sorted ||
+                                options.checkpoint_interval != 0 || options.emit_hash != KeyHashAlgorithm::None ||
+                                !options.tee_targets.empty() || options.trace_path.has_value() ||
+                                (options.raw_bytes > 0 && options.raw_encoding == BinaryEncoding::Binary);
+        if (unsuitable)
+        {
+            throw std::runtime_error("error_serve_profile:" + tokens[0]);
+        }
+
+        return ServeProfile{tokens[0], options};
+    }
+
+    std::vector<ServeProfile> load_serve_profiles(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("error_serve_profile:" + path.string());
+        }
+
+        std::vector<ServeProfile> profiles;
+        for (std::string line; std::getline(file, line);)
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            const auto first = line.find_first_not_of(" \t");
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+            profiles.push_back(parse_serve_profile(std::string_view(line).substr(first)));
+        }
+        return profiles;
+    }
+
+    KeyPool::KeyPool(const GenerationOptions &options, std::size_t capacity)
+        : plan_(compile_pool_plan(options)),
+          capacity_(std::max<std::size_t>(1, capacity)),
+          batch_(std::clamp<std::size_t>(capacity_ / 4, 1, MAX_REFILL_BATCH))
+    {
+        if (options.exclude_file.has_value())
+        {
+            excluded_.emplace(ExclusionIndex::open(options.exclude_file.value()));
+        }
+        filler_ = std::thread([this] { fill_loop(); });
+    }
+
+    KeyPool::~KeyPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+        filler_.join();
+
+        for (auto &chunk : chunks_)
+        {
+            std::fill(chunk.begin(), chunk.end(), '\0');
+        }
+    }
+
+    void KeyPool::take(std::size_t count, std::string &out)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (count > 0)
+        {
+            not_empty_.wait(lock, [&] { return ready_ > 0 || failure_ || stopping_; });
+            if (failure_)
+            {
+                std::rethrow_exception(failure_);
+            }
+            if (ready_ == 0)
+            {
+                throw std::runtime_error("error_serve_stopped");
+            }
+
+            std::string &chunk = chunks_.front();
+            std::size_t end = front_offset_;
+            std::size_t taken = 0;
+            while (taken < count && end < chunk.size())
+            {
+                const void *newline = std::memchr(chunk.data() + end, '\n', chunk.size() - end);
+                end = newline ? static_cast<std::size_t>(static_cast<const char *>(newline) - chunk.data()) + 1 : chunk.size();
+                ++taken;
+            }
+
+            out.append(chunk, front_offset_, end - front_offset_);
+            std::fill(chunk.begin() + static_cast<std::ptrdiff_t>(front_offset_),
+                      chunk.begin() + static_cast<std::ptrdiff_t>(end), '\0');
+            front_offset_ = end;
+            ready_ -= taken;
+            count -= taken;
+
+            if (front_offset_ == chunk.size())
+            {
+                chunks_.pop_front();
+                front_offset_ = 0;
+            }
+            not_full_.notify_one();
+        }
+    }
+
+    std::size_t KeyPool::ready() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ready_;
+    }
+
+    void KeyPool::fill_loop()
+    {
+        KeyEngine engine;
+        std::string key(plan_.max_key_bytes(), '\0');
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_full_.wait(lock, [&] { return stopping_ || ready_ + batch_ <= capacity_ || ready_ == 0; });
+                if (stopping_)
+                {
+                    return;
+                }
+            }
+
+            // 生成在锁外进行，取用方可并发消费已就绪的批次
+            std::string chunk;
+            try
+            {
+                chunk.reserve(batch_ * (key.size() + 1));
+                for (std::size_t i = 0; i < batch_; ++i)
+                {
+                    std::size_t length = plan_.generate_into(engine, key.data(), key.size());
+                    for (std::size_t attempt = 1; excluded_ && excluded_->contains(std::string_view(key.data(), length)); ++attempt)
+                    {
+                        if (attempt == EXCLUDE_MAX_ATTEMPTS)
+                        {
+                            throw std::runtime_error("error_unique_exhausted");
+                        }
+                        length = plan_.generate_into(engine, key.data(), key.size());
+                    }
+                    chunk.append(key.data(), length);
+                    chunk.push_back('\n');
+                }
+            }
+            catch (...)
+            {
+                std::fill(key.begin(), key.end(), '\0');
+                std::fill(chunk.begin(), chunk.end(), '\0');
+                std::lock_guard<std::mutex> lock(mutex_);
+                failure_ = std::current_exception();
+                not_empty_.notify_all();
+                return;
+            }
+
+            std::fill(key.begin(), key.end(), '\0');
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                chunks_.push_back(std::move(chunk));
+                ready_ += batch_;
+            }
+            not_empty_.notify_all();
+        }
+    }
+
+    KeyServer::KeyServer(const std::vector<ServeProfile> &profiles, std::size_t pool_capacity)
+    {
+        pools_.emplace(std::string(DEFAULT_PROFILE), nullptr);
+        for (const auto &profile : profiles)
+        {
+            pools_[profile.name] = std::make_unique<KeyPool>(profile.options, pool_capacity);
+        }
+        if (!pools_[std::string(DEFAULT_PROFILE)])
+        {
+            pools_[std::string(DEFAULT_PROFILE)] = std::make_unique<KeyPool>(GenerationOptions{}, pool_capacity);
+        }
+    }
+
+    std::string KeyServer::handle(std::string_view request)
+    {
+        if (request.size() < 4)
+        {
+            return error_response("error_serve_request");
+        }
+
+        std::uint32_t count = 0;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            count |= static_cast<std::uint32_t>(static_cast<unsigned char>(request[i])) << (8U * i);
+        }
+        std::string_view name = request.substr(4);
+        if (name.empty())
+        {
+            name = DEFAULT_PROFILE;
+        }
+        if (count == 0 || count > MAX_BATCH)
+        {
+            return error_response("error_serve_request");
+        }
+
+        const auto pool = pools_.find(std::string(name));
+        if (pool == pools_.end())
+        {
+            return error_response("error_serve_profile");
+        }
+
+        std::string response(1, STATUS_OK);
+        try
+        {
+            pool->second->take(count, response);
+        }
+        catch (const std::exception &ex)
+        {
+            std::fill(response.begin(), response.end(), '\0');
+            return error_response(ex.what());
+        }
+        return response;
+    }
+
+    std::string KeyServer::encode_request(std::string_view profile, std::uint32_t count)
+    {
+        std::string request(4, '\0');
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            request[i] = static_cast<char>((count >> (8U * i)) & 0xFFU);
+        }
+        request.append(profile);
+        return request;
+    }
+
+    std::vector<std::string> KeyServer::profile_names() const
+    {
+        std::vector<std::string> names;
+        names.reserve(pools_.size());
+        for (const auto &entry : pools_)
+        {
+            names.push_back(entry.first);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    KeyPool &KeyServer::pool(const std::string &profile)
+    {
+        return *pools_.at(profile);
+    }
+
+    KeyRingFeeder::KeyRingFeeder(KeyPool &pool, const std::string &ring_name, std::size_t slots)
+        : pool_(pool), ring_(ring_name, slots)
+    {
+        worker_ = std::thread([this] { feed_loop(); });
+    }
+
+    KeyRingFeeder::~KeyRingFeeder()
+    {
+        stop_.store(true);
+        worker_.join();
+    }
+
+    void KeyRingFeeder::feed_loop()
+    {
+        std::string batch;
+        try
+        {
+            while (!stop_.load(std::memory_order_relaxed))
+            {
+                pool_.take(RING_FEED_BATCH, batch);
+
+                std::size_t begin = 0;
+                bool published = true;
+                while (published && begin < batch.size())
+                {
+                    const std::size_t end = batch.find('\n', begin);
+                    published = ring_.publish(std::string_view(batch).substr(begin, end - begin), stop_);
+                    begin = end + 1;
+                }
+                std::fill(batch.begin(), batch.end(), '\0');
+                batch.clear();
+            }
+        }
+        catch (const std::exception &)
+        {
+            // 生成失败或密钥超出槽位：关闭环，让等待中的消费方尽快得到错误
+            std::fill(batch.begin(), batch.end(), '\0');
+        }
+        ring_.close();
+    }
+
+    ServeArguments parse_serve_arguments(const std::vector<std::string> &args)
+    {
+        ServeArguments result;
+        bool has_socket = false;
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            const std::string &flag = args[i];
+            auto value = [&]() -> const std::string & {
+                if (i + 1 >= args.size())
+                {
+                    throw std::runtime_error("error_missing_arg:" + flag);
+                }
+                return args[++i];
+            };
+
+            if (flag == "--socket")
+            {
+                result.socket = std::filesystem::path(value());
+                has_socket = true;
+            }
+            else if (flag == "--profiles")
+            {
+                result.profiles = std::filesystem::path(value());
+            }
+            else if (flag == "--shm")
+            {
+                const std::string &name = value();
+                if (name.empty() || name.find('/') != std::string::npos)
+                {
+                    throw std::runtime_error("error_ring_name:" + name);
+                }
+                result.shm = name;
+            }
+            else if (flag == "--pool")
+            {
+                const std::string &text = value();
+                std::size_t parsed = 0;
+                const bool digits = !text.empty() && std::all_of(text.begin(), text.end(), [](char ch) { return ch >= '0' && ch <= '9'; });
+                if (digits && text.size() < 19)
+                {
+                    parsed = static_cast<std::size_t>(std::stoull(text));
+                }
+                if (parsed == 0)
+                {
+                    throw std::runtime_error("error_serve_pool");
+                }
+                result.pool = parsed;
+            }
+            else
+            {
+                throw std::runtime_error("error_unknown_flag:" + flag);
+            }
+        }
+
+        if (!has_socket)
+        {
+            throw std::runtime_error("error_serve_usage");
+        }
+        return result;
+    }
+}
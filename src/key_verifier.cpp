@@ -0,0 +1,398 @@
+#include "randkey/key_verifier.hpp"
+
+#include "randkey/platform/mapped_file.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANDKEY_VERIFY_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::size_t BLOCK_BYTES = 64;
+
+        /// @brief 严格 UTF-8 解码一个码点（拒绝超长编码、代理项与越界值），失败返回 false
+        bool decode_utf8(std::string_view text, std::size_t &position, char32_t &out) noexcept
+        {
+            const auto lead = static_cast<unsigned char>(text[position]);
+            std::size_t extra = 0;
+            char32_t minimum = 0;
+            if (lead < 0x80)
+            {
+                out = lead;
+                ++position;
+                return true;
+            }
+            if ((lead & 0xE0U) == 0xC0U)
+            {
+                extra = 1;
+                minimum = 0x80;
+                out = lead & 0x1FU;
+            }
+            else if ((lead & 0xF0U) == 0xE0U)
+            {
+                extra = 2;
+                minimum = 0x800;
+                out = lead & 0x0FU;
+            }
+            else if ((lead & 0xF8U) == 0xF0U)
+            {
+                extra = 3;
+                minimum = 0x10000;
+                out = lead & 0x07U;
+            }
+            else
+            {
+                return false;
+            }
+
+            if (position + extra >= text.size())
+            {
+                return false;
+            }
+            for (std::size_t i = 1; i <= extra; ++i)
+            {
+                const auto next = static_cast<unsigned char>(text[position + i]);
+                if ((next & 0xC0U) != 0x80U)
+                {
+                    return false;
+                }
+                out = (out << 6U) | (next & 0x3FU);
+            }
+            if (out < minimum || out > 0x10FFFF || (out >= 0xD800 && out <= 0xDFFF))
+            {
+                return false;
+            }
+            position += extra + 1;
+            return true;
+        }
+
+        /// @brief 标量版块扫描：bad 标记非 ASCII 成员字节，newline 标记 '\n'
+        void scan_block_scalar(const unsigned char *block,
+                               const std::array<std::uint8_t, 16> &rows,
+                               std::uint64_t &bad,
+                               std::uint64_t &newline) noexcept
+        {
+            bad = 0;
+            newline = 0;
+            for (std::size_t i = 0; i < BLOCK_BYTES; ++i)
+            {
+                const unsigned char byte = block[i];
+                const bool member = byte < 0x80 && ((rows[byte & 0x0FU] >> (byte >> 4U)) & 1U) != 0;
+                bad |= static_cast<std::uint64_t>(!member) << i;
+                newline |= static_cast<std::uint64_t>(byte == '\n') << i;
+            }
+        }
+
+#if defined(RANDKEY_VERIFY_AVX2)
+        /// @brief AVX2 版块扫描：低 4 位查行表、高 4 位查位选择表（非 ASCII 得 0），两者相与即成员判定
+        __attribute__((target("avx2"))) void scan_block_avx2(const unsigned char *block,
+                                                             const std::array<std::uint8_t, 16> &rows,
+                                                             std::uint64_t &bad,
+                                                             std::uint64_t &newline) noexcept
+        {
+            const __m128i row_table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.data()));
+            const __m256i rows256 = _mm256_broadcastsi128_si256(row_table);
+            const __m256i high_bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                       1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i low_mask = _mm256_set1_epi8(0x0F);
+            const __m256i line_feed = _mm256_set1_epi8('\n');
+            const __m256i zero = _mm256_setzero_si256();
+
+            std::uint64_t masks[2][2]{};
+            for (std::size_t half = 0; half < 2; ++half)
+            {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + half * 32));
+                const __m256i low = _mm256_and_si256(bytes, low_mask);
+                const __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_mask);
+                const __m256i row = _mm256_shuffle_epi8(rows256, low);
+                const __m256i select = _mm256_shuffle_epi8(high_bits, high);
+                const __m256i outside = _mm256_cmpeq_epi8(_mm256_and_si256(row, select), zero);
+                masks[half][0] = static_cast<std::uint32_t>(_mm256_movemask_epi8(outside));
+                masks[half][1] = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, line_feed)));
+            }
+            bad = masks[0][0] | (masks[1][0] << 32U);
+            newline = masks[0][1] | (masks[1][1] << 32U);
+        }
+
+        bool has_avx2() noexcept
+        {
+            static const bool supported = __builtin_cpu_supports("avx2");
+            return supported;
+        }
+#endif
+
+        void scan_block(const unsigned char *block,
+                        const std::array<std::uint8_t, 16> &rows,
+                        std::uint64_t &bad,
+                        std::uint64_t &newline) noexcept
+        {
+#if defined(RANDKEY_VERIFY_AVX2)
+            if (has_avx2())
+            {
+                scan_block_avx2(block, rows, bad, newline);
+                return;
+            }
+#endif
+            scan_block_scalar(block, rows, bad, newline);
+        }
+    }
+
+    KeyPolicy KeyPolicy::from_options(const GenerationOptions &options, bool check_length)
+    {
+        if (options.raw_bytes > 0 || options.id_format != IdFormat::None || options.pattern.has_value() ||
+            options.passphrase_wordlist.has_value())
+        {
+            throw std::runtime_error("error_verify_mode");
+        }
+
+        KeyPolicy policy;
+        const auto charset = options.registry.compile();
+        for (const auto &token : charset->tokens)
+        {
+            if (token.size() != 1)
+            {
+                throw std::runtime_error("error_verify_tokens");
+            }
+            policy.members_.set(token[0]);
+        }
+        for (char32_t ch = 0; ch < 0x80; ++ch)
+        {
+            if (policy.members_.test(ch))
+            {
+                policy.ascii_rows_[ch & 0x0FU] |= static_cast<std::uint8_t>(1U << (ch >> 4U));
+            }
+        }
+
+        if (check_length)
+        {
+            policy.length_ = options.length;
+        }
+
+        policy.required_ = options.required_classes;
+        for (std::size_t c = 0; c < policy.required_.size(); ++c)
+        {
+            const CharsetBitmap &bits = CharsetRegistry::builtin_bitmap(policy.required_[c]);
+            for (char32_t ch = 0; ch < 0x80; ++ch)
+            {
+                if (bits.test(ch))
+                {
+                    policy.ascii_classes_[ch] |= 1U << c;
+                }
+            }
+        }
+        return policy;
+    }
+
+    std::optional<KeyViolation> KeyPolicy::check(std::string_view key) const
+    {
+        if (key.empty())
+        {
+            return KeyViolation{0, ViolationKind::Empty, 0};
+        }
+
+        std::optional<KeyViolation> charset;
+        std::uint64_t length = 0;
+        std::uint32_t classes = 0;
+        std::size_t position = 0;
+        while (position < key.size())
+        {
+            char32_t ch = 0;
+            if (!decode_utf8(key, position, ch))
+            {
+                return KeyViolation{0, ViolationKind::Encoding, length + 1};
+            }
+            ++length;
+            if (!charset.has_value() && !members_.test(ch))
+            {
+                charset = KeyViolation{0, ViolationKind::Charset, length};
+            }
+            for (std::size_t c = 0; c < required_.size(); ++c)
+            {
+                if (CharsetRegistry::builtin_bitmap(required_[c]).test(ch))
+                {
+                    classes |= 1U << c;
+                }
+            }
+        }
+
+        if (charset.has_value())
+        {
+            return charset;
+        }
+        if (length_.has_value() && length != length_.value())
+        {
+            return KeyViolation{0, ViolationKind::Length, length};
+        }
+        if (classes != (std::uint32_t{1} << required_.size()) - 1U)
+        {
+            return KeyViolation{0, ViolationKind::Required, 0};
+        }
+        return std::nullopt;
+    }
+
+    std::optional<KeyViolation> KeyPolicy::check_ascii(std::string_view key) const
+    {
+        if (key.empty())
+        {
+            return KeyViolation{0, ViolationKind::Empty, 0};
+        }
+        if (length_.has_value() && key.size() != length_.value())
+        {
+            return KeyViolation{0, ViolationKind::Length, key.size()};
+        }
+        if (!required_.empty())
+        {
+            std::uint32_t classes = 0;
+            for (char ch : key)
+            {
+                classes |= ascii_classes_[static_cast<unsigned char>(ch)];
+            }
+            if (classes != (std::uint32_t{1} << required_.size()) - 1U)
+            {
+                return KeyViolation{0, ViolationKind::Required, 0};
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<KeyViolation> KeyPolicy::check_line(std::string_view line, bool ascii_members) const
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        return ascii_members ? check_ascii(line) : check(line);
+    }
+
+    VerifyReport KeyPolicy::verify(std::span<const std::byte> data,
+                                   const std::function<void(const KeyViolation &)> &on_violation) const
+    {
+        const auto *bytes = reinterpret_cast<const unsigned char *>(data.data());
+        const std::size_t size = data.size();
+        VerifyReport report;
+
+        std::size_t line_start = 0;
+        // 当前行内非成员字节的数量与最后位置；仅有一个且为行尾 '\r' 时仍走快速路径
+        std::uint64_t line_bad = 0;
+        std::size_t last_bad = 0;
+
+        auto finish_line = [&](std::size_t end) {
+            const std::string_view line(reinterpret_cast<const char *>(bytes) + line_start, end - line_start);
+            const bool ascii_members = line_bad == 0 || (line_bad == 1 && last_bad == end - 1 && line.back() == '\r');
+            ++report.keys;
+            if (auto violation = check_line(line, ascii_members))
+            {
+                violation->line = report.keys;
+                ++report.violations;
+                on_violation(*violation);
+            }
+            line_start = end + 1;
+            line_bad = 0;
+        };
+
+        auto consume = [&](std::size_t base, std::uint64_t bad, std::uint64_t newline) {
+            bad &= ~newline;
+            while (newline != 0)
+            {
+                const auto offset = static_cast<unsigned>(std::countr_zero(newline));
+                const std::uint64_t before = bad & ((std::uint64_t{1} << offset) - 1U);
+                if (before != 0)
+                {
+                    line_bad += static_cast<std::uint64_t>(std::popcount(before));
+                    last_bad = base + 63U - static_cast<unsigned>(std::countl_zero(before));
+                    bad &= ~before;
+                }
+                finish_line(base + offset);
+                newline &= newline - 1U;
+            }
+            if (bad != 0)
+            {
+                line_bad += static_cast<std::uint64_t>(std::popcount(bad));
+                last_bad = base + 63U - static_cast<unsigned>(std::countl_zero(bad));
+            }
+        };
+
+        std::size_t base = 0;
+        for (; base + BLOCK_BYTES <= size; base += BLOCK_BYTES)
+        {
+            std::uint64_t bad = 0;
+            std::uint64_t newline = 0;
+            scan_block(bytes + base, ascii_rows_, bad, newline);
+            consume(base, bad, newline);
+        }
+        if (base < size)
+        {
+            unsigned char tail[BLOCK_BYTES]{};
+            const std::size_t remaining = size - base;
+            std::memcpy(tail, bytes + base, remaining);
+            std::uint64_t bad = 0;
+            std::uint64_t newline = 0;
+            scan_block(tail, ascii_rows_, bad, newline);
+            const std::uint64_t valid = (std::uint64_t{1} << remaining) - 1U;
+            consume(base, bad & valid, newline & valid);
+        }
+
+        // 末行没有换行符
+        if (line_start < size)
+        {
+            finish_line(size);
+        }
+        return report;
+    }
+
+    VerifyArguments parse_verify_arguments(const std::vector<std::string> &args)
+    {
+        VerifyArguments result;
+        bool has_input = false;
+        std::vector<const char *> argv{"randkey"};
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            if (args[i] == "--input")
+            {
+                if (i + 1 >= args.size())
+                {
+                    throw std::runtime_error("error_verify_usage");
+                }
+                const std::string &value = args[++i];
+                result.input = std::filesystem::path(std::u8string(value.begin(), value.end()));
+                has_input = true;
+                continue;
+            }
+            if (args[i] == "-l" || args[i] == "--length")
+            {
+                result.check_length = true;
+            }
+            argv.push_back(args[i].c_str());
+        }
+        if (!has_input)
+        {
+            throw std::runtime_error("error_verify_usage");
+        }
+
+        result.policy = ArgumentParser().parse(static_cast<int>(argv.size()), argv.data());
+        return result;
+    }
+
+    VerifyReport verify_file(const std::filesystem::path &input,
+                             const KeyPolicy &policy,
+                             const std::function<void(const KeyViolation &)> &on_violation)
+    {
+        platform::MappedFile file;
+        try
+        {
+            file = platform::MappedFile::open(input);
+        }
+        catch (const std::exception &)
+        {
+            throw std::runtime_error("error_verify_input:" + input.string());
+        }
+        return policy.verify(file.bytes(), on_violation);
+    }
+}
@@ -1,20 +1,130 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "randkey/batch.hpp"
+#include "randkey/checkpoint.hpp"
 #include "randkey/encoding.hpp"
 #include "randkey/generator.hpp"
 #include "randkey/i18n/messages.hpp"
+#include "randkey/key_server.hpp"
+#include "randkey/key_verifier.hpp"
 #include "randkey/options.hpp"
+#include "randkey/output_tee.hpp"
+#include "randkey/output_writer.hpp"
+#include "randkey/platform/file_sync.hpp"
 #include "randkey/platform/language.hpp"
+#include "randkey/platform/local_socket.hpp"
+#include "randkey/platform/resource_usage.hpp"
+#include "randkey/run_stats.hpp"
+#include "randkey/trace.hpp"
 
 namespace randkey
 {
     namespace
     {
+        std::atomic<bool> serve_stop{false};
+
+        void request_serve_stop(int)
+        {
+            serve_stop.store(true);
+        }
+
+        /// @brief `randkey serve`：加载配置、启动预取池，在本地套接字上提供密钥直到收到中断信号
+        void run_serve(const std::vector<std::string> &args)
+        {
+            const ServeArguments serve = parse_serve_arguments(args);
+            const std::vector<ServeProfile> profiles =
+                serve.profiles.has_value() ? load_serve_profiles(serve.profiles.value()) : std::vector<ServeProfile>{};
+            KeyServer server(profiles, serve.pool);
+
+            // 环的槽位数与预取池一致；feeder 先于 server 析构
+            std::vector<std::unique_ptr<KeyRingFeeder>> feeders;
+            if (serve.shm.has_value())
+            {
+                for (const auto &name : server.profile_names())
+                {
+                    feeders.push_back(std::make_unique<KeyRingFeeder>(server.pool(name),
+                                                                      key_ring_name(serve.shm.value(), name),
+                                                                      serve.pool));
+                }
+            }
+
+            std::signal(SIGINT, request_serve_stop);
+            std::signal(SIGTERM, request_serve_stop);
+            platform::serve_local_socket(serve.socket,
+                                         [&](std::string_view request) { return server.handle(request); },
+                                         serve_stop);
+        }
+
+        /// @brief 续写：校验断点属于同一任务，截断输出文件并把生成区间推进到断点下标
+        void resume_from_checkpoint(const ParsedArguments &args,
+                                    const std::filesystem::path &checkpoint_path,
+                                    GenerationOptions &options,
+                                    RunningDigest &digest)
+        {
+            // 上次在保存断点途中被终止时会留下临时文件，它从未生效，直接丢弃
+            std::error_code ec;
+            std::filesystem::remove(Checkpoint::temp_path_for(checkpoint_path), ec);
+
+            const Checkpoint checkpoint = Checkpoint::load(checkpoint_path);
+            const auto &output = options.output_path.value();
+            const std::uint64_t first = static_cast<std::uint64_t>(options.start_index);
+            const std::uint64_t end = first + static_cast<std::uint64_t>(options.count);
+            if (checkpoint.config != args.config_fingerprint ||
+                checkpoint.deterministic_seed != args.deterministic_seed ||
+                checkpoint.next_index < first || checkpoint.next_index > end)
+            {
+                throw std::runtime_error("error_checkpoint_mismatch:" + output.string());
+            }
+
+            truncate_to_checkpoint(output, checkpoint, digest);
+            options.start_index = static_cast<std::size_t>(checkpoint.next_index);
+            options.count = static_cast<std::size_t>(end - checkpoint.next_index);
+        }
+
+        /// @brief 参数解析阶段就会加载字符集与词表文件，因此按原始参数在解析之前开始记录
+        void maybe_start_trace(int argc, const char *const *argv)
+        {
+            for (int i = 1; i + 1 < argc; ++i)
+            {
+                if (std::string_view(argv[i]) == "--trace")
+                {
+                    trace::start();
+                    return;
+                }
+            }
+        }
+
+        void write_trace(const std::filesystem::path &path)
+        {
+            std::ofstream out(path, std::ios::binary);
+            if (!out)
+            {
+                throw std::runtime_error("error_write_file:" + path.string());
+            }
+            trace::write_chrome_trace(out);
+            if (!out)
+            {
+                throw std::runtime_error("error_write_file:" + path.string());
+            }
+        }
+
         std::string format_message(const i18n::Catalog &catalog,
                                    const std::string &lang,
                                    const std::string &code)
@@ -45,6 +155,68 @@ namespace randkey
             return result;
         }
 
+        /// @brief `randkey batch`：先解析全部作业，任一作业非法则整体不执行；运行失败的作业逐行报告
+        /// @return 全部成功返回 true
+        bool run_batch_file(const std::vector<std::string> &args, const i18n::Catalog &catalog, const std::string &lang)
+        {
+            const BatchArguments batch = parse_batch_arguments(args);
+            std::vector<BatchFailure> failures;
+            std::vector<BatchJob> jobs = load_batch_jobs(batch.jobs, failures);
+            if (failures.empty())
+            {
+                failures = run_batch(std::move(jobs), batch.threads).failures;
+            }
+            if (batch.trace.has_value())
+            {
+                write_trace(batch.trace.value());
+            }
+
+            for (const auto &failure : failures)
+            {
+                std::cerr << batch.jobs.string() << ':' << failure.line << ": "
+                          << format_message(catalog, lang, failure.error) << "\n";
+            }
+            return failures.empty();
+        }
+
+        /// @brief `randkey verify`：按生成参数推导的策略逐行校验密钥文件，违规行写到 stdout，汇总写到 stderr
+        /// @return 没有违规返回 true
+        bool run_verify(const std::vector<std::string> &args, const i18n::Catalog &catalog, const std::string &lang)
+        {
+            const VerifyArguments verify = parse_verify_arguments(args);
+            const KeyPolicy policy = KeyPolicy::from_options(verify.policy.options, verify.check_length);
+            const std::string prefix = verify.input.string() + ':';
+
+            OutputWriter writer(std::cout);
+            const VerifyReport report = verify_file(verify.input, policy, [&](const KeyViolation &violation) {
+                std::string code;
+                switch (violation.kind)
+                {
+                case ViolationKind::Empty:
+                    code = "verify_empty";
+                    break;
+                case ViolationKind::Encoding:
+                    code = "verify_encoding:" + std::to_string(violation.detail);
+                    break;
+                case ViolationKind::Charset:
+                    code = "verify_charset:" + std::to_string(violation.detail);
+                    break;
+                case ViolationKind::Length:
+                    code = "verify_length:" + std::to_string(violation.detail);
+                    break;
+                case ViolationKind::Required:
+                    code = "verify_required";
+                    break;
+                }
+                writer.write_line(prefix + std::to_string(violation.line) + ": " + format_message(catalog, lang, code));
+            });
+            writer.flush();
+
+            std::cerr << catalog.translate(lang, "info_verify_keys") << ' ' << report.keys << "\n"
+                      << catalog.translate(lang, "info_verify_violations") << ' ' << report.violations << "\n";
+            return report.violations == 0;
+        }
+
         void print_help(const i18n::Catalog &catalog, const std::string &lang)
         {
             std::cout << catalog.translate(lang, "help_title") << "\n";
@@ -52,34 +224,35 @@ namespace randkey
             std::cout << catalog.translate(lang, "help_options") << "\n";
         }
 
-        void write_output(const GenerationOptions &options,
-                          const GenerationOutcome &outcome)
+        /// @param append 续写模式：文件必须已存在，在末尾追加
+        template <typename Writer>
+        void with_output_stream(const GenerationOptions &options, bool append, Writer &&writer)
         {
             if (options.target == OutputTarget::Stdout)
             {
-                for (const auto &key : outcome.keys)
+#if defined(_WIN32)
+                if (options.raw_bytes > 0 && options.raw_encoding == BinaryEncoding::Binary)
                 {
-                    std::cout << utf32_to_locale(key) << "\n";
+                    _setmode(_fileno(stdout), _O_BINARY);
                 }
+#endif
+                writer(std::cout);
                 return;
             }
 
             const auto &path = options.output_path.value();
-            if (std::filesystem::exists(path) && !options.force_overwrite)
+            if (!append && std::filesystem::exists(path) && !options.force_overwrite)
             {
                 throw std::runtime_error("error_output_exists:" + path.string());
             }
 
-            std::ofstream out(path, std::ios::binary);
+            std::ofstream out(path, append ? std::ios::binary | std::ios::app : std::ios::binary);
             if (!out)
             {
                 throw std::runtime_error("error_write_file:" + path.string());
             }
 
-            for (const auto &key : outcome.keys)
-            {
-                out << utf32_to_locale(key) << '\n';
-            }
+            writer(out);
             if (!out)
             {
                 throw std::runtime_error("error_write_file:" + path.string());
@@ -107,6 +280,62 @@ namespace randkey
                           << ' ' << outcome.mixing_seed.value() << "\n";
             }
         }
+
+        void maybe_print_entropy(const i18n::Catalog &catalog,
+                                 const std::string &lang,
+                                 const GenerationOutcome &outcome)
+        {
+            if (!outcome.entropy_bits.has_value())
+            {
+                return;
+            }
+
+            // 写到 stderr，避免混入密钥输出
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(1) << outcome.entropy_bits.value();
+            std::cerr << catalog.translate(lang, "info_entropy") << ' ' << text.str() << "\n";
+        }
+
+        /// @brief --stats：写到 stderr，文本或单行 JSON
+        void print_stats(const i18n::Catalog &catalog, const std::string &lang, StatsFormat format,
+                         const stats::RunReport &report)
+        {
+            if (format == StatsFormat::Json)
+            {
+                report.write_json(std::cerr);
+                return;
+            }
+
+            using stats::Counter;
+            using stats::Stage;
+            const auto ms = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(1)
+                 << catalog.translate(lang, "info_stats_keys") << ' ' << report.keys << " ("
+                 << report.keys_per_second() << "/s)\n"
+                 << catalog.translate(lang, "info_stats_bytes") << ' ' << report.output_bytes << " ("
+                 << report.bytes_per_second() / (1024.0 * 1024.0) << " MiB/s)\n"
+                 << catalog.translate(lang, "info_stats_entropy") << ' '
+                 << report.snapshot.count(Counter::EntropyReads) << " / "
+                 << report.snapshot.count(Counter::EntropyBytes) << " B\n"
+                 << catalog.translate(lang, "info_stats_rejections") << ' '
+                 << report.snapshot.count(Counter::UniformRejections) << " / "
+                 << report.snapshot.count(Counter::UniformDraws) << " (" << std::setprecision(3)
+                 << report.rejection_rate() * 100.0 << "%)\n"
+                 << std::setprecision(1)
+                 << catalog.translate(lang, "info_stats_transcodes") << ' '
+                 << report.snapshot.count(Counter::Transcodes) << "\n"
+                 << catalog.translate(lang, "info_stats_writes") << ' ' << report.snapshot.count(Counter::Writes)
+                 << "\n"
+                 << catalog.translate(lang, "info_stats_rss") << ' '
+                 << static_cast<double>(report.peak_rss_bytes) / (1024.0 * 1024.0) << " MiB\n"
+                 << catalog.translate(lang, "info_stats_stages") << " total " << ms(report.elapsed_ns)
+                 << ", entropy " << ms(report.snapshot.nanoseconds(Stage::Entropy))
+                 << ", transcode " << ms(report.snapshot.nanoseconds(Stage::Transcode))
+                 << ", write " << ms(report.snapshot.nanoseconds(Stage::Write))
+                 << ", other " << ms(report.other_ns()) << "\n";
+            std::cerr << text.str();
+        }
     }
 }
 
@@ -114,10 +343,52 @@ int main(int argc, const char *argv[])
 {
     using namespace randkey;
 
+    maybe_start_trace(argc, argv);
+
     const auto language = platform::detect_system_language();
     auto catalog = i18n::build_default_catalog();
     catalog.set_fallback("en-US");
 
+    if (argc > 1 && std::string_view(argv[1]) == "serve")
+    {
+        try
+        {
+            run_serve(std::vector<std::string>(argv + 2, argv + argc));
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << format_message(catalog, language, ex.what()) << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "batch")
+    {
+        try
+        {
+            return run_batch_file(std::vector<std::string>(argv + 2, argv + argc), catalog, language) ? 0 : 1;
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << format_message(catalog, language, ex.what()) << "\n";
+            return 1;
+        }
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "verify")
+    {
+        try
+        {
+            return run_verify(std::vector<std::string>(argv + 2, argv + argc), catalog, language) ? 0 : 1;
+        }
+        catch (const std::exception &ex)
+        {
+            std::cerr << format_message(catalog, language, ex.what()) << "\n";
+            return 1;
+        }
+    }
+
     ArgumentParser parser;
     ParsedArguments parsed;
 
@@ -146,12 +417,97 @@ int main(int argc, const char *argv[])
     try
     {
         RandomKeyGenerator generator;
-        const GenerationOutcome outcome = generator.generate(parsed.options,
-                                                             parsed.deterministic_seed,
-                                                             parsed.mixing_seed);
+        GenerationOutcome outcome;
+        GenerationOptions options = parsed.options;
+
+        // 断点只记录确定性种子；安全模式续写时不传入旧的混合种子，由生成器重新取熵
+        RunningDigest digest;
+        std::optional<std::filesystem::path> checkpoint_path;
+        if (options.checkpoint_interval != 0 || parsed.resume)
+        {
+            checkpoint_path = Checkpoint::path_for(options.output_path.value());
+        }
+        if (parsed.resume)
+        {
+            resume_from_checkpoint(parsed, checkpoint_path.value(), options, digest);
+        }
+
+        if (options.stats != StatsFormat::None)
+        {
+            stats::enable();
+        }
+        const auto started = std::chrono::steady_clock::now();
+        std::uint64_t output_bytes = 0;
+
+        with_output_stream(options, parsed.resume, [&](std::ostream &stream) {
+            // 主输出打开后再创建附加输出；它须比写出器存活更久，写出器析构时会把剩余密钥交给它
+            std::optional<TeeWriter> tee;
+            if (!options.tee_targets.empty())
+            {
+                tee.emplace(options.tee_targets, options.force_overwrite, options.start_index);
+            }
+            OutputWriter writer(stream);
+            if (checkpoint_path.has_value())
+            {
+                writer.track_digest(digest);
+            }
+            if (tee.has_value())
+            {
+                writer.tee(tee.value());
+            }
+
+            outcome = generator.generate(options,
+                                         writer,
+                                         parsed.deterministic_seed,
+                                         parsed.mixing_seed,
+                                         [&](std::uint64_t next_index) {
+                                             // 写出器已刷新到流；断点只能覆盖已落盘的字节
+                                             stream.flush();
+                                             if (!platform::sync_file(options.output_path.value()))
+                                             {
+                                                 throw std::runtime_error("error_checkpoint_write:" + options.output_path->string());
+                                             }
+                                             Checkpoint checkpoint;
+                                             checkpoint.next_index = next_index;
+                                             checkpoint.bytes = digest.bytes();
+                                             checkpoint.digest = digest.value();
+                                             checkpoint.config = parsed.config_fingerprint;
+                                             checkpoint.deterministic_seed = parsed.deterministic_seed;
+                                             checkpoint.save(checkpoint_path.value());
+                                         });
+            output_bytes = writer.bytes_written();
+            if (tee.has_value())
+            {
+                tee->close();
+            }
+        });
+
+        // 批次完成后断点不再有意义
+        if (checkpoint_path.has_value())
+        {
+            std::error_code ec;
+            std::filesystem::remove(checkpoint_path.value(), ec);
+        }
 
-        write_output(parsed.options, outcome);
         maybe_print_seed(catalog, language, outcome, parsed);
+        maybe_print_entropy(catalog, language, outcome);
+
+        if (options.stats != StatsFormat::None)
+        {
+            stats::RunReport report;
+            report.keys = options.count;
+            report.output_bytes = output_bytes;
+            report.elapsed_ns = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+            report.peak_rss_bytes = platform::peak_resident_bytes();
+            report.snapshot = stats::snapshot();
+            print_stats(catalog, language, options.stats, report);
+        }
+
+        if (options.trace_path.has_value())
+        {
+            write_trace(options.trace_path.value());
+        }
     }
     catch (const std::exception &ex)
     {
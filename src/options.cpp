@@ -1,6 +1,8 @@
 #include "randkey/options.hpp"
 
+#include "randkey/constraints.hpp"
 #include "randkey/encoding.hpp"
+#include "randkey/run_stats.hpp"
 
 #include <array>
 #include <limits>
@@ -41,6 +43,87 @@ namespace randkey
 
             return result;
         }
+
+        /// @brief 解析内存大小，支持 K/M/G 后缀（1024 进制）
+        std::size_t parse_memory_size(std::u32string_view value)
+        {
+            unsigned shift = 0;
+            if (!value.empty())
+            {
+                switch (value.back())
+                {
+                case U'K':
+                case U'k':
+                    shift = 10;
+                    break;
+                case U'M':
+                case U'm':
+                    shift = 20;
+                    break;
+                case U'G':
+                case U'g':
+                    shift = 30;
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (shift != 0)
+            {
+                value.remove_suffix(1);
+            }
+
+            const std::uint64_t amount = parse_positive_integer(value, "error_mem_limit");
+            if (amount > (std::numeric_limits<std::size_t>::max() >> shift))
+            {
+                throw std::runtime_error("error_mem_limit");
+            }
+            return static_cast<std::size_t>(amount << shift);
+        }
+
+        /// @brief 解析分片规格 i/n（i 从 0 起）
+        ShardSpec parse_shard(std::u32string_view value)
+        {
+            const auto slash = value.find(U'/');
+            if (slash == std::u32string_view::npos)
+            {
+                throw std::runtime_error("error_shard");
+            }
+
+            ShardSpec spec;
+            const auto index = value.substr(0, slash);
+            spec.index = index == U"0" ? 0 : parse_positive_integer(index, "error_shard");
+            spec.count = parse_positive_integer(value.substr(slash + 1), "error_shard");
+            if (spec.index >= spec.count)
+            {
+                throw std::runtime_error("error_shard");
+            }
+            return spec;
+        }
+    }
+
+    KeyRange shard_range(std::uint64_t total, std::uint64_t shard, std::uint64_t shards)
+    {
+        // 分片数限制在 2^32 以内，保证下面的 remainder * k 不溢出
+        if (shards == 0 || shard >= shards || shards > (1ULL << 32U))
+        {
+            throw std::runtime_error("error_shard");
+        }
+
+        // floor(total * k / shards)，拆成商与余数两部分计算
+        const std::uint64_t quotient = total / shards;
+        const std::uint64_t remainder = total % shards;
+        auto boundary = [&](std::uint64_t k) {
+            return quotient * k + remainder * k / shards;
+        };
+        return KeyRange{boundary(shard), boundary(shard + 1)};
+    }
+
+    void apply_shard(GenerationOptions &options, std::uint64_t shard, std::uint64_t shards)
+    {
+        const KeyRange range = shard_range(static_cast<std::uint64_t>(options.count), shard, shards);
+        options.start_index = static_cast<std::size_t>(range.begin);
+        options.count = static_cast<std::size_t>(range.end - range.begin);
     }
 
     ParsedArguments ArgumentParser::parse(int argc, const char *const *argv) const
@@ -59,6 +142,37 @@ namespace randkey
             handle_flag(args[index], index, args, result);
         }
 
+        // FNV-1a：按出现顺序混入除 --resume/--force 与统计开关以外的全部参数
+        result.config_fingerprint = 0xCBF29CE484222325ULL;
+        for (std::size_t index = 1; index < args.size(); ++index)
+        {
+            if (args[index] == U"--resume" || args[index] == U"--force" || args[index] == U"--stats" ||
+                args[index] == U"--stats-json")
+            {
+                continue;
+            }
+            if (args[index] == U"--trace")
+            {
+                ++index;
+                continue;
+            }
+            for (char32_t ch : args[index])
+            {
+                result.config_fingerprint = (result.config_fingerprint ^ static_cast<std::uint64_t>(ch)) * 0x100000001B3ULL;
+            }
+            result.config_fingerprint = (result.config_fingerprint ^ 0x1FU) * 0x100000001B3ULL;
+        }
+
+        // --count 可以出现在 --shard 之后，因此在全部参数解析完毕后再换算分片区间
+        if (result.shard.has_value())
+        {
+            if (result.options.start_index != 0)
+            {
+                throw std::runtime_error("error_shard");
+            }
+            apply_shard(result.options, result.shard->index, result.shard->count);
+        }
+
         result.validate();
         return result;
     }
@@ -70,6 +184,83 @@ namespace randkey
             throw std::runtime_error("error_conflicting_seed");
         }
 
+        const int modes = static_cast<int>(options.raw_bytes > 0) +
+                          static_cast<int>(options.id_format != IdFormat::None) +
+                          static_cast<int>(options.pattern.has_value()) +
+                          static_cast<int>(options.passphrase_wordlist.has_value());
+        if (modes > 1)
+        {
+            throw std::runtime_error("error_conflicting_mode");
+        }
+
+        if (!options.required_classes.empty() && modes > 0)
+        {
+            throw std::runtime_error("error_require_mode");
+        }
+
+        if (options.registry.has_exclusions() && modes > 0)
+        {
+            throw std::runtime_error("error_exclude_chars_mode");
+        }
+
+        if (!options.required_classes.empty() && options.registry.weighted())
+        {
+            throw std::runtime_error("error_require_weighted");
+        }
+
+        if ((options.checkpoint_interval != 0 || resume) &&
+            (options.target != OutputTarget::File || options.unique || options.sorted))
+        {
+            throw std::runtime_error("error_checkpoint_mode");
+        }
+
+        if ((shard.has_value() || options.start_index != 0) && (options.unique || options.sorted))
+        {
+            throw std::runtime_error("error_shard_mode");
+        }
+
+        if (options.unique && (options.raw_bytes > 0 || options.id_format != IdFormat::None))
+        {
+            throw std::runtime_error("error_unique_mode");
+        }
+
+        if (options.exclude_file.has_value() && (options.raw_bytes > 0 || options.id_format != IdFormat::None))
+        {
+            throw std::runtime_error("error_exclude_mode");
+        }
+
+        if (options.hash_only && options.emit_hash == KeyHashAlgorithm::None)
+        {
+            throw std::runtime_error("error_hash_only");
+        }
+
+        if (options.emit_hash != KeyHashAlgorithm::None && options.raw_bytes > 0 &&
+            options.raw_encoding == BinaryEncoding::Binary)
+        {
+            throw std::runtime_error("error_hash_mode");
+        }
+
+        if (!options.tee_targets.empty() &&
+            ((options.raw_bytes > 0 && options.raw_encoding == BinaryEncoding::Binary) ||
+             options.checkpoint_interval != 0 || resume))
+        {
+            throw std::runtime_error("error_output_format_mode");
+        }
+
+        for (std::size_t i = 0; i < options.tee_targets.size(); ++i)
+        {
+            const auto &path = options.tee_targets[i].path;
+            bool clash = options.output_path.has_value() && options.output_path.value() == path;
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                clash = clash || options.tee_targets[j].path == path;
+            }
+            if (clash)
+            {
+                throw std::runtime_error("error_output_format_path:" + path.string());
+            }
+        }
+
         if (options.target == OutputTarget::File)
         {
             if (!options.output_path.has_value())
@@ -118,12 +309,116 @@ namespace randkey
             result.options.length = static_cast<std::size_t>(parse_positive_integer(value, "error_length"));
             return;
         }
+        if (flag == U"--checkpoint")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.checkpoint_interval = static_cast<std::size_t>(parse_positive_integer(value, "error_checkpoint_interval"));
+            return;
+        }
+        if (flag == U"--resume")
+        {
+            result.resume = true;
+            return;
+        }
+        if (flag == U"--start-index")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.start_index = value == U"0" ? 0 : static_cast<std::size_t>(parse_positive_integer(value, "error_start_index"));
+            return;
+        }
+        if (flag == U"--shard")
+        {
+            auto value = expect_value(args, index, flag);
+            result.shard = parse_shard(value);
+            return;
+        }
         if (flag == U"-c" || flag == U"--count")
         {
             auto value = expect_value(args, index, flag);
             result.options.count = static_cast<std::size_t>(parse_positive_integer(value, "error_count"));
             return;
         }
+        if (flag == U"--raw-bytes")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.raw_bytes = static_cast<std::size_t>(parse_positive_integer(value, "error_raw_bytes"));
+            return;
+        }
+        if (flag == U"--raw-encoding")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.raw_encoding = parse_binary_encoding(value);
+            return;
+        }
+        if (flag == U"--id")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.id_format = parse_id_format(value);
+            return;
+        }
+        if (flag == U"-p" || flag == U"--pattern")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.pattern = std::u32string(value);
+            return;
+        }
+        if (flag == U"--require")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.required_classes = parse_required_classes(value);
+            return;
+        }
+        if (flag == U"--passphrase")
+        {
+            auto value = expect_value(args, index, flag);
+            const auto utf8 = utf32_to_utf8(value);
+            std::u8string u8(utf8.begin(), utf8.end());
+            result.options.passphrase_wordlist = std::filesystem::path(u8);
+            return;
+        }
+        if (flag == U"--words")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.words = static_cast<std::size_t>(parse_positive_integer(value, "error_words"));
+            return;
+        }
+        if (flag == U"--separator")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.separator = std::u32string(value);
+            return;
+        }
+        if (flag == U"--unique")
+        {
+            result.options.unique = true;
+            return;
+        }
+        if (flag == U"--sorted")
+        {
+            result.options.sorted = true;
+            return;
+        }
+        if (flag == U"--mem-limit")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.memory_limit = parse_memory_size(value);
+            return;
+        }
+        if (flag == U"--temp-dir")
+        {
+            auto value = expect_value(args, index, flag);
+            const auto utf8 = utf32_to_utf8(value);
+            result.options.temp_directory = std::filesystem::path(std::u8string(utf8.begin(), utf8.end()));
+            return;
+        }
+        if (flag == U"--exclude-file")
+        {
+            auto value = expect_value(args, index, flag);
+            const auto utf8 = utf32_to_utf8(value);
+            std::u8string u8(utf8.begin(), utf8.end());
+            result.options.exclude_file = std::filesystem::path(u8);
+            return;
+        }
         if (flag == U"-all" || flag == U"--all")
         {
             result.options.registry.include_all_builtins();
@@ -149,6 +444,26 @@ namespace randkey
             result.options.registry.include(BuiltinCharset::Special);
             return;
         }
+        if (flag == U"--hex")
+        {
+            result.options.registry.include(BuiltinCharset::Hex);
+            return;
+        }
+        if (flag == U"--base32")
+        {
+            result.options.registry.include(BuiltinCharset::Base32);
+            return;
+        }
+        if (flag == U"--base64")
+        {
+            result.options.registry.include(BuiltinCharset::Base64);
+            return;
+        }
+        if (flag == U"--base64url")
+        {
+            result.options.registry.include(BuiltinCharset::Base64Url);
+            return;
+        }
         if (flag == U"-ai" || flag == U"--append")
         {
             auto value = expect_value(args, index, flag);
@@ -177,6 +492,31 @@ namespace randkey
             result.options.registry.add_from_file(std::filesystem::path(u8), true);
             return;
         }
+        if (flag == U"-afw" || flag == U"--append-file-weighted")
+        {
+            auto value = expect_value(args, index, flag);
+            const auto utf8 = utf32_to_utf8(value);
+            std::u8string u8(utf8.begin(), utf8.end());
+            result.options.registry.add_weighted_file(std::filesystem::path(u8));
+            return;
+        }
+        if (flag == U"--emit-hash")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.emit_hash = parse_key_hash_algorithm(value);
+            return;
+        }
+        if (flag == U"--hash-only")
+        {
+            result.options.hash_only = true;
+            return;
+        }
+        if (flag == U"--exclude")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.registry.exclude_characters(value);
+            return;
+        }
         if (flag == U"-o" || flag == U"--output")
         {
             auto value = expect_value(args, index, flag);
@@ -186,11 +526,34 @@ namespace randkey
             result.options.output_path = std::filesystem::path(u8);
             return;
         }
+        if (flag == U"--output-format")
+        {
+            auto value = expect_value(args, index, flag);
+            result.options.tee_targets.push_back(parse_tee_target(value));
+            return;
+        }
         if (flag == U"--force")
         {
             result.options.force_overwrite = true;
             return;
         }
+        if (flag == U"--stats" || flag == U"--stats-json")
+        {
+            // 以 RANDKEY_ENABLE_STATS=OFF 构建时计数与计时已被编译掉
+            if (!stats::compiled_in())
+            {
+                throw std::runtime_error("error_stats_disabled");
+            }
+            result.options.stats = flag == U"--stats" ? StatsFormat::Text : StatsFormat::Json;
+            return;
+        }
+        if (flag == U"--trace")
+        {
+            auto value = expect_value(args, index, flag);
+            const auto utf8 = utf32_to_utf8(value);
+            result.options.trace_path = std::filesystem::path(std::u8string(utf8.begin(), utf8.end()));
+            return;
+        }
         if (flag == U"--show-seed")
         {
             result.options.show_seed = true;
@@ -0,0 +1,306 @@
+#include "randkey/output_tee.hpp"
+
+#include "randkey/encoding.hpp"
+#include "randkey/key_hash.hpp"
+#include "randkey/run_stats.hpp"
+#include "randkey/trace.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace randkey
+{
+    namespace
+    {
+        void append_decimal(std::string &out, std::uint64_t value)
+        {
+            char digits[20];
+            const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, result.ptr);
+        }
+    }
+
+    /// @brief 一批已编码的密钥，由所有写线程共享，最后一个持有者释放时清零
+    struct TeeWriter::Chunk
+    {
+        std::string bytes;
+        std::vector<std::size_t> ends;
+        std::uint64_t first_index{0};
+
+        ~Chunk()
+        {
+            std::fill(bytes.begin(), bytes.end(), '\0');
+        }
+    };
+
+    /// @brief 单个附加输出：独占文件与写线程，按块格式化后写入
+    class TeeWriter::Sink
+    {
+    public:
+        Sink(const TeeTarget &target, bool force_overwrite) : target_(target)
+        {
+            if (!force_overwrite && std::filesystem::exists(target_.path))
+            {
+                throw std::runtime_error("error_output_exists:" + target_.path.string());
+            }
+            file_.open(target_.path, std::ios::binary);
+            if (!file_)
+            {
+                throw std::runtime_error("error_write_file:" + target_.path.string());
+            }
+            if (target_.format == TeeFormat::Csv)
+            {
+                file_ << "index,bytes,sha256\n";
+            }
+            worker_ = std::thread([this] { write_loop(); });
+        }
+
+        ~Sink()
+        {
+            finish();
+        }
+
+        void push(const std::shared_ptr<const Chunk> &chunk)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [&] { return queue_.size() < QUEUE_DEPTH; });
+            if (failed_)
+            {
+                throw std::runtime_error("error_write_file:" + target_.path.string());
+            }
+            queue_.push_back(chunk);
+            not_empty_.notify_one();
+        }
+
+        /// @return 写入是否全部成功
+        bool finish()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            not_empty_.notify_one();
+            if (worker_.joinable())
+            {
+                worker_.join();
+                file_.close();
+                failed_ = failed_ || !file_;
+            }
+            return !failed_;
+        }
+
+        const std::filesystem::path &path() const noexcept
+        {
+            return target_.path;
+        }
+
+    private:
+        void write_loop()
+        {
+            std::string out;
+            std::vector<std::string_view> keys;
+            std::vector<KeyDigest> digests;
+            for (;;)
+            {
+                std::shared_ptr<const Chunk> chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    not_empty_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty())
+                    {
+                        return;
+                    }
+                    chunk = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                not_full_.notify_one();
+
+                // 写失败后继续出队以免生产端阻塞，但不再写文件
+                if (failed_)
+                {
+                    continue;
+                }
+                {
+                    trace::Span span("encode", chunk->ends.size());
+                    format(*chunk, keys, digests, out);
+                }
+                {
+                    trace::Span span("write", out.size());
+                    stats::ScopedTimer timer(stats::Stage::Write);
+                    stats::add(stats::Counter::Writes);
+                    stats::add(stats::Counter::WrittenBytes, out.size());
+                    file_.write(out.data(), static_cast<std::streamsize>(out.size()));
+                }
+                std::fill(out.begin(), out.end(), '\0');
+                out.clear();
+                if (!file_)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    failed_ = true;
+                }
+            }
+        }
+
+        void format(const Chunk &chunk,
+                    std::vector<std::string_view> &keys,
+                    std::vector<KeyDigest> &digests,
+                    std::string &out) const
+        {
+            keys.clear();
+            std::size_t begin = 0;
+            for (std::size_t end : chunk.ends)
+            {
+                keys.emplace_back(chunk.bytes.data() + begin, end - begin);
+                begin = end;
+            }
+
+            if (target_.format == TeeFormat::Text)
+            {
+                for (std::string_view key : keys)
+                {
+                    out.append(key);
+                    out.push_back('\n');
+                }
+                return;
+            }
+
+            const KeyHashAlgorithm algorithm =
+                target_.format == TeeFormat::Blake3 ? KeyHashAlgorithm::Blake3 : KeyHashAlgorithm::Sha256;
+            digests.resize(keys.size());
+            hash_keys(algorithm, keys, digests);
+
+            for (std::size_t i = 0; i < keys.size(); ++i)
+            {
+                switch (target_.format)
+                {
+                case TeeFormat::Csv:
+                    append_decimal(out, chunk.first_index + i);
+                    out.push_back(',');
+                    append_decimal(out, keys[i].size());
+                    out.push_back(',');
+                    append_digest_hex(out, digests[i]);
+                    out.push_back('\n');
+                    break;
+                case TeeFormat::Sha256Binary:
+                    out.append(reinterpret_cast<const char *>(digests[i].data()), digests[i].size());
+                    break;
+                default:
+                    append_digest_hex(out, digests[i]);
+                    out.push_back('\n');
+                    break;
+                }
+            }
+        }
+
+        TeeTarget target_;
+        std::ofstream file_;
+
+        std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<std::shared_ptr<const Chunk>> queue_;
+        bool stopping_{false};
+        bool failed_{false};
+        std::thread worker_;
+    };
+
+    TeeTarget parse_tee_target(std::u32string_view spec)
+    {
+        const auto colon = spec.find(U':');
+        if (colon == std::u32string_view::npos || colon + 1 == spec.size())
+        {
+            throw std::runtime_error("error_output_format");
+        }
+
+        const std::u32string_view name = spec.substr(0, colon);
+        TeeTarget target;
+        if (name == U"text")
+        {
+            target.format = TeeFormat::Text;
+        }
+        else if (name == U"csv")
+        {
+            target.format = TeeFormat::Csv;
+        }
+        else if (name == U"sha256")
+        {
+            target.format = TeeFormat::Sha256;
+        }
+        else if (name == U"blake3")
+        {
+            target.format = TeeFormat::Blake3;
+        }
+        else if (name == U"sha256-bin")
+        {
+            target.format = TeeFormat::Sha256Binary;
+        }
+        else
+        {
+            throw std::runtime_error("error_output_format");
+        }
+
+        const auto utf8 = utf32_to_utf8(spec.substr(colon + 1));
+        target.path = std::filesystem::path(std::u8string(utf8.begin(), utf8.end()));
+        return target;
+    }
+
+    TeeWriter::TeeWriter(const std::vector<TeeTarget> &targets, bool force_overwrite, std::uint64_t first_index)
+        : next_index_(first_index)
+    {
+        sinks_.reserve(targets.size());
+        for (const auto &target : targets)
+        {
+            sinks_.push_back(std::make_unique<Sink>(target, force_overwrite));
+        }
+    }
+
+    TeeWriter::~TeeWriter() = default;
+
+    void TeeWriter::push(std::string &bytes, std::vector<std::size_t> &ends)
+    {
+        if (ends.empty())
+        {
+            return;
+        }
+
+        auto chunk = std::make_shared<Chunk>();
+        chunk->bytes.swap(bytes);
+        chunk->ends.swap(ends);
+        chunk->first_index = next_index_;
+        next_index_ += chunk->ends.size();
+
+        const std::shared_ptr<const Chunk> shared = std::move(chunk);
+        for (auto &sink : sinks_)
+        {
+            sink->push(shared);
+        }
+    }
+
+    void TeeWriter::close()
+    {
+        if (closed_)
+        {
+            return;
+        }
+        closed_ = true;
+
+        const std::filesystem::path *failed = nullptr;
+        for (auto &sink : sinks_)
+        {
+            if (!sink->finish() && failed == nullptr)
+            {
+                failed = &sink->path();
+            }
+        }
+        if (failed != nullptr)
+        {
+            throw std::runtime_error("error_write_file:" + failed->string());
+        }
+    }
+}
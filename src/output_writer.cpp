@@ -0,0 +1,231 @@
+#include "randkey/output_writer.hpp"
+
+#include "randkey/checkpoint.hpp"
+#include "randkey/encoding.hpp"
+#include "randkey/output_tee.hpp"
+#include "randkey/run_stats.hpp"
+#include "randkey/trace.hpp"
+
+#include <algorithm>
+
+namespace randkey
+{
+    namespace
+    {
+        // 多缓冲摘要按 8 路分组，一批 64 个密钥足以摊薄分组与转置开销
+        constexpr std::size_t HASH_BATCH = 64;
+
+        // 附加输出按块交给写线程，块越大线程间交接越少
+        constexpr std::size_t TEE_BATCH = 4096;
+
+        void append_key(std::string &out, std::u32string_view key)
+        {
+            bool ascii = true;
+            for (char32_t ch : key)
+            {
+                if (ch >= 0x80U)
+                {
+                    ascii = false;
+                    break;
+                }
+            }
+
+            if (ascii)
+            {
+                const std::size_t start = out.size();
+                out.resize(start + key.size());
+                for (std::size_t i = 0; i < key.size(); ++i)
+                {
+                    out[start + i] = static_cast<char>(key[i]);
+                }
+            }
+            else
+            {
+                out.append(utf32_to_locale(key));
+            }
+        }
+    }
+
+    OutputWriter::OutputWriter(std::ostream &stream, std::size_t buffer_limit)
+        : stream_(stream), buffer_limit_(buffer_limit)
+    {
+        buffer_.reserve(buffer_limit_ + 256);
+    }
+
+    OutputWriter::~OutputWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void OutputWriter::write_key(std::u32string_view key)
+    {
+        if (staging())
+        {
+            append_key(staged_, key);
+            stage_key();
+            return;
+        }
+
+        append_key(buffer_, key);
+        buffer_.push_back('\n');
+        maybe_flush();
+    }
+
+    void OutputWriter::write_line(std::string_view line)
+    {
+        if (staging())
+        {
+            staged_.append(line);
+            stage_key();
+            return;
+        }
+
+        buffer_.append(line);
+        buffer_.push_back('\n');
+        maybe_flush();
+    }
+
+    void OutputWriter::write_bytes(std::string_view bytes)
+    {
+        buffer_.append(bytes);
+        maybe_flush();
+    }
+
+    void OutputWriter::flush()
+    {
+        drain_staged();
+        if (!buffer_.empty())
+        {
+            write_out();
+        }
+        trace::Span span("flush");
+        stats::ScopedTimer timer(stats::Stage::Write);
+        stream_.flush();
+    }
+
+    std::uint64_t OutputWriter::bytes_written() const noexcept
+    {
+        return flushed_ + buffer_.size();
+    }
+
+    void OutputWriter::track_digest(RunningDigest &digest) noexcept
+    {
+        digest_ = &digest;
+    }
+
+    void OutputWriter::emit_hash(KeyHashAlgorithm algorithm, bool hash_only) noexcept
+    {
+        hash_ = algorithm;
+        hash_only_ = hash_only;
+    }
+
+    void OutputWriter::tee(TeeWriter &tee) noexcept
+    {
+        tee_ = &tee;
+    }
+
+    bool OutputWriter::staging() const noexcept
+    {
+        return hash_ != KeyHashAlgorithm::None || tee_ != nullptr;
+    }
+
+    void OutputWriter::stage_key()
+    {
+        staged_ends_.push_back(staged_.size());
+        if (staged_ends_.size() >= (tee_ != nullptr ? TEE_BATCH : HASH_BATCH))
+        {
+            drain_staged();
+            maybe_flush();
+        }
+    }
+
+    void OutputWriter::drain_staged()
+    {
+        if (staged_ends_.empty())
+        {
+            return;
+        }
+        trace::Span span("encode", staged_ends_.size());
+        if (hash_ == KeyHashAlgorithm::None)
+        {
+            buffer_.reserve(buffer_.size() + staged_.size() + staged_ends_.size());
+            std::size_t begin = 0;
+            for (std::size_t end : staged_ends_)
+            {
+                buffer_.append(staged_, begin, end - begin);
+                buffer_.push_back('\n');
+                begin = end;
+            }
+            release_staged();
+            return;
+        }
+
+        staged_views_.clear();
+        std::size_t begin = 0;
+        for (std::size_t end : staged_ends_)
+        {
+            staged_views_.emplace_back(staged_.data() + begin, end - begin);
+            begin = end;
+        }
+        digests_.resize(staged_views_.size());
+        hash_keys(hash_, staged_views_, digests_);
+
+        for (std::size_t i = 0; i < staged_views_.size(); ++i)
+        {
+            if (!hash_only_)
+            {
+                buffer_.append(staged_views_[i]);
+                buffer_.push_back('\t');
+            }
+            append_digest_hex(buffer_, digests_[i]);
+            buffer_.push_back('\n');
+        }
+
+        staged_views_.clear();
+        release_staged();
+    }
+
+    void OutputWriter::release_staged()
+    {
+        // 有附加输出时整块移交（由最后一个写线程清零），否则就地清零后复用
+        if (tee_ != nullptr)
+        {
+            const std::size_t capacity = staged_.capacity();
+            tee_->push(staged_, staged_ends_);
+            staged_.reserve(capacity);
+            return;
+        }
+        std::fill(staged_.begin(), staged_.end(), '\0');
+        staged_.clear();
+        staged_ends_.clear();
+    }
+
+    void OutputWriter::maybe_flush()
+    {
+        if (buffer_.size() >= buffer_limit_)
+        {
+            write_out();
+        }
+    }
+
+    void OutputWriter::write_out()
+    {
+        trace::Span span("write", buffer_.size());
+        stats::ScopedTimer timer(stats::Stage::Write);
+        stats::add(stats::Counter::Writes);
+        stats::add(stats::Counter::WrittenBytes, buffer_.size());
+        if (digest_ != nullptr)
+        {
+            digest_->update(buffer_);
+        }
+        stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        flushed_ += buffer_.size();
+        buffer_.clear();
+    }
+}
@@ -0,0 +1,207 @@
+#include "randkey/pattern.hpp"
+
+#include "randkey/trace.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        constexpr std::u32string_view PLACEHOLDERS = U"9aAxXhH!?";
+        constexpr std::u32string_view UPPER_HEX = U"0123456789ABCDEF";
+
+        /// @brief 单个密钥的字符数上限（字面量与抽取合计），防止 {n} 展开出超大字面量或使字节上限溢出
+        constexpr std::size_t MAX_KEY_CHARACTERS = 1U << 20U;
+
+        bool is_placeholder(char32_t ch)
+        {
+            return PLACEHOLDERS.find(ch) != std::u32string_view::npos;
+        }
+
+        /// @brief 解析 {n}，index 指向 '{'，返回后指向 '}' 之后
+        std::size_t parse_repeat(std::u32string_view pattern, std::size_t &index)
+        {
+            const std::size_t close = pattern.find(U'}', index);
+            if (close == std::u32string_view::npos || close == index + 1)
+            {
+                throw std::runtime_error("error_pattern:" + std::to_string(index + 1));
+            }
+
+            std::size_t value = 0;
+            for (std::size_t i = index + 1; i < close; ++i)
+            {
+                const char32_t ch = pattern[i];
+                if (ch < U'0' || ch > U'9' || value > (std::numeric_limits<std::size_t>::max() - 9) / 10)
+                {
+                    throw std::runtime_error("error_pattern:" + std::to_string(i + 1));
+                }
+                value = value * 10 + static_cast<std::size_t>(ch - U'0');
+            }
+
+            if (value == 0)
+            {
+                throw std::runtime_error("error_pattern:" + std::to_string(index + 1));
+            }
+
+            index = close + 1;
+            return value;
+        }
+    }
+
+    PatternPlan PatternPlan::compile(std::u32string_view pattern, const CharsetRegistry &active)
+    {
+        trace::Span span("plan_compile");
+        PatternPlan plan;
+        std::size_t index = 0;
+        std::size_t characters = 0;
+
+        while (index < pattern.size())
+        {
+            char32_t ch = pattern[index];
+            bool literal = true;
+
+            if (ch == U'{')
+            {
+                throw std::runtime_error("error_pattern:" + std::to_string(index + 1));
+            }
+            if (ch == U'\\')
+            {
+                if (index + 1 >= pattern.size())
+                {
+                    throw std::runtime_error("error_pattern:" + std::to_string(index + 1));
+                }
+                ch = pattern[++index];
+            }
+            else if (is_placeholder(ch))
+            {
+                literal = false;
+            }
+            ++index;
+
+            std::size_t repeat = 1;
+            const std::size_t repeat_position = index;
+            if (index < pattern.size() && pattern[index] == U'{')
+            {
+                repeat = parse_repeat(pattern, index);
+            }
+            if (repeat > MAX_KEY_CHARACTERS - characters)
+            {
+                throw std::runtime_error("error_pattern:" + std::to_string(repeat_position + 1));
+            }
+            characters += repeat;
+
+            if (literal)
+            {
+                plan.push_literal(std::u32string_view(&ch, 1), repeat);
+            }
+            else
+            {
+                plan.push_draw(plan.table_for(ch, active), repeat);
+            }
+        }
+
+        if (plan.segments_.empty())
+        {
+            throw std::runtime_error("error_pattern:0");
+        }
+
+        return plan;
+    }
+
+    const std::vector<PatternSegment> &PatternPlan::segments() const noexcept
+    {
+        return segments_;
+    }
+
+    const std::vector<std::vector<std::u32string>> &PatternPlan::tables() const noexcept
+    {
+        return tables_;
+    }
+
+    std::size_t PatternPlan::draw_count() const noexcept
+    {
+        std::size_t total = 0;
+        for (const auto &segment : segments_)
+        {
+            total += segment.repeat;
+        }
+        return total;
+    }
+
+    std::size_t PatternPlan::table_for(char32_t placeholder, const CharsetRegistry &active)
+    {
+        if (const auto pos = table_keys_.find(placeholder); pos != std::u32string::npos)
+        {
+            return pos;
+        }
+
+        CharsetRegistry registry;
+        switch (placeholder)
+        {
+        case U'9':
+            registry.include(BuiltinCharset::Digits);
+            break;
+        case U'a':
+            registry.include(BuiltinCharset::Lowercase);
+            break;
+        case U'A':
+            registry.include(BuiltinCharset::Uppercase);
+            break;
+        case U'x':
+            registry.include(BuiltinCharset::Lowercase);
+            registry.include(BuiltinCharset::Digits);
+            break;
+        case U'X':
+            registry.include(BuiltinCharset::Uppercase);
+            registry.include(BuiltinCharset::Digits);
+            break;
+        case U'h':
+            registry.include(BuiltinCharset::Hex);
+            break;
+        case U'H':
+            registry.add_characters(UPPER_HEX);
+            break;
+        case U'!':
+            registry.include(BuiltinCharset::Special);
+            break;
+        default:
+            registry = active;
+            registry.ensure_default();
+            break;
+        }
+
+        tables_.push_back(registry.materialize());
+        table_keys_.push_back(placeholder);
+        return tables_.size() - 1;
+    }
+
+    void PatternPlan::push_literal(std::u32string_view text, std::size_t repeat)
+    {
+        if (segments_.empty() || segments_.back().repeat != 0)
+        {
+            segments_.push_back(PatternSegment{});
+        }
+
+        auto &literal = segments_.back().literal;
+        for (std::size_t i = 0; i < repeat; ++i)
+        {
+            literal.append(text);
+        }
+    }
+
+    void PatternPlan::push_draw(std::size_t table, std::size_t repeat)
+    {
+        if (!segments_.empty() && segments_.back().repeat != 0 && segments_.back().table == table)
+        {
+            segments_.back().repeat += repeat;
+            return;
+        }
+
+        PatternSegment segment;
+        segment.table = table;
+        segment.repeat = repeat;
+        segments_.push_back(std::move(segment));
+    }
+}
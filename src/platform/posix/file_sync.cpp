@@ -0,0 +1,35 @@
+#include "randkey/platform/file_sync.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace randkey::platform
+{
+    namespace
+    {
+        bool sync_path(const std::filesystem::path &path, int flags) noexcept
+        {
+            const int fd = ::open(path.c_str(), flags | O_CLOEXEC);
+            if (fd < 0)
+            {
+                return false;
+            }
+            // 部分文件系统不支持对目录 fsync（EINVAL），此时改名已是其能提供的最强保证
+            const bool synced = ::fsync(fd) == 0 || errno == EINVAL;
+            ::close(fd);
+            return synced;
+        }
+    }
+
+    bool sync_file(const std::filesystem::path &path) noexcept
+    {
+        return sync_path(path, O_RDONLY);
+    }
+
+    bool sync_parent_directory(const std::filesystem::path &path) noexcept
+    {
+        const auto parent = path.parent_path();
+        return sync_path(parent.empty() ? std::filesystem::path(".") : parent, O_RDONLY | O_DIRECTORY);
+    }
+}
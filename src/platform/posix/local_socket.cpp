@@ -0,0 +1,326 @@
+#include "randkey/platform/local_socket.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <list>
+#include <memory>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace randkey::platform
+{
+    namespace
+    {
+        /// @brief accept 轮询 stop 标志的间隔（毫秒）；已建立的连接阻塞在 recv，停止时由 shutdown 唤醒
+        constexpr int POLL_INTERVAL_MS = 100;
+
+#if defined(__linux__)
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        constexpr int SEND_FLAGS = 0;
+#endif
+
+        /// @brief 设置 close-on-exec，并在没有 MSG_NOSIGNAL 的平台上以套接字选项屏蔽 SIGPIPE
+        /// @return fd；配置失败时关闭 fd 并返回 -1
+        int configure_socket(int fd)
+        {
+#if !defined(__linux__)
+            if (fd < 0)
+            {
+                return fd;
+            }
+            const int flags = ::fcntl(fd, F_GETFD);
+            if (flags < 0 || ::fcntl(fd, F_SETFD, flags | FD_CLOEXEC) != 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+#if defined(SO_NOSIGPIPE)
+            const int enable = 1;
+            if (::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable)) != 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+#endif
+#endif
+            return fd;
+        }
+
+        int open_socket()
+        {
+#if defined(__linux__)
+            return ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+            return configure_socket(::socket(AF_UNIX, SOCK_STREAM, 0));
+#endif
+        }
+
+        int accept_connection(int listener)
+        {
+#if defined(__linux__)
+            return ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+            return configure_socket(::accept(listener, nullptr, nullptr));
+#endif
+        }
+
+        sockaddr_un make_address(const std::filesystem::path &path)
+        {
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            const std::string native = path.string();
+            if (native.size() >= sizeof(address.sun_path))
+            {
+                throw std::runtime_error("error_serve_socket:" + native);
+            }
+            std::memcpy(address.sun_path, native.c_str(), native.size() + 1);
+            return address;
+        }
+
+        /// @brief 清理上次异常退出残留的套接字文件：只删除拒绝连接的套接字，
+        ///        其他类型的文件或仍在服务的套接字一律报错，避免误删文件或抢走运行中的服务
+        void remove_stale_socket(const sockaddr_un &address, const std::filesystem::path &path)
+        {
+            struct stat info{};
+            if (::lstat(address.sun_path, &info) != 0)
+            {
+                if (errno == ENOENT)
+                {
+                    return;
+                }
+                throw std::runtime_error("error_serve_socket:" + path.string());
+            }
+            if (!S_ISSOCK(info.st_mode))
+            {
+                throw std::runtime_error("error_serve_socket:" + path.string());
+            }
+
+            const int probe = open_socket();
+            if (probe < 0)
+            {
+                throw std::runtime_error("error_serve_socket:" + path.string());
+            }
+            const bool refused =
+                ::connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED;
+            ::close(probe);
+            if (!refused)
+            {
+                throw std::runtime_error("error_serve_socket:" + path.string());
+            }
+            ::unlink(address.sun_path);
+        }
+
+        bool write_all(int fd, const char *data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                const ssize_t written = ::send(fd, data, size, SEND_FLAGS);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+
+        /// @brief 读满 size 字节；对端关闭或出错返回 false
+        bool read_all(int fd, char *data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                const ssize_t got = ::recv(fd, data, size, 0);
+                if (got < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (got <= 0)
+                {
+                    return false;
+                }
+                data += got;
+                size -= static_cast<std::size_t>(got);
+            }
+            return true;
+        }
+
+        bool write_frame(int fd, std::string_view payload)
+        {
+            char header[FRAME_HEADER_BYTES];
+            const auto size = static_cast<std::uint32_t>(payload.size());
+            for (std::size_t i = 0; i < FRAME_HEADER_BYTES; ++i)
+            {
+                header[i] = static_cast<char>((size >> (8U * i)) & 0xFFU);
+            }
+            return write_all(fd, header, sizeof(header)) && write_all(fd, payload.data(), payload.size());
+        }
+
+        bool read_frame(int fd, std::string &payload)
+        {
+            unsigned char header[FRAME_HEADER_BYTES];
+            if (!read_all(fd, reinterpret_cast<char *>(header), sizeof(header)))
+            {
+                return false;
+            }
+
+            std::uint32_t size = 0;
+            for (std::size_t i = 0; i < FRAME_HEADER_BYTES; ++i)
+            {
+                size |= static_cast<std::uint32_t>(header[i]) << (8U * i);
+            }
+            if (size > FRAME_MAX_BYTES)
+            {
+                return false;
+            }
+
+            payload.resize(size);
+            return read_all(fd, payload.data(), size);
+        }
+    }
+
+    void serve_local_socket(const std::filesystem::path &path,
+                            const std::function<std::string(std::string_view)> &handler,
+                            const std::atomic<bool> &stop)
+    {
+        const sockaddr_un address = make_address(path);
+        remove_stale_socket(address, path);
+
+#if !defined(__linux__) && !defined(SO_NOSIGPIPE)
+        // 既无 MSG_NOSIGNAL 也无 SO_NOSIGPIPE 时，客户端断开不能终止服务进程
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+        const int listener = open_socket();
+        if (listener < 0)
+        {
+            throw std::runtime_error("error_serve_socket:" + path.string());
+        }
+
+        // 套接字文件以 0600 创建，只有同一用户能连接领取密钥，与调用方的 umask 无关
+        const mode_t previous_mask = ::umask(S_IXUSR | S_IRWXG | S_IRWXO);
+        const bool bound = ::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+        ::umask(previous_mask);
+        if (!bound || ::listen(listener, SOMAXCONN) != 0)
+        {
+            ::close(listener);
+            throw std::runtime_error("error_serve_socket:" + path.string());
+        }
+
+        // 连接由接受线程在 join 之后关闭，shutdown 不会误伤被复用的描述符
+        struct Worker
+        {
+            int connection;
+            std::thread thread;
+            std::shared_ptr<std::atomic<bool>> done;
+        };
+        std::list<Worker> workers;
+
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            // 回收已断开的连接线程，长时间运行时线程对象不会无限累积
+            for (auto it = workers.begin(); it != workers.end();)
+            {
+                if (it->done->load(std::memory_order_acquire))
+                {
+                    it->thread.join();
+                    ::close(it->connection);
+                    it = workers.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            pollfd entry{listener, POLLIN, 0};
+            if (::poll(&entry, 1, POLL_INTERVAL_MS) <= 0)
+            {
+                continue;
+            }
+
+            const int connection = accept_connection(listener);
+            if (connection < 0)
+            {
+                continue;
+            }
+
+            auto done = std::make_shared<std::atomic<bool>>(false);
+            workers.push_back(Worker{connection, std::thread(), done});
+            workers.back().thread = std::thread([connection, done, &handler] {
+                std::string request;
+                while (read_frame(connection, request))
+                {
+                    std::string response = handler(request);
+                    const bool sent = write_frame(connection, response);
+                    std::fill(response.begin(), response.end(), '\0');
+                    if (!sent)
+                    {
+                        break;
+                    }
+                }
+                done->store(true, std::memory_order_release);
+            });
+        }
+
+        // 唤醒阻塞在 recv/send 中的连接线程
+        for (auto &worker : workers)
+        {
+            ::shutdown(worker.connection, SHUT_RDWR);
+        }
+        for (auto &worker : workers)
+        {
+            worker.thread.join();
+            ::close(worker.connection);
+        }
+        ::close(listener);
+        ::unlink(address.sun_path);
+    }
+
+    LocalSocketClient::LocalSocketClient(const std::filesystem::path &path)
+    {
+        const sockaddr_un address = make_address(path);
+        const int fd = open_socket();
+        if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw std::runtime_error("error_serve_connect:" + path.string());
+        }
+        handle_ = fd;
+    }
+
+    LocalSocketClient::~LocalSocketClient()
+    {
+        if (handle_ >= 0)
+        {
+            ::close(static_cast<int>(handle_));
+        }
+    }
+
+    std::string LocalSocketClient::request(std::string_view payload)
+    {
+        const int fd = static_cast<int>(handle_);
+        std::string response;
+        if (!write_frame(fd, payload) || !read_frame(fd, response))
+        {
+            throw std::runtime_error("error_serve_connect");
+        }
+        return response;
+    }
+}
@@ -0,0 +1,89 @@
+#include "randkey/platform/mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace randkey::platform
+{
+    MappedFile::~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    MappedFile MappedFile::open(const std::filesystem::path &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("打开文件失败: " + std::string(std::strerror(errno)));
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("读取文件信息失败: " + std::string(std::strerror(error)));
+        }
+
+        MappedFile file;
+        file.size_ = static_cast<std::size_t>(info.st_size);
+        if (file.size_ > 0)
+        {
+            void *address = ::mmap(nullptr, file.size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::runtime_error("映射文件失败: " + std::string(std::strerror(error)));
+            }
+            file.data_ = static_cast<const std::byte *>(address);
+        }
+
+        // 映射建立后即可关闭描述符
+        ::close(fd);
+        return file;
+    }
+
+    std::span<const std::byte> MappedFile::bytes() const noexcept
+    {
+        return std::span<const std::byte>(data_, size_);
+    }
+
+    void MappedFile::release() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<std::byte *>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        handle_ = nullptr;
+    }
+}
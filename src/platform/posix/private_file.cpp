@@ -0,0 +1,63 @@
+#include "randkey/platform/private_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace randkey::platform
+{
+    std::filesystem::path create_private_directory(const std::filesystem::path &parent, const std::string &prefix)
+    {
+        const std::string pattern = (parent / (prefix + "XXXXXX")).string();
+        std::vector<char> buffer(pattern.begin(), pattern.end());
+        buffer.push_back('\0');
+        if (::mkdtemp(buffer.data()) == nullptr)
+        {
+            throw std::runtime_error("error_temp_dir:" + parent.string());
+        }
+        return std::filesystem::path(buffer.data());
+    }
+
+    void create_private_file(const std::filesystem::path &path)
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+        {
+            throw std::runtime_error("error_sort_spill");
+        }
+        ::close(fd);
+    }
+
+    void wipe_and_remove(const std::filesystem::path &path) noexcept
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            struct stat info{};
+            if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+            {
+                static constexpr std::array<char, 1U << 16U> ZEROS{};
+                off_t remaining = info.st_size;
+                off_t offset = 0;
+                while (remaining > 0)
+                {
+                    const auto chunk = static_cast<std::size_t>(std::min<off_t>(remaining, static_cast<off_t>(ZEROS.size())));
+                    const ssize_t written = ::pwrite(fd, ZEROS.data(), chunk, offset);
+                    if (written <= 0)
+                    {
+                        break;
+                    }
+                    offset += written;
+                    remaining -= written;
+                }
+                ::fdatasync(fd);
+            }
+            ::close(fd);
+        }
+        ::unlink(path.c_str());
+    }
+}
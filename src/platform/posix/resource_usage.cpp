@@ -0,0 +1,21 @@
+#include "randkey/platform/resource_usage.hpp"
+
+#include <sys/resource.h>
+
+namespace randkey::platform
+{
+    std::uint64_t peak_resident_bytes() noexcept
+    {
+        struct rusage usage{};
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#if defined(__APPLE__)
+        // macOS 的 ru_maxrss 以字节为单位，Linux 与 BSD 为 KiB
+        return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024U;
+#endif
+    }
+}
@@ -0,0 +1,171 @@
+#include "randkey/platform/shared_memory.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace randkey::platform
+{
+    namespace
+    {
+        std::byte *map_region(int fd, std::size_t size, const std::string &name)
+        {
+            void *address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (address == MAP_FAILED)
+            {
+                throw std::runtime_error("error_ring_open:" + name);
+            }
+            return static_cast<std::byte *>(address);
+        }
+    }
+
+    SharedMemory::~SharedMemory()
+    {
+        release();
+    }
+
+    SharedMemory::SharedMemory(SharedMemory &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          owned_name_(std::exchange(other.owned_name_, std::string()))
+    {
+    }
+
+    SharedMemory &SharedMemory::operator=(SharedMemory &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            owned_name_ = std::exchange(other.owned_name_, std::string());
+        }
+        return *this;
+    }
+
+    SharedMemory SharedMemory::create(const std::string &name, std::size_t size)
+    {
+        // 上次异常退出可能留下同名区域，直接替换
+        ::shm_unlink(name.c_str());
+        const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+        {
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+
+        SharedMemory region;
+        try
+        {
+            region.data_ = map_region(fd, size, name);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+        ::close(fd);
+        region.size_ = size;
+        region.owned_name_ = name;
+        return region;
+    }
+
+    SharedMemory SharedMemory::open(const std::string &name)
+    {
+        const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("error_ring_open:" + name);
+        }
+
+        SharedMemory region;
+        try
+        {
+            region.data_ = map_region(fd, static_cast<std::size_t>(info.st_size), name);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        region.size_ = static_cast<std::size_t>(info.st_size);
+        return region;
+    }
+
+    std::span<std::byte> SharedMemory::bytes() const noexcept
+    {
+        return std::span<std::byte>(data_, size_);
+    }
+
+    void SharedMemory::release() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(data_, size_);
+        }
+        if (!owned_name_.empty())
+        {
+            ::shm_unlink(owned_name_.c_str());
+        }
+        data_ = nullptr;
+        size_ = 0;
+        owned_name_.clear();
+    }
+
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+                  std::atomic<std::uint32_t>::is_always_lock_free);
+
+    void wait_on_address(const std::atomic<std::uint32_t> &word, std::uint32_t expected, int timeout_ms) noexcept
+    {
+#if defined(__linux__)
+        // 区域跨进程共享，不能使用 FUTEX_PRIVATE_FLAG
+        timespec timeout{};
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        ::syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+        // 无 futex 的平台退化为短暂休眠后重新检查
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (word.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+#endif
+    }
+
+    void wake_address(std::atomic<std::uint32_t> &word) noexcept
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+}
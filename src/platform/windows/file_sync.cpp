@@ -0,0 +1,30 @@
+#include "randkey/platform/file_sync.hpp"
+
+#include <windows.h>
+
+namespace randkey::platform
+{
+    bool sync_file(const std::filesystem::path &path) noexcept
+    {
+        // FlushFileBuffers 需要写权限；共享方式允许主输出流仍保持打开
+        const HANDLE file = ::CreateFileW(path.c_str(),
+                                          GENERIC_WRITE,
+                                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                          nullptr,
+                                          OPEN_EXISTING,
+                                          FILE_ATTRIBUTE_NORMAL,
+                                          nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        const bool synced = ::FlushFileBuffers(file) != 0;
+        ::CloseHandle(file);
+        return synced;
+    }
+
+    bool sync_parent_directory(const std::filesystem::path &) noexcept
+    {
+        return true;
+    }
+}
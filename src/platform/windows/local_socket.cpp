@@ -0,0 +1,26 @@
+#include "randkey/platform/local_socket.hpp"
+
+#include <stdexcept>
+
+namespace randkey::platform
+{
+    // Windows 版本暂不提供本地套接字服务，调用方收到统一的错误键
+    void serve_local_socket(const std::filesystem::path &,
+                            const std::function<std::string(std::string_view)> &,
+                            const std::atomic<bool> &)
+    {
+        throw std::runtime_error("error_serve_unsupported");
+    }
+
+    LocalSocketClient::LocalSocketClient(const std::filesystem::path &)
+    {
+        throw std::runtime_error("error_serve_unsupported");
+    }
+
+    LocalSocketClient::~LocalSocketClient() = default;
+
+    std::string LocalSocketClient::request(std::string_view)
+    {
+        throw std::runtime_error("error_serve_unsupported");
+    }
+}
@@ -0,0 +1,97 @@
+#include "randkey/platform/mapped_file.hpp"
+
+#include <windows.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace randkey::platform
+{
+    MappedFile::~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    MappedFile MappedFile::open(const std::filesystem::path &path)
+    {
+        HANDLE file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("打开文件失败");
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file_handle, &size))
+        {
+            CloseHandle(file_handle);
+            throw std::runtime_error("读取文件信息失败");
+        }
+
+        MappedFile file;
+        file.size_ = static_cast<std::size_t>(size.QuadPart);
+        if (file.size_ > 0)
+        {
+            HANDLE mapping = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file_handle);
+            if (mapping == nullptr)
+            {
+                throw std::runtime_error("映射文件失败");
+            }
+
+            const void *address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (address == nullptr)
+            {
+                CloseHandle(mapping);
+                throw std::runtime_error("映射文件失败");
+            }
+            file.data_ = static_cast<const std::byte *>(address);
+            file.handle_ = mapping;
+        }
+        else
+        {
+            CloseHandle(file_handle);
+        }
+
+        return file;
+    }
+
+    std::span<const std::byte> MappedFile::bytes() const noexcept
+    {
+        return std::span<const std::byte>(data_, size_);
+    }
+
+    void MappedFile::release() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+        if (handle_ != nullptr)
+        {
+            CloseHandle(static_cast<HANDLE>(handle_));
+        }
+        data_ = nullptr;
+        size_ = 0;
+        handle_ = nullptr;
+    }
+}
@@ -0,0 +1,77 @@
+#include "randkey/platform/private_file.hpp"
+
+#include "randkey/platform/random_device.hpp"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace randkey::platform
+{
+    std::filesystem::path create_private_directory(const std::filesystem::path &parent, const std::string &prefix)
+    {
+        // 目录继承父目录（通常为每用户的 %TEMP%）的 ACL；名称随机，重名时重试
+        static constexpr char HEX[] = "0123456789abcdef";
+        for (int attempt = 0; attempt < 16; ++attempt)
+        {
+            std::array<std::byte, 8> bytes{};
+            secure_random_fill(bytes);
+            std::string name = prefix;
+            for (std::byte byte : bytes)
+            {
+                name.push_back(HEX[std::to_integer<unsigned>(byte) >> 4U]);
+                name.push_back(HEX[std::to_integer<unsigned>(byte) & 0xFU]);
+            }
+            const std::filesystem::path candidate = parent / name;
+            if (CreateDirectoryW(candidate.c_str(), nullptr) != 0)
+            {
+                return candidate;
+            }
+            if (GetLastError() != ERROR_ALREADY_EXISTS)
+            {
+                break;
+            }
+        }
+        throw std::runtime_error("error_temp_dir:" + parent.string());
+    }
+
+    void create_private_file(const std::filesystem::path &path)
+    {
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("error_sort_spill");
+        }
+        CloseHandle(handle);
+    }
+
+    void wipe_and_remove(const std::filesystem::path &path) noexcept
+    {
+        HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER size{};
+            if (GetFileSizeEx(handle, &size) != 0)
+            {
+                static constexpr std::array<char, 1U << 16U> ZEROS{};
+                LONGLONG remaining = size.QuadPart;
+                while (remaining > 0)
+                {
+                    const auto chunk = static_cast<DWORD>(std::min<LONGLONG>(remaining, static_cast<LONGLONG>(ZEROS.size())));
+                    DWORD written = 0;
+                    if (WriteFile(handle, ZEROS.data(), chunk, &written, nullptr) == 0 || written == 0)
+                    {
+                        break;
+                    }
+                    remaining -= written;
+                }
+                FlushFileBuffers(handle);
+            }
+            CloseHandle(handle);
+        }
+        DeleteFileW(path.c_str());
+    }
+}
@@ -0,0 +1,17 @@
+#include "randkey/platform/resource_usage.hpp"
+
+#include <windows.h>
+#include <psapi.h>
+
+namespace randkey::platform
+{
+    std::uint64_t peak_resident_bytes() noexcept
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(counters.PeakWorkingSetSize);
+    }
+}
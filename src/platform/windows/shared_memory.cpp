@@ -0,0 +1,40 @@
+#include "randkey/platform/shared_memory.hpp"
+
+#include <stdexcept>
+
+namespace randkey::platform
+{
+    // Windows 版本暂不提供共享内存环，调用方收到统一的错误键
+    SharedMemory::~SharedMemory() = default;
+
+    SharedMemory::SharedMemory(SharedMemory &&) noexcept = default;
+
+    SharedMemory &SharedMemory::operator=(SharedMemory &&) noexcept = default;
+
+    SharedMemory SharedMemory::create(const std::string &, std::size_t)
+    {
+        throw std::runtime_error("error_serve_unsupported");
+    }
+
+    SharedMemory SharedMemory::open(const std::string &)
+    {
+        throw std::runtime_error("error_serve_unsupported");
+    }
+
+    std::span<std::byte> SharedMemory::bytes() const noexcept
+    {
+        return {};
+    }
+
+    void SharedMemory::release() noexcept
+    {
+    }
+
+    void wait_on_address(const std::atomic<std::uint32_t> &, std::uint32_t, int) noexcept
+    {
+    }
+
+    void wake_address(std::atomic<std::uint32_t> &) noexcept
+    {
+    }
+}
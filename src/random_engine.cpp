@@ -1,7 +1,9 @@
 #include "randkey/random_engine.hpp"
 
 #include "randkey/platform/random_device.hpp"
+#include "randkey/run_stats.hpp"
 
+#include <algorithm>
 #include <array>
 #include <limits>
 #include <stdexcept>
@@ -25,6 +27,9 @@ namespace randkey
             throw std::runtime_error("error_random_device");
         }
 
+        stats::ScopedTimer timer(stats::Stage::Entropy);
+        stats::add(stats::Counter::EntropyReads);
+        stats::add(stats::Counter::EntropyBytes, buffer.size());
         try
         {
             platform::secure_random_fill(buffer);
@@ -58,8 +63,89 @@ namespace randkey
 
             if (value < threshold)
             {
+                stats::add(stats::Counter::UniformDraws);
                 return value % upper;
             }
+            stats::add(stats::Counter::UniformRejections);
         }
     }
+
+    SecureRandomStream::SecureRandomStream(std::size_t buffer_size)
+        : buffer_(buffer_size == 0 ? 1 : buffer_size), position_(buffer_.size())
+    {
+    }
+
+    SecureRandomStream::~SecureRandomStream()
+    {
+        volatile std::byte *data = buffer_.data();
+        for (std::size_t i = 0; i < buffer_.size(); ++i)
+        {
+            data[i] = std::byte{0};
+        }
+    }
+
+    void SecureRandomStream::fill(std::span<std::byte> out)
+    {
+        // 大块请求直接读取随机源，避免额外拷贝
+        if (out.size() >= buffer_.size())
+        {
+            SecureRandom::fill(out);
+            return;
+        }
+
+        std::size_t offset = 0;
+        while (offset < out.size())
+        {
+            if (position_ == buffer_.size())
+            {
+                refill();
+            }
+
+            const std::size_t take = std::min(out.size() - offset, buffer_.size() - position_);
+            std::copy_n(buffer_.begin() + static_cast<std::ptrdiff_t>(position_), take, out.begin() + static_cast<std::ptrdiff_t>(offset));
+            std::fill_n(buffer_.begin() + static_cast<std::ptrdiff_t>(position_), take, std::byte{0});
+            position_ += take;
+            offset += take;
+        }
+    }
+
+    std::uint64_t SecureRandomStream::next_u64()
+    {
+        std::array<std::byte, sizeof(std::uint64_t)> data{};
+        fill(data);
+        std::uint64_t value = 0;
+        for (auto byte : data)
+        {
+            value = (value << 8U) | static_cast<std::uint64_t>(std::to_integer<unsigned char>(byte));
+        }
+        return value;
+    }
+
+    std::uint64_t SecureRandomStream::uniform(std::uint64_t upper)
+    {
+        if (upper == 0)
+        {
+            throw std::invalid_argument("uniform 上界必须大于 0");
+        }
+
+        const std::uint64_t range = std::numeric_limits<std::uint64_t>::max();
+        const std::uint64_t threshold = range - (range % upper);
+
+        while (true)
+        {
+            const std::uint64_t value = next_u64();
+            if (value < threshold)
+            {
+                stats::add(stats::Counter::UniformDraws);
+                return value % upper;
+            }
+            stats::add(stats::Counter::UniformRejections);
+        }
+    }
+
+    void SecureRandomStream::refill()
+    {
+        SecureRandom::fill(buffer_);
+        position_ = 0;
+    }
 }
@@ -0,0 +1,168 @@
+#include "randkey/run_stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace randkey::stats
+{
+    namespace
+    {
+        double per_second(std::uint64_t value, std::uint64_t nanoseconds) noexcept
+        {
+            return nanoseconds == 0 ? 0.0 : static_cast<double>(value) * 1e9 / static_cast<double>(nanoseconds);
+        }
+    }
+
+    double RunReport::keys_per_second() const noexcept
+    {
+        return per_second(keys, elapsed_ns);
+    }
+
+    double RunReport::bytes_per_second() const noexcept
+    {
+        return per_second(output_bytes, elapsed_ns);
+    }
+
+    double RunReport::rejection_rate() const noexcept
+    {
+        const std::uint64_t rejected = snapshot.count(Counter::UniformRejections);
+        const std::uint64_t attempts = snapshot.count(Counter::UniformDraws) + rejected;
+        return attempts == 0 ? 0.0 : static_cast<double>(rejected) / static_cast<double>(attempts);
+    }
+
+    std::uint64_t RunReport::other_ns() const noexcept
+    {
+        std::uint64_t staged = 0;
+        for (std::uint64_t value : snapshot.stage_ns)
+        {
+            staged += value;
+        }
+        return elapsed_ns > staged ? elapsed_ns - staged : 0;
+    }
+
+    void RunReport::write_json(std::ostream &out) const
+    {
+        const auto flags = out.flags();
+        out << std::setprecision(6) << std::defaultfloat << "{\"keys\": " << keys
+            << ", \"output_bytes\": " << output_bytes << ", \"elapsed_ns\": " << elapsed_ns
+            << ", \"keys_per_second\": " << keys_per_second() << ", \"bytes_per_second\": " << bytes_per_second()
+            << ", \"entropy_reads\": " << snapshot.count(Counter::EntropyReads)
+            << ", \"entropy_bytes\": " << snapshot.count(Counter::EntropyBytes)
+            << ", \"uniform_draws\": " << snapshot.count(Counter::UniformDraws)
+            << ", \"uniform_rejections\": " << snapshot.count(Counter::UniformRejections)
+            << ", \"rejection_rate\": " << rejection_rate()
+            << ", \"transcodes\": " << snapshot.count(Counter::Transcodes)
+            << ", \"transcoded_bytes\": " << snapshot.count(Counter::TranscodedBytes)
+            << ", \"writes\": " << snapshot.count(Counter::Writes)
+            << ", \"written_bytes\": " << snapshot.count(Counter::WrittenBytes)
+            << ", \"peak_rss_bytes\": " << peak_rss_bytes
+            << ", \"stage_ns\": {\"entropy\": " << snapshot.nanoseconds(Stage::Entropy)
+            << ", \"transcode\": " << snapshot.nanoseconds(Stage::Transcode)
+            << ", \"write\": " << snapshot.nanoseconds(Stage::Write) << ", \"other\": " << other_ns() << "}}\n";
+        out.flags(flags);
+    }
+
+#if RANDKEY_STATS
+    namespace
+    {
+        /// @brief 单线程的计数槽：只有所属线程写入（无需原子读改写），汇总时其他线程以 relaxed 读取
+        struct Slot
+        {
+            std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Counter::Count)> counters{};
+            std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(Stage::Count)> stage_ns{};
+        };
+
+        void bump(std::atomic<std::uint64_t> &cell, std::uint64_t value) noexcept
+        {
+            cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<const Slot *> live;
+            Snapshot retired;
+        };
+
+        Registry &registry()
+        {
+            // 有意不释放：线程局部槽可能在静态对象析构之后才退出
+            static Registry *instance = new Registry();
+            return *instance;
+        }
+
+        void accumulate(Snapshot &total, const Slot &slot) noexcept
+        {
+            for (std::size_t i = 0; i < total.counters.size(); ++i)
+            {
+                total.counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+            }
+            for (std::size_t i = 0; i < total.stage_ns.size(); ++i)
+            {
+                total.stage_ns[i] += slot.stage_ns[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        /// @brief 首次使用时登记到注册表，线程退出时把计数并入 retired
+        struct LocalSlot
+        {
+            Slot slot;
+
+            LocalSlot()
+            {
+                Registry &shared = registry();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                shared.live.push_back(&slot);
+            }
+
+            ~LocalSlot()
+            {
+                Registry &shared = registry();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                accumulate(shared.retired, slot);
+                shared.live.erase(std::find(shared.live.begin(), shared.live.end(), &slot));
+            }
+        };
+
+        Slot &local_slot()
+        {
+            thread_local LocalSlot local;
+            return local.slot;
+        }
+    }
+
+    namespace detail
+    {
+        std::atomic<bool> enabled_flag{false};
+
+        void add(Counter counter, std::uint64_t value) noexcept
+        {
+            bump(local_slot().counters[static_cast<std::size_t>(counter)], value);
+        }
+
+        void add_time(Stage stage, std::uint64_t nanoseconds) noexcept
+        {
+            bump(local_slot().stage_ns[static_cast<std::size_t>(stage)], nanoseconds);
+        }
+    }
+
+    void enable() noexcept
+    {
+        detail::enabled_flag.store(true, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot()
+    {
+        Registry &shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        Snapshot total = shared.retired;
+        for (const Slot *slot : shared.live)
+        {
+            accumulate(total, *slot);
+        }
+        return total;
+    }
+#endif
+}
@@ -0,0 +1,199 @@
+#include "randkey/trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if RANDKEY_USDT
+#include <sys/sdt.h>
+#endif
+
+namespace randkey::trace
+{
+    namespace
+    {
+        struct Event
+        {
+            const char *name;
+            std::uint64_t begin_ns;
+            std::uint64_t duration_ns;
+            std::uint64_t value;
+        };
+
+        /// @brief 定长事件块：只有所属线程追加，size 以 release 发布，导出方 acquire 读取
+        struct Block
+        {
+            static constexpr std::size_t CAPACITY = 4096;
+
+            std::array<Event, CAPACITY> events{};
+            std::atomic<std::size_t> size{0};
+            std::atomic<Block *> next{nullptr};
+        };
+
+        /// @brief 单线程事件缓冲：块链表只增不减，追加路径不加锁
+        struct ThreadBuffer
+        {
+            explicit ThreadBuffer(std::uint32_t id) : tid(id), tail(&head) {}
+
+            ~ThreadBuffer()
+            {
+                Block *block = head.next.load(std::memory_order_relaxed);
+                while (block != nullptr)
+                {
+                    Block *next = block->next.load(std::memory_order_relaxed);
+                    delete block;
+                    block = next;
+                }
+            }
+
+            void append(const Event &event)
+            {
+                std::size_t size = tail->size.load(std::memory_order_relaxed);
+                if (size == Block::CAPACITY)
+                {
+                    Block *block = new Block();
+                    tail->next.store(block, std::memory_order_release);
+                    tail = block;
+                    size = 0;
+                }
+                tail->events[size] = event;
+                tail->size.store(size + 1, std::memory_order_release);
+            }
+
+            std::uint32_t tid;
+            Block head;
+            Block *tail;
+        };
+
+        struct Registry
+        {
+            std::atomic<bool> recording{false};
+            std::atomic<std::uint64_t> epoch_ns{0};
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        };
+
+        Registry &registry()
+        {
+            // 有意不释放：线程退出后其缓冲仍需导出，且可能晚于静态对象析构
+            static Registry *instance = new Registry();
+            return *instance;
+        }
+
+        std::uint64_t now_ns() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                  std::chrono::steady_clock::now().time_since_epoch())
+                                                  .count());
+        }
+
+        /// @brief 本线程首次记录时登记缓冲（唯一加锁的位置）
+        ThreadBuffer *local_buffer()
+        {
+            thread_local ThreadBuffer *buffer = [] {
+                Registry &shared = registry();
+                std::lock_guard<std::mutex> lock(shared.mutex);
+                const auto tid = static_cast<std::uint32_t>(shared.buffers.size() + 1);
+                shared.buffers.push_back(std::make_unique<ThreadBuffer>(tid));
+                return shared.buffers.back().get();
+            }();
+            return buffer;
+        }
+
+        void write_escaped(std::ostream &out, const char *text)
+        {
+            for (; *text != '\0'; ++text)
+            {
+                if (*text == '"' || *text == '\\')
+                {
+                    out << '\\';
+                }
+                out << *text;
+            }
+        }
+    }
+
+    namespace detail
+    {
+        bool recording() noexcept
+        {
+            return registry().recording.load(std::memory_order_relaxed);
+        }
+
+        std::uint64_t begin(const char *name, std::uint64_t value) noexcept
+        {
+#if RANDKEY_USDT
+            DTRACE_PROBE2(randkey, span_begin, name, value);
+#else
+            static_cast<void>(name);
+            static_cast<void>(value);
+#endif
+            return recording() ? now_ns() : 0;
+        }
+
+        void end(const char *name, std::uint64_t value, std::uint64_t begin_ns) noexcept
+        {
+#if RANDKEY_USDT
+            DTRACE_PROBE2(randkey, span_end, name, value);
+#endif
+            if (begin_ns == 0 || !recording())
+            {
+                return;
+            }
+            try
+            {
+                local_buffer()->append(Event{name, begin_ns, now_ns() - begin_ns, value});
+            }
+            catch (...)
+            {
+                // 追踪是诊断手段，内存不足时丢弃事件而不影响生成
+            }
+        }
+    }
+
+    void start() noexcept
+    {
+        Registry &shared = registry();
+        std::uint64_t expected = 0;
+        shared.epoch_ns.compare_exchange_strong(expected, now_ns());
+        shared.recording.store(true, std::memory_order_relaxed);
+    }
+
+    void write_chrome_trace(std::ostream &out)
+    {
+        Registry &shared = registry();
+        const std::uint64_t epoch = shared.epoch_ns.load();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        const auto flags = out.flags();
+        out << std::fixed;
+        out.precision(3);
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"randkey\"}}";
+        for (const auto &buffer : shared.buffers)
+        {
+            out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->tid
+                << ", \"args\": {\"name\": \"thread " << buffer->tid << "\"}}";
+            for (const Block *block = &buffer->head; block != nullptr; block = block->next.load(std::memory_order_acquire))
+            {
+                const std::size_t size = block->size.load(std::memory_order_acquire);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    const Event &event = block->events[i];
+                    const std::uint64_t begin = event.begin_ns > epoch ? event.begin_ns - epoch : 0;
+                    out << ",\n{\"name\": \"";
+                    write_escaped(out, event.name);
+                    out << "\", \"cat\": \"randkey\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+                        << ", \"ts\": " << static_cast<double>(begin) / 1000.0
+                        << ", \"dur\": " << static_cast<double>(event.duration_ns) / 1000.0
+                        << ", \"args\": {\"value\": " << event.value << "}}";
+                }
+            }
+        }
+        out << "\n]}\n";
+        out.flags(flags);
+    }
+}
@@ -0,0 +1,160 @@
+#include "randkey/wordlist.hpp"
+
+#include "randkey/trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 条目打包：高 40 位为偏移，低 24 位为长度
+        constexpr unsigned LENGTH_BITS = 24;
+        constexpr std::uint64_t LENGTH_MASK = (1ULL << LENGTH_BITS) - 1;
+
+        std::uint64_t pack(std::size_t offset, std::size_t length)
+        {
+            return (static_cast<std::uint64_t>(offset) << LENGTH_BITS) | static_cast<std::uint64_t>(length);
+        }
+    }
+
+    Wordlist Wordlist::load(const std::filesystem::path &path)
+    {
+        trace::Span span("registry_load");
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("error_charset_file:" + path.string());
+        }
+
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path, ec);
+        std::string data;
+        if (!ec)
+        {
+            data.resize(static_cast<std::size_t>(size));
+            file.read(data.data(), static_cast<std::streamsize>(data.size()));
+            data.resize(static_cast<std::size_t>(file.gcount()));
+        }
+        else
+        {
+            data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        Wordlist list;
+        list.intern(std::move(data));
+        if (list.size() == 0)
+        {
+            throw std::runtime_error("error_wordlist_empty:" + path.string());
+        }
+        return list;
+    }
+
+    Wordlist Wordlist::from_words(const std::vector<std::string> &words)
+    {
+        std::string data;
+        for (const auto &word : words)
+        {
+            data.append(word);
+            data.push_back('\n');
+        }
+
+        Wordlist list;
+        list.intern(std::move(data));
+        return list;
+    }
+
+    std::size_t Wordlist::size() const noexcept
+    {
+        return entries_.size();
+    }
+
+    std::string_view Wordlist::word(std::size_t index) const noexcept
+    {
+        const std::uint64_t entry = entries_[index];
+        return std::string_view(data_.data() + (entry >> LENGTH_BITS), static_cast<std::size_t>(entry & LENGTH_MASK));
+    }
+
+    double Wordlist::bits_per_word() const noexcept
+    {
+        return entries_.empty() ? 0.0 : std::log2(static_cast<double>(entries_.size()));
+    }
+
+    void Wordlist::intern(std::string data)
+    {
+        data_ = std::move(data);
+        entries_.clear();
+        entries_.reserve(data_.size() / 8 + 1);
+
+        // 开放寻址去重表：槽位保存 条目下标+1，避免逐词分配节点
+        const std::size_t estimate = std::max<std::size_t>(16, data_.size() / 8);
+        std::vector<std::uint32_t> slots(std::bit_ceil(estimate * 2));
+        std::size_t mask = slots.size() - 1;
+        const std::hash<std::string_view> hasher;
+
+        auto rehash = [&] {
+            std::vector<std::uint32_t> grown(slots.size() * 2);
+            const std::size_t grown_mask = grown.size() - 1;
+            for (std::size_t i = 0; i < entries_.size(); ++i)
+            {
+                std::size_t slot = hasher(word(i)) & grown_mask;
+                while (grown[slot] != 0)
+                {
+                    slot = (slot + 1) & grown_mask;
+                }
+                grown[slot] = static_cast<std::uint32_t>(i + 1);
+            }
+            slots.swap(grown);
+            mask = grown_mask;
+        };
+
+        const char *begin = data_.data();
+        const char *end = begin + data_.size();
+        const char *line = begin;
+        while (line < end)
+        {
+            const void *found = std::memchr(line, '\n', static_cast<std::size_t>(end - line));
+            const char *next = found ? static_cast<const char *>(found) : end;
+
+            std::size_t length = static_cast<std::size_t>(next - line);
+            if (length > 0 && line[length - 1] == '\r')
+            {
+                --length;
+            }
+
+            if (length > 0 && length <= LENGTH_MASK)
+            {
+                const std::string_view candidate(line, length);
+                std::size_t slot = hasher(candidate) & mask;
+                bool duplicate = false;
+                while (slots[slot] != 0)
+                {
+                    if (word(slots[slot] - 1) == candidate)
+                    {
+                        duplicate = true;
+                        break;
+                    }
+                    slot = (slot + 1) & mask;
+                }
+
+                if (!duplicate)
+                {
+                    slots[slot] = static_cast<std::uint32_t>(entries_.size() + 1);
+                    entries_.push_back(pack(static_cast<std::size_t>(line - begin), length));
+                    if (entries_.size() * 2 > slots.size())
+                    {
+                        rehash();
+                    }
+                }
+            }
+
+            line = next + 1;
+        }
+    }
+}
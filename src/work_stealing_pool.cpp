@@ -0,0 +1,142 @@
+#include "randkey/work_stealing_pool.hpp"
+
+#include <algorithm>
+
+namespace randkey
+{
+    namespace
+    {
+        /// @brief 当前线程在所属线程池中的下标；非工作线程为 nullptr
+        thread_local const WorkStealingPool *current_pool = nullptr;
+        thread_local std::size_t current_index = 0;
+    }
+
+    WorkStealingPool::WorkStealingPool(std::size_t threads)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        queues_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+        {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+        {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void WorkStealingPool::submit(std::function<void()> task)
+    {
+        const std::size_t target = current_pool == this
+                                       ? current_index
+                                       : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            ++pending_;
+            ++queued_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        work_available_.notify_one();
+    }
+
+    void WorkStealingPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        all_done_.wait(lock, [&] { return pending_ == 0; });
+    }
+
+    std::size_t WorkStealingPool::size() const noexcept
+    {
+        return threads_.size();
+    }
+
+    bool WorkStealingPool::try_pop(std::size_t self, std::function<void()> &task)
+    {
+        {
+            Queue &own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (std::size_t offset = 1; offset < queues_.size(); ++offset)
+        {
+            Queue &victim = *queues_[(self + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkStealingPool::worker_loop(std::size_t self)
+    {
+        current_pool = this;
+        current_index = self;
+
+        for (;;)
+        {
+            std::function<void()> task;
+            if (try_pop(self, task))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(idle_mutex_);
+                    --queued_;
+                }
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                }
+                task = nullptr;
+
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                if (--pending_ == 0)
+                {
+                    all_done_.notify_all();
+                }
+                continue;
+            }
+
+            // queued_ 在入队前已递增：计数非零说明有任务尚未被取走（可能仍在入队途中），重新查找
+            std::unique_lock<std::mutex> lock(idle_mutex_);
+            work_available_.wait(lock, [&] { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0)
+            {
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <iostream>
+#include <ranges>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "randkey/key_plan.hpp"
+#include "randkey/key_sampling.hpp"
+#include "randkey/randkey.h"
+
+namespace
+{
+    int failures = 0;
+
+    void expect(bool condition, const std::string &message)
+    {
+        if (!condition)
+        {
+            std::cerr << "[c_api] " << message << std::endl;
+            ++failures;
+        }
+    }
+
+    randkey_plan *make_plan(std::vector<const char *> args)
+    {
+        randkey_plan *plan = nullptr;
+        const randkey_status status = randkey_plan_create(args.data(), args.size(), &plan);
+        expect(status == RANDKEY_OK && plan != nullptr, "plan creation should succeed: " + std::string(randkey_last_error()));
+        return plan;
+    }
+}
+
+int run_c_api_tests()
+{
+    {
+        randkey_plan *plan = make_plan({"--upper", "--digits", "--length", "16"});
+        expect(randkey_plan_max_key_bytes(plan) == 16, "ascii plan should bound keys by length");
+
+        char buffer[32];
+        std::size_t length = 0;
+        expect(randkey_generate_into(plan, nullptr, buffer, sizeof(buffer), &length) == RANDKEY_OK && length == 16,
+               "generate_into should write one key");
+        const std::string_view key(buffer, length);
+        expect(std::all_of(key.begin(), key.end(), [](char ch) { return (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9'); }),
+               "generated key should only use the plan charset");
+
+        expect(randkey_generate_into(plan, nullptr, buffer, 8, &length) == RANDKEY_ERROR_BUFFER_TOO_SMALL && length == 16,
+               "short buffers should report the required size");
+
+        std::vector<char> batch(17 * 4);
+        expect(randkey_generate_many_into(plan, nullptr, 5, batch.data(), batch.size(), &length) == RANDKEY_ERROR_BUFFER_TOO_SMALL &&
+                   length == 17 * 4,
+               "generate_many_into should stop at the last complete key");
+
+        // 多线程共享同一个计划与引擎句柄
+        randkey_engine *engine = nullptr;
+        expect(randkey_engine_create(&engine) == RANDKEY_OK, "engine creation should succeed");
+        std::vector<std::string> keys(400);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < 4; ++t)
+        {
+            workers.emplace_back([&, t] {
+                char local[16];
+                std::size_t written = 0;
+                for (std::size_t i = 0; i < 100; ++i)
+                {
+                    randkey_generate_into(plan, engine, local, sizeof(local), &written);
+                    keys[t * 100 + i].assign(local, written);
+                }
+            });
+        }
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+        expect(std::set<std::string>(keys.begin(), keys.end()).size() == keys.size(), "shared engine should produce distinct keys");
+        randkey_engine_destroy(engine);
+        randkey_plan_destroy(plan);
+    }
+
+    {
+        randkey_plan *plan = make_plan({"--append", "\xE8\xAA\x9E", "--length", "3"});
+        char buffer[16];
+        std::size_t length = 0;
+        randkey_generate_into(plan, nullptr, buffer, sizeof(buffer), &length);
+        expect(randkey_plan_max_key_bytes(plan) == 9 && std::string_view(buffer, length) == "\xE8\xAA\x9E\xE8\xAA\x9E\xE8\xAA\x9E",
+               "keys should be returned as UTF-8");
+        randkey_plan_destroy(plan);
+
+        randkey_plan *pattern = make_plan({"--pattern", "AA-99"});
+        randkey_generate_into(pattern, nullptr, buffer, sizeof(buffer), &length);
+        expect(length == 5 && buffer[2] == '-' && buffer[0] >= 'A' && buffer[4] <= '9', "pattern plans should follow the template");
+        randkey_plan_destroy(pattern);
+
+        randkey_plan *uuid = make_plan({"--id", "uuid4"});
+        char id[36];
+        expect(randkey_generate_into(uuid, nullptr, id, sizeof(id), &length) == RANDKEY_OK && length == 36 && id[14] == '4',
+               "id plans should format uuid4");
+        randkey_plan_destroy(uuid);
+
+        randkey_plan *raw = make_plan({"--raw-bytes", "4", "--raw-encoding", "hex"});
+        expect(randkey_plan_max_key_bytes(raw) == 8, "raw plans should report encoded size");
+        randkey_plan_destroy(raw);
+    }
+
+    {
+        const char *seeded[] = {"--seed-only", "1"};
+        randkey_plan *plan = nullptr;
+        expect(randkey_plan_create(seeded, 2, &plan) == RANDKEY_ERROR_ARGUMENT && plan == nullptr &&
+                   std::string_view(randkey_last_error()) == "error_plan_option",
+               "seeded plans should be rejected");
+
+        const char *invalid[] = {"--length", "0"};
+        expect(randkey_plan_create(invalid, 2, &plan) == RANDKEY_ERROR_ARGUMENT &&
+                   std::string_view(randkey_last_error()) == "error_length",
+               "invalid options should surface the CLI error key");
+        expect(std::string_view(randkey_version()).size() > 0, "version should be available");
+    }
+
+    {
+        randkey::GenerationOptions options;
+        options.registry.include(randkey::BuiltinCharset::Lowercase);
+        options.required_classes = {randkey::BuiltinCharset::Lowercase};
+        options.length = 6;
+        const randkey::KeyPlan plan = randkey::KeyPlan::compile(options);
+        randkey::KeyEngine engine;
+        const std::string key = plan.generate(engine);
+        expect(key.size() == 6 && std::all_of(key.begin(), key.end(), [](char ch) { return ch >= 'a' && ch <= 'z'; }),
+               "constrained plans should generate through KeyPlan");
+    }
+
+    {
+        // 2 的幂字符集与生成器共用位精确路径，跨越多个块时仍应覆盖全部字符
+        randkey_plan *plan = make_plan({"--hex", "--length", "200"});
+        char key[200];
+        std::size_t length = 0;
+        expect(randkey_generate_into(plan, nullptr, key, sizeof(key), &length) == RANDKEY_OK && length == 200 &&
+                   std::all_of(key, key + length, [](char ch) { return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f'); }),
+               "hex plans should generate through the bit-exact path");
+        randkey_plan_destroy(plan);
+
+        randkey::SecureRandomStream random;
+        std::vector<std::size_t> seen(32);
+        std::size_t positions = 0;
+        randkey::sampling::for_each_uniform_index(32, 4096, random, [&](std::size_t position, std::uint64_t index) {
+            positions += position == positions ? 1 : 0;
+            ++seen[static_cast<std::size_t>(index)];
+        });
+        expect(positions == 4096 && std::all_of(seen.begin(), seen.end(), [](std::size_t count) { return count > 0; }),
+               "shared uniform sampling should visit positions in order and cover every index");
+    }
+
+    {
+        static_assert(std::ranges::input_range<randkey::KeyView>);
+        static_assert(std::ranges::view<randkey::KeyView>);
+
+        randkey::GenerationOptions options;
+        options.registry.include(randkey::BuiltinCharset::Digits);
+        options.length = 8;
+        const randkey::KeyPlan plan = randkey::KeyPlan::compile(options);
+
+        std::vector<std::string> keys;
+        for (const std::string &key : plan.keys() | std::views::take(5))
+        {
+            keys.push_back(key);
+        }
+        expect(keys.size() == 5 && std::all_of(keys.begin(), keys.end(), [](const std::string &key) {
+                   return key.size() == 8 && std::all_of(key.begin(), key.end(), [](char ch) { return ch >= '0' && ch <= '9'; });
+               }),
+               "key views should compose with std::views::take");
+        expect(std::set<std::string>(keys.begin(), keys.end()).size() == 5, "key views should advance between elements");
+
+        randkey::KeyView view = plan.keys();
+        auto it = view.begin();
+        const std::string first = *it;
+        expect(*it == first, "dereferencing twice should not draw a new key");
+        ++it;
+        expect(*it != first, "incrementing should draw the next key lazily");
+
+        std::size_t total = 0;
+        for (std::size_t size : plan.keys() | std::views::take(1000) |
+                                    std::views::transform([](const std::string &key) { return key.size(); }))
+        {
+            total += size;
+        }
+        expect(total == 8000, "key views should feed further adaptors");
+    }
+
+    return failures;
+}
@@ -1,7 +1,9 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <random>
 
+#include "randkey/alias_table.hpp"
 #include "randkey/charset_registry.hpp"
 
 namespace
@@ -69,5 +71,111 @@ int run_charset_tests()
         expect(tokens.size() == 1 && tokens[0] == U"語言", "tokens should support multi-character phrases");
     }
 
+    {
+        const auto temp_path = std::filesystem::temp_directory_path() / "randkey_weighted_test.txt";
+        {
+            std::ofstream out(temp_path, std::ios::binary);
+            out << "alpha\t3\n"
+                << "beta\t0.5\r\n"
+                << "gamma\n"
+                << "alpha\t1\n";
+        }
+
+        CharsetRegistry registry;
+        registry.add_weighted_file(temp_path);
+        const auto tokens = registry.materialize();
+        const auto weights = registry.materialize_weights();
+        expect(registry.weighted(), "weighted file should mark registry as weighted");
+        expect(tokens.size() == 3 && weights.size() == 3, "weighted tokens should be deduplicated");
+        expect(weights[0] == 4.0 && weights[1] == 0.5 && weights[2] == 1.0,
+               "duplicate weighted tokens should accumulate and missing weights default to 1");
+
+        {
+            std::ofstream out(temp_path, std::ios::binary);
+            out << "bad\t-1\n";
+        }
+        bool threw = false;
+        try
+        {
+            CharsetRegistry invalid;
+            invalid.add_weighted_file(temp_path);
+        }
+        catch (const std::exception &)
+        {
+            threw = true;
+        }
+        expect(threw, "non-positive weights should be rejected");
+
+        std::filesystem::remove(temp_path);
+    }
+
+    {
+        static_assert(CharsetBitmap(U"abc").count() == 3 && CharsetBitmap(U"abc").test(U'b'));
+        static_assert((CharsetBitmap(U"abc") - CharsetBitmap(U"b")).count() == 2);
+        static_assert((CharsetBitmap(U"abc") & CharsetBitmap(U"bcd")).count() == 2);
+
+        CharsetBitmap wide(U"a語😀");
+        wide |= CharsetBitmap(U"b語");
+        expect(wide.count() == 4 && wide.test(U'語') && wide.test(U'😀') && !wide.test(U'言'),
+               "bitmaps should cover ASCII, BMP and astral code points");
+        wide -= CharsetBitmap(U"😀語");
+        expect(wide.count() == 2 && !wide.test(U'語') && !wide.test(U'😀'), "bitmap difference should clear every plane");
+
+        expect(CharsetRegistry::builtin_bitmap(BuiltinCharset::Hex).count() == 16 &&
+                   CharsetRegistry::builtin_bitmap(BuiltinCharset::Special).test(U'~'),
+               "builtin bitmaps should match their tables");
+    }
+
+    {
+        CharsetRegistry registry;
+        registry.include(BuiltinCharset::Uppercase);
+        registry.include(BuiltinCharset::Digits);
+        registry.add_characters(U"A語");
+        registry.add_token(U"9");
+        registry.exclude_characters(U"0O1I語");
+        const auto tokens = registry.materialize();
+        expect(tokens.size() == 32 && tokens.front() == U"A" && tokens[23] == U"Z" && tokens[24] == U"2",
+               "exclusions should drop characters while keeping insertion order");
+        expect(registry.contains(U'Z') && !registry.contains(U'O') && !registry.contains(U'語') &&
+                   registry.characters().count() == 32,
+               "membership should be answered from the bitmap");
+
+        CharsetRegistry defaults;
+        defaults.exclude_characters(U"abc");
+        const auto compiled = defaults.compile();
+        expect(compiled->tokens.size() == 33 && compiled->tokens.front() == U"d",
+               "exclusions should apply to the default charset");
+
+        CharsetRegistry weighted;
+        weighted.add_characters(U"xy");
+        weighted.add_weighted_token(U"y", 2.0);
+        weighted.add_weighted_token(U"xy", 3.0);
+        weighted.exclude_characters(U"x");
+        const auto weighted_tokens = weighted.materialize();
+        const auto weighted_weights = weighted.materialize_weights();
+        expect(weighted_tokens.size() == 2 && weighted_tokens[0] == U"y" && weighted_weights[0] == 3.0 &&
+                   weighted_tokens[1] == U"xy",
+               "weighted single characters should accumulate and multi-character tokens survive exclusions");
+    }
+
+    {
+        const double weights[] = {1.0, 2.0, 3.0, 4.0};
+        const AliasTable table(weights);
+        std::mt19937_64 engine(7);
+        std::size_t histogram[4] = {};
+        for (int i = 0; i < 100000; ++i)
+        {
+            ++histogram[table.sample([&] { return engine(); })];
+        }
+
+        bool close = true;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            const double expected = 100000.0 * weights[i] / 10.0;
+            close = close && histogram[i] > expected * 0.95 && histogram[i] < expected * 1.05;
+        }
+        expect(close, "alias table should follow the weight distribution");
+    }
+
     return failures;
 }
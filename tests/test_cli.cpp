@@ -1,11 +1,37 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <set>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <vector>
 
+#include "randkey/batch.hpp"
+#include "randkey/checkpoint.hpp"
 #include "randkey/encoding.hpp"
 #include "randkey/generator.hpp"
+#include "randkey/key_hash.hpp"
+#include "randkey/key_ring.hpp"
+#include "randkey/key_server.hpp"
+#include "randkey/key_verifier.hpp"
+#include "randkey/platform/shared_memory.hpp"
+#include "randkey/work_stealing_pool.hpp"
 #include "randkey/options.hpp"
+#include "randkey/output_tee.hpp"
+#include "randkey/run_stats.hpp"
+#include "randkey/trace.hpp"
+#include "randkey/platform/local_socket.hpp"
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace
 {
@@ -89,5 +115,654 @@ int run_cli_tests()
         expect(false, "output file should exist after manual write");
     }
 
+    {
+        const char *exclude_argv[] = {"randkey", "--upper", "--exclude", "OI", "--length", "4"};
+        const auto excluded = parser.parse(static_cast<int>(std::size(exclude_argv)), exclude_argv);
+        expect(excluded.options.registry.compile()->tokens.size() == 24, "--exclude should shrink the charset");
+
+        bool rejected = false;
+        try
+        {
+            const char *bad_argv[] = {"randkey", "--pattern", "AAAA", "--exclude", "O"};
+            parser.parse(static_cast<int>(std::size(bad_argv)), bad_argv);
+        }
+        catch (const std::runtime_error &error)
+        {
+            rejected = std::string(error.what()) == "error_exclude_chars_mode";
+        }
+        expect(rejected, "--exclude should be rejected outside charset generation");
+    }
+
+    {
+        const char *shard_argv[] = {"randkey", "--shard", "1/3", "--count", "10", "--seed-only", "5"};
+        const auto sharded = parser.parse(static_cast<int>(std::size(shard_argv)), shard_argv);
+        expect(sharded.options.start_index == 3 && sharded.options.count == 3, "--shard should resolve to a key range");
+
+        bool rejected = false;
+        try
+        {
+            const char *bad_argv[] = {"randkey", "--shard", "3/3"};
+            parser.parse(static_cast<int>(std::size(bad_argv)), bad_argv);
+        }
+        catch (const std::exception &)
+        {
+            rejected = true;
+        }
+        expect(rejected, "shard index outside range should be rejected");
+    }
+
+    {
+        RunningDigest whole;
+        RunningDigest pieces;
+        whole.update("checkpoint-digest-data");
+        pieces.update("check");
+        pieces.update("point-digest-");
+        pieces.update("data");
+        expect(whole.value() == pieces.value() && whole.bytes() == 22, "running digest should not depend on chunking");
+
+        GenerationOptions options;
+        options.length = 8;
+        options.count = 10;
+        options.checkpoint_interval = 3;
+
+        std::ostringstream full_stream;
+        RunningDigest digest;
+        std::vector<Checkpoint> checkpoints;
+        {
+            OutputWriter writer(full_stream);
+            writer.track_digest(digest);
+            generator.generate(options, writer, 99ULL, std::nullopt, [&](std::uint64_t next_index) {
+                Checkpoint checkpoint;
+                checkpoint.next_index = next_index;
+                checkpoint.bytes = digest.bytes();
+                checkpoint.digest = digest.value();
+                checkpoint.deterministic_seed = 99ULL;
+                checkpoints.push_back(checkpoint);
+            });
+        }
+        expect(checkpoints.size() == 3 && checkpoints[1].next_index == 6, "checkpoints should follow the interval");
+
+        // 模拟在第二个断点之后崩溃：文件中残留半行
+        const auto output = std::filesystem::temp_directory_path() / "randkey_resume_test.txt";
+        const auto checkpoint_path = Checkpoint::path_for(output);
+        checkpoints[1].save(checkpoint_path);
+        expect(std::filesystem::exists(checkpoint_path) && !std::filesystem::exists(Checkpoint::temp_path_for(checkpoint_path)),
+               "checkpoint save should rename its synced temp file into place");
+        {
+            std::ofstream out(output, std::ios::binary);
+            out << full_stream.str().substr(0, checkpoints[1].bytes) << "PARTIAL";
+        }
+
+        const Checkpoint loaded = Checkpoint::load(checkpoint_path);
+        RunningDigest resumed_digest;
+        truncate_to_checkpoint(output, loaded, resumed_digest);
+        {
+            std::ofstream out(output, std::ios::binary | std::ios::app);
+            OutputWriter writer(out);
+            writer.track_digest(resumed_digest);
+            GenerationOptions rest = options;
+            rest.start_index = static_cast<std::size_t>(loaded.next_index);
+            rest.count = options.count - rest.start_index;
+            generator.generate(rest, writer, loaded.deterministic_seed, std::nullopt);
+        }
+
+        std::ifstream in(output, std::ios::binary);
+        const std::string resumed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        expect(resumed == full_stream.str() && resumed_digest.value() == digest.value(),
+               "deterministic resume should be byte-identical to an uninterrupted run");
+
+        std::filesystem::remove(output);
+        std::filesystem::remove(checkpoint_path);
+    }
+
+    // 以 RANDKEY_ENABLE_STATS=OFF 构建时 --stats 会被拒绝
+    if (stats::compiled_in())
+    {
+        const char *stats_argv[] = {"randkey", "--digits", "--length", "10", "--count", "500", "--stats-json"};
+        const ParsedArguments stats_args = ArgumentParser().parse(static_cast<int>(std::size(stats_argv)), stats_argv);
+        expect(stats_args.options.stats == StatsFormat::Json, "--stats-json should select JSON statistics");
+
+        stats::enable();
+        const stats::Snapshot before = stats::snapshot();
+        std::ostringstream sink;
+        {
+            OutputWriter writer(sink);
+            RandomKeyGenerator().generate(stats_args.options, writer);
+        }
+        const stats::Snapshot after = stats::snapshot();
+        auto delta = [&](stats::Counter counter) { return after.count(counter) - before.count(counter); };
+        expect(delta(stats::Counter::UniformDraws) == 5000 && delta(stats::Counter::EntropyReads) > 0 &&
+                   delta(stats::Counter::WrittenBytes) == sink.str().size(),
+               "statistics should count uniform draws, entropy reads and written bytes");
+
+        // 退出线程的计数并入汇总
+        std::thread([] { stats::add(stats::Counter::Transcodes, 7); }).join();
+        expect(stats::snapshot().count(stats::Counter::Transcodes) - after.count(stats::Counter::Transcodes) == 7,
+               "counters of finished threads should be retained");
+
+        stats::RunReport report;
+        report.keys = 500;
+        report.elapsed_ns = 1000000000;
+        report.snapshot.counters[static_cast<std::size_t>(stats::Counter::UniformDraws)] = 3;
+        report.snapshot.counters[static_cast<std::size_t>(stats::Counter::UniformRejections)] = 1;
+        std::ostringstream json;
+        report.write_json(json);
+        expect(report.rejection_rate() == 0.25 && report.keys_per_second() == 500.0 &&
+                   json.str().find("\"rejection_rate\": 0.25") != std::string::npos,
+               "run report should derive rates and serialise them");
+    }
+
+    {
+        const char *plain_argv[] = {"randkey", "--digits", "--count", "40"};
+        const char *traced_argv[] = {"randkey", "--digits", "--trace", "run.json", "--count", "40"};
+        const ParsedArguments plain = ArgumentParser().parse(static_cast<int>(std::size(plain_argv)), plain_argv);
+        const ParsedArguments traced = ArgumentParser().parse(static_cast<int>(std::size(traced_argv)), traced_argv);
+        expect(traced.options.trace_path == std::filesystem::path("run.json") &&
+                   traced.config_fingerprint == plain.config_fingerprint,
+               "--trace should not change the checkpoint fingerprint");
+
+        trace::start();
+        std::ostringstream sink;
+        {
+            OutputWriter writer(sink);
+            RandomKeyGenerator().generate(traced.options, writer);
+        }
+        std::thread([] { trace::Span span("worker_span", 7); }).join();
+
+        std::ostringstream json;
+        trace::write_chrome_trace(json);
+        const std::string events = json.str();
+        expect(events.find("\"traceEvents\"") != std::string::npos &&
+                   events.find("{\"name\": \"generate\", \"cat\": \"randkey\", \"ph\": \"X\"") != std::string::npos &&
+                   events.find("\"args\": {\"value\": 40}") != std::string::npos,
+               "trace should export generate spans with their key count");
+        const auto worker = events.find("\"worker_span\"");
+        const auto generate = events.find("\"generate\"");
+        const auto tid_of = [&](std::size_t at) {
+            const auto begin = events.find("\"tid\": ", at) + 7;
+            return events.substr(begin, events.find(',', begin) - begin);
+        };
+        expect(worker != std::string::npos && tid_of(worker) != tid_of(generate),
+               "spans from another thread should be recorded under their own tid");
+    }
+
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "randkey_tee_test";
+        std::filesystem::create_directories(dir);
+        const std::string text_spec = "text:" + (dir / "keys.txt").string();
+        const std::string csv_spec = "csv:" + (dir / "meta.csv").string();
+        const std::string hash_spec = "sha256:" + (dir / "keys.sha256").string();
+        const std::string bin_spec = "sha256-bin:" + (dir / "keys.bin").string();
+        const char *tee_argv[] = {"randkey", "--seed-only", "5", "--base64url", "--length", "24", "--count", "9000",
+                                  "--start-index", "100", "--output-format", text_spec.c_str(),
+                                  "--output-format", csv_spec.c_str(), "--output-format", hash_spec.c_str(),
+                                  "--output-format", bin_spec.c_str(), "--force"};
+        const ParsedArguments tee_args = ArgumentParser().parse(static_cast<int>(std::size(tee_argv)), tee_argv);
+        const GenerationOptions &options = tee_args.options;
+        expect(options.tee_targets.size() == 4 && options.tee_targets[1].format == TeeFormat::Csv,
+               "--output-format should be repeatable");
+
+        std::ostringstream primary;
+        {
+            TeeWriter tee(options.tee_targets, options.force_overwrite, options.start_index);
+            {
+                OutputWriter writer(primary);
+                writer.tee(tee);
+                RandomKeyGenerator().generate(options, writer, tee_args.deterministic_seed, std::nullopt);
+            }
+            tee.close();
+        }
+
+        auto slurp = [](const std::filesystem::path &path) {
+            std::ifstream in(path, std::ios::binary);
+            return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        };
+        const std::string keys = primary.str();
+        expect(slurp(dir / "keys.txt") == keys, "text sink should match the primary output byte for byte");
+
+        std::istringstream key_lines(keys);
+        std::istringstream csv(slurp(dir / "meta.csv"));
+        std::istringstream hashes(slurp(dir / "keys.sha256"));
+        const std::string binary = slurp(dir / "keys.bin");
+        std::string key;
+        std::string row;
+        std::string hex;
+        std::getline(csv, row);
+        bool sinks_match = row == "index,bytes,sha256" && binary.size() == 9000U * 32U;
+        for (std::size_t i = 0; std::getline(key_lines, key); ++i)
+        {
+            std::string expected_hex;
+            const KeyDigest digest = sha256(key);
+            append_digest_hex(expected_hex, digest);
+            sinks_match = sinks_match && std::getline(csv, row) && std::getline(hashes, hex) &&
+                          row == std::to_string(100 + i) + ",24," + expected_hex && hex == expected_hex &&
+                          binary.compare(i * 32, 32, reinterpret_cast<const char *>(digest.data()), 32) == 0;
+        }
+        expect(sinks_match, "csv, digest and binary sinks should follow the primary output in order");
+        std::filesystem::remove_all(dir);
+
+        auto rejects = [](std::vector<const char *> args, const std::string &code) {
+            try
+            {
+                ArgumentParser().parse(static_cast<int>(args.size()), args.data());
+            }
+            catch (const std::runtime_error &error)
+            {
+                return std::string(error.what()).rfind(code, 0) == 0;
+            }
+            return false;
+        };
+        expect(rejects({"randkey", "--output-format", "xml:a.xml"}, "error_output_format") &&
+                   rejects({"randkey", "--raw-bytes", "8", "--output-format", "text:a.txt"}, "error_output_format_mode") &&
+                   rejects({"randkey", "--output", "a.txt", "--output-format", "csv:a.txt"}, "error_output_format_path"),
+               "invalid --output-format combinations should be rejected");
+    }
+
+    {
+        const ServeProfile profile = parse_serve_profile("pin --digits --length 6");
+        expect(profile.name == "pin" && profile.options.length == 6, "serve profile should parse its options");
+
+        bool rejected = false;
+        try
+        {
+            parse_serve_profile("fixed --seed-only 1");
+        }
+        catch (const std::exception &)
+        {
+            rejected = true;
+        }
+        expect(rejected, "serve profiles should reject deterministic seeds");
+
+        rejected = false;
+        try
+        {
+            parse_serve_profile("distinct --unique");
+        }
+        catch (const std::exception &)
+        {
+            rejected = true;
+        }
+        expect(rejected, "serve profiles should reject --unique, which cannot hold across refill batches");
+
+        {
+            // 容量 64 时每批 16 个，取 200 个跨越多批
+            KeyServer ids({parse_serve_profile("ids --id ulid")}, 64);
+            const std::string batch = ids.handle(KeyServer::encode_request("ids", 200));
+            std::vector<std::string> lines;
+            std::istringstream stream(batch.substr(1));
+            for (std::string line; std::getline(stream, line);)
+            {
+                lines.push_back(line);
+            }
+            expect(batch[0] == '\0' && lines.size() == 200 && std::is_sorted(lines.begin(), lines.end()) &&
+                       std::adjacent_find(lines.begin(), lines.end()) == lines.end(),
+                   "serve ulid profiles should stay monotonic across refill batches");
+        }
+
+        KeyServer server({profile}, 64);
+        const std::string response = server.handle(KeyServer::encode_request("pin", 100));
+        std::size_t lines = 0;
+        bool digits_only = response.size() > 1 && response[0] == '\0';
+        for (std::size_t i = 1; i < response.size(); ++i)
+        {
+            if (response[i] == '\n')
+            {
+                ++lines;
+            }
+            else if (response[i] < '0' || response[i] > '9')
+            {
+                digits_only = false;
+            }
+        }
+        expect(digits_only && lines == 100 && response.size() == 1 + 100 * 7, "serve should vend batches larger than the pool");
+
+        const std::string fallback = server.handle(KeyServer::encode_request("", 1));
+        expect(fallback.size() == 1 + 13 && fallback[0] == '\0', "empty profile name should use the default profile");
+        expect(server.handle(KeyServer::encode_request("missing", 1))[0] == '\1', "unknown profile should be an error");
+        expect(server.handle(KeyServer::encode_request("pin", 0))[0] == '\1', "zero count should be an error");
+
+#if !defined(_WIN32)
+        const auto socket_path = std::filesystem::temp_directory_path() / "randkey_serve_test.sock";
+        std::atomic<bool> stop{false};
+        std::thread daemon([&] {
+            platform::serve_local_socket(socket_path, [&](std::string_view request) { return server.handle(request); }, stop);
+        });
+
+        std::string remote;
+        for (int attempt = 0; attempt < 200 && remote.empty(); ++attempt)
+        {
+            try
+            {
+                platform::LocalSocketClient client(socket_path);
+                remote = client.request(KeyServer::encode_request("pin", 5));
+                remote += client.request(KeyServer::encode_request("pin", 5)).substr(1);
+            }
+            catch (const std::exception &)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        const auto socket_perms = std::filesystem::status(socket_path).permissions() & std::filesystem::perms::all;
+        bool live_rejected = false;
+        try
+        {
+            std::atomic<bool> second_stop{true};
+            platform::serve_local_socket(socket_path, [](std::string_view) { return std::string(); }, second_stop);
+        }
+        catch (const std::runtime_error &)
+        {
+            live_rejected = true;
+        }
+        stop.store(true);
+        daemon.join();
+        expect(remote.size() == 1 + 10 * 7 && remote[0] == '\0', "socket round trip should return framed keys");
+        expect(socket_perms == (std::filesystem::perms::owner_read | std::filesystem::perms::owner_write),
+               "serve socket should be owner-only");
+        expect(live_rejected, "serve should not take over a socket that is still accepting connections");
+        expect(!std::filesystem::exists(socket_path), "serve should remove its socket on shutdown");
+
+        std::ofstream(socket_path) << "precious";
+        bool file_rejected = false;
+        try
+        {
+            std::atomic<bool> file_stop{true};
+            platform::serve_local_socket(socket_path, [](std::string_view) { return std::string(); }, file_stop);
+        }
+        catch (const std::runtime_error &error)
+        {
+            file_rejected = std::string(error.what()).rfind("error_serve_socket:", 0) == 0;
+        }
+        expect(file_rejected && std::filesystem::is_regular_file(socket_path),
+               "serve should refuse to replace a non-socket file at its path");
+        std::filesystem::remove(socket_path);
+#endif
+    }
+
+    {
+        std::atomic<int> executed{0};
+        {
+            WorkStealingPool pool(4);
+            for (int i = 0; i < 100; ++i)
+            {
+                pool.submit([&] {
+                    pool.submit([&] { executed.fetch_add(1); });
+                    executed.fetch_add(1);
+                });
+            }
+            pool.wait();
+            expect(executed.load() == 200, "work stealing pool should run nested submissions before wait returns");
+        }
+
+        const ParsedArguments job = parse_batch_job(R"({"args": ["--digits", "-l", "6", "-c", "3"], "output": "pins.txt"})");
+        expect(job.options.length == 6 && job.options.count == 3 && job.options.output_path == std::filesystem::path("pins.txt"),
+               "batch job should parse args and output");
+        const ParsedArguments spaced = parse_batch_job(R"({"args": "--upper --length 4 --output \u0061.txt"})");
+        expect(spaced.options.output_path == std::filesystem::path("a.txt"), "batch job should accept a whitespace-separated args string");
+
+        auto rejects = [&](std::string_view line) {
+            try
+            {
+                parse_batch_job(line);
+            }
+            catch (const std::exception &)
+            {
+                return true;
+            }
+            return false;
+        };
+        expect(rejects(R"({"args": ["--digits"]})"), "batch jobs without an output file should be rejected");
+        expect(rejects(R"({"args": [], "output": "x.txt", "extra": "1"})"), "unknown job fields should be rejected");
+        expect(rejects(R"({"args": ["--digits"], "output": "x.txt")"), "truncated job JSON should be rejected");
+
+        const auto dir = std::filesystem::temp_directory_path() / "randkey_batch_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        const auto big = dir / "big.txt";
+        const auto small = dir / "small.txt";
+        const auto phrase = dir / "words.txt";
+        {
+            std::ofstream words(phrase);
+            words << "alpha\nbeta\ngamma\ndelta\n";
+        }
+
+        std::vector<BatchJob> jobs;
+        jobs.push_back(BatchJob{1, parse_batch_job("{\"args\": \"-S 5 --upper --digits -l 10 -c 200000\", \"output\": \"" + big.generic_string() + "\"}")});
+        jobs.push_back(BatchJob{2, parse_batch_job("{\"args\": \"-S 5 --upper --digits -l 4 -c 7\", \"output\": \"" + small.generic_string() + "\"}")});
+        jobs.push_back(BatchJob{3, parse_batch_job("{\"args\": \"--passphrase " + phrase.generic_string() + " --count 2\", \"output\": \"" + (dir / "missing" / "x.txt").generic_string() + "\"}")});
+        const BatchReport report = run_batch(std::move(jobs), 4);
+
+        GenerationOptions expected_options;
+        expected_options.registry.include(BuiltinCharset::Uppercase);
+        expected_options.registry.include(BuiltinCharset::Digits);
+        expected_options.length = 10;
+        expected_options.count = 200000;
+        std::ostringstream expected;
+        {
+            OutputWriter writer(expected);
+            generator.generate(expected_options, writer, 5ULL, std::nullopt);
+        }
+        std::ifstream in(big, std::ios::binary);
+        const std::string produced((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+
+        expect(produced == expected.str(), "chunked batch job should match a single uninterrupted run");
+        expect(std::filesystem::file_size(small) == 7 * 5, "small batch job should write its own file");
+        expect(report.failures.size() == 1 && report.failures[0].line == 3, "batch should report the failing job by line");
+        expect(report.charset_tables == 2, "identical charsets should share one compiled table");
+
+        // 超过一个块（65536 个）的 ulid 作业必须整体生成，跨块边界仍保持单调
+        const auto ids = dir / "ids.txt";
+        std::vector<BatchJob> id_jobs;
+        id_jobs.push_back(BatchJob{1, parse_batch_job("{\"args\": [\"--id\", \"ulid\", \"-c\", \"70000\"], \"output\": \"" + ids.generic_string() + "\"}")});
+        expect(run_batch(std::move(id_jobs), 4).failures.empty(), "ulid batch job should succeed");
+        std::vector<std::string> id_lines;
+        {
+            std::ifstream id_file(ids);
+            for (std::string line; std::getline(id_file, line);)
+            {
+                id_lines.push_back(std::move(line));
+            }
+        }
+        expect(id_lines.size() == 70000 && std::is_sorted(id_lines.begin(), id_lines.end()) &&
+                   std::adjacent_find(id_lines.begin(), id_lines.end()) == id_lines.end(),
+               "ulid batch jobs should stay monotonic across the chunk boundary");
+        std::filesystem::remove_all(dir);
+    }
+
+#if !defined(_WIN32)
+    {
+        const std::string ring_name = key_ring_name("randkey-test", "ring");
+        std::atomic<bool> stop{false};
+        std::set<std::string> claimed;
+        {
+            KeyRingProducer producer(ring_name, 8);
+            expect(producer.slots() == 8, "ring slot count should round to a power of two");
+
+            std::thread publisher([&] {
+                for (int i = 0; i < 400; ++i)
+                {
+                    producer.publish("key-" + std::to_string(i), stop);
+                }
+            });
+
+            std::mutex guard;
+            std::vector<std::thread> consumers;
+            for (int worker = 0; worker < 4; ++worker)
+            {
+                consumers.emplace_back([&] {
+                    KeyRingClient client(ring_name);
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        std::string key = client.claim();
+                        std::lock_guard<std::mutex> lock(guard);
+                        claimed.insert(std::move(key));
+                    }
+                });
+            }
+            publisher.join();
+            for (auto &consumer : consumers)
+            {
+                consumer.join();
+            }
+
+            // 全部领取后，区域中不应残留任何密钥字节
+            const auto region = platform::SharedMemory::open(ring_name);
+            const auto bytes = region.bytes();
+            const std::string_view view(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+            expect(view.find("key-") == std::string_view::npos, "claimed ring slots should be wiped");
+
+            bool oversized = false;
+            try
+            {
+                producer.publish(std::string(KEY_RING_SLOT_BYTES + 1, 'x'), stop);
+            }
+            catch (const std::exception &)
+            {
+                oversized = true;
+            }
+            expect(oversized, "keys longer than a ring slot should be rejected");
+        }
+        expect(claimed.size() == 400 && claimed.count("key-0") == 1 && claimed.count("key-399") == 1,
+               "concurrent ring consumers should each claim distinct keys");
+
+        bool closed = false;
+        try
+        {
+            KeyRingClient client(ring_name);
+        }
+        catch (const std::exception &)
+        {
+            closed = true;
+        }
+        expect(closed, "ring should be unlinked when the producer is destroyed");
+    }
+
+    {
+        // 消费方在空环上等待时被杀死：其票号对应的槽位应在超时后被生产端收回，环不停滞
+        const std::string ring_name = key_ring_name("randkey-test", "abandon");
+        std::atomic<bool> stop{false};
+        KeyRingProducer producer(ring_name, 2, std::chrono::milliseconds(50));
+
+        const pid_t child = ::fork();
+        if (child == 0)
+        {
+            KeyRingClient client(ring_name);
+            client.claim();
+            ::_exit(0);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+
+        std::thread publisher([&] {
+            for (int i = 0; i < 4; ++i)
+            {
+                producer.publish("abandon-" + std::to_string(i), stop);
+            }
+        });
+        KeyRingClient client(ring_name);
+        std::set<std::string> received;
+        for (int i = 0; i < 3; ++i)
+        {
+            received.insert(client.claim());
+        }
+        publisher.join();
+
+        const auto region = platform::SharedMemory::open(ring_name);
+        const auto bytes = region.bytes();
+        const std::string_view view(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        expect(producer.reclaimed() == 1 && received.count("abandon-0") == 0 && received.size() == 3 &&
+                   view.find("abandon-0") == std::string_view::npos,
+               "slots abandoned by a dead consumer should be reclaimed and wiped");
+    }
+#endif
+
+    {
+        const VerifyArguments verify = parse_verify_arguments(
+            {"--input", "keys.txt", "--upper", "--digits", "--exclude", "O", "--length", "6", "--require", "upper,digit"});
+        expect(verify.input == "keys.txt" && verify.check_length, "verify arguments should split --input from policy flags");
+        const KeyPolicy policy = KeyPolicy::from_options(verify.policy.options, verify.check_length);
+
+        auto kind_of = [&](std::string_view key) {
+            const auto violation = policy.check(key);
+            return violation.has_value() ? static_cast<int>(violation->kind) : -1;
+        };
+        expect(kind_of("AB12CD") == -1, "conforming keys should pass");
+        expect(kind_of("AB12cd") == static_cast<int>(ViolationKind::Charset) && policy.check("AB12cd")->detail == 5,
+               "charset violations should report the first offending position");
+        expect(kind_of("AO12CD") == static_cast<int>(ViolationKind::Charset), "excluded characters should be violations");
+        expect(kind_of("AB12C") == static_cast<int>(ViolationKind::Length), "length should be enforced when given");
+        expect(kind_of("ABCDEF") == static_cast<int>(ViolationKind::Required), "required classes should be enforced");
+        expect(kind_of("AB\xC3") == static_cast<int>(ViolationKind::Encoding), "truncated UTF-8 should be rejected");
+        expect(kind_of("") == static_cast<int>(ViolationKind::Empty), "empty keys should be rejected");
+
+        bool rejected = false;
+        try
+        {
+            const VerifyArguments pattern = parse_verify_arguments({"--input", "keys.txt", "--pattern", "AAAA"});
+            KeyPolicy::from_options(pattern.policy.options, false);
+        }
+        catch (const std::runtime_error &error)
+        {
+            rejected = std::string(error.what()) == "error_verify_mode";
+        }
+        expect(rejected, "verify should reject non-charset modes");
+
+        // 块扫描的快速路径必须与逐行完整校验一致：随机行长跨越 64 字节块边界，混入非成员字节与 CRLF
+        std::mt19937_64 engine(42);
+        const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        std::string text;
+        std::vector<std::string> lines;
+        for (int i = 0; i < 5000; ++i)
+        {
+            std::string line;
+            const std::size_t length = 4 + engine() % 5;
+            for (std::size_t j = 0; j < length; ++j)
+            {
+                line.push_back(alphabet[engine() % alphabet.size()]);
+            }
+            switch (engine() % 16)
+            {
+            case 0:
+                line[engine() % line.size()] = 'o';
+                break;
+            case 1:
+                line.insert(engine() % line.size(), "\xE8\xAA\x9E");
+                break;
+            case 2:
+                line.clear();
+                break;
+            default:
+                break;
+            }
+            lines.push_back(line);
+            text += line;
+            text += engine() % 4 == 0 ? "\r\n" : "\n";
+        }
+        text += "ABC123";
+        lines.emplace_back("ABC123");
+
+        std::vector<KeyViolation> reported;
+        const VerifyReport report = policy.verify(std::as_bytes(std::span<const char>(text.data(), text.size())),
+                                                  [&](const KeyViolation &violation) { reported.push_back(violation); });
+        std::vector<KeyViolation> expected;
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            if (auto violation = policy.check(lines[i]))
+            {
+                violation->line = i + 1;
+                expected.push_back(*violation);
+            }
+        }
+        bool same = report.keys == lines.size() && report.violations == expected.size() && reported.size() == expected.size();
+        for (std::size_t i = 0; same && i < expected.size(); ++i)
+        {
+            same = reported[i].line == expected[i].line && reported[i].kind == expected[i].kind &&
+                   reported[i].detail == expected[i].detail;
+        }
+        expect(same && !expected.empty(), "block-scanned verification should match per-line checks");
+    }
+
     return failures;
 }
@@ -0,0 +1,176 @@
+#include <array>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "randkey/binary_codec.hpp"
+#include "randkey/id_format.hpp"
+#include "randkey/key_hash.hpp"
+#include "randkey/output_writer.hpp"
+
+namespace
+{
+    int failures = 0;
+
+    void expect(bool condition, const std::string &message)
+    {
+        if (!condition)
+        {
+            std::cerr << "[codec] " << message << std::endl;
+            ++failures;
+        }
+    }
+
+    std::string encode(std::string_view input, randkey::BinaryEncoding encoding)
+    {
+        std::string out;
+        randkey::append_encoded(out, std::as_bytes(std::span<const char>(input.data(), input.size())), encoding);
+        expect(out.size() == randkey::encoded_size(input.size(), encoding),
+               "encoded_size should match output for \"" + std::string(input) + "\"");
+        return out;
+    }
+
+    std::string digest_hex(const randkey::KeyDigest &digest)
+    {
+        std::string out;
+        randkey::append_digest_hex(out, digest);
+        return out;
+    }
+
+    std::string pattern_bytes(std::size_t size)
+    {
+        std::string out(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out[i] = static_cast<char>(i % 251);
+        }
+        return out;
+    }
+}
+
+int run_codec_tests()
+{
+    using namespace randkey;
+
+    // RFC 4648 第 10 节测试向量
+    const std::string_view inputs[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    const std::string_view base64[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    const std::string_view base32[] = {"", "MY======", "MZXQ====", "MZXW6===", "MZXW6YQ=", "MZXW6YTB", "MZXW6YTBOI======"};
+    const std::string_view hex[] = {"", "66", "666f", "666f6f", "666f6f62", "666f6f6261", "666f6f626172"};
+
+    for (std::size_t i = 0; i < std::size(inputs); ++i)
+    {
+        const std::string label(inputs[i]);
+        expect(encode(inputs[i], BinaryEncoding::Base64) == base64[i], "base64 mismatch for \"" + label + "\"");
+        expect(encode(inputs[i], BinaryEncoding::Base32) == base32[i], "base32 mismatch for \"" + label + "\"");
+        expect(encode(inputs[i], BinaryEncoding::Hex) == hex[i], "hex mismatch for \"" + label + "\"");
+
+        std::string unpadded(base64[i]);
+        unpadded.erase(unpadded.find_last_not_of('=') + 1);
+        expect(encode(inputs[i], BinaryEncoding::Base64Url) == unpadded, "base64url mismatch for \"" + label + "\"");
+    }
+
+    expect(encode("\xfb\xff", BinaryEncoding::Base64Url) == "-_8", "base64url should use url-safe alphabet");
+    expect(parse_binary_encoding(U"base64url") == BinaryEncoding::Base64Url, "encoding names should parse");
+
+    {
+        std::array<std::byte, IdFormatter::RANDOM_BYTES> random{};
+        random.fill(std::byte{0xFF});
+
+        IdFormatter v4(IdFormat::UuidV4);
+        std::string uuid;
+        v4.append_next(random, 0, uuid);
+        expect(uuid == "ffffffff-ffff-4fff-bfff-ffffffffffff", "uuid4 should set version and variant bits");
+
+        IdFormatter v7(IdFormat::UuidV7);
+        std::string first;
+        std::string second;
+        v7.append_next(random, 0x0123456789ABULL, first);
+        v7.append_next(random, 0x0123456789AAULL, second);
+        expect(first.substr(0, 14) == "01234567-89ab-" && first[14] == '7' && first[19] == 'b',
+               "uuid7 should encode timestamp, version and variant");
+        expect(second > first, "uuid7 should stay monotonic when the clock goes backwards");
+
+        random.fill(std::byte{0});
+        IdFormatter ulid(IdFormat::Ulid);
+        std::string a;
+        std::string b;
+        ulid.append_next(random, 1469918176385ULL, a);
+        ulid.append_next(random, 1469918176385ULL, b);
+        expect(a == "01ARYZ6S410000000000000000", "ulid should encode timestamp in Crockford base32");
+        expect(b == "01ARYZ6S410000000000000001" && b > a, "ulid should increment within the same millisecond");
+    }
+
+    {
+        using randkey::KeyHashAlgorithm;
+        expect(digest_hex(randkey::sha256("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+               "sha256 should match the FIPS 180-2 vector");
+        expect(digest_hex(randkey::sha256(std::string(56, 'a'))) == "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a",
+               "sha256 should pad into a second block at 56 bytes");
+        expect(digest_hex(randkey::blake3("")) == "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" &&
+                   digest_hex(randkey::blake3("abc")) == "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85",
+               "blake3 should match the reference for single-block inputs");
+        expect(digest_hex(randkey::blake3(pattern_bytes(1025))) == "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444" &&
+                   digest_hex(randkey::blake3(pattern_bytes(5000))) == "ee78d92070de3df1c57c37002abf0a6b1a6589acdeef4d8ffac7cf3d9e8f2836",
+               "blake3 should merge chunk chaining values into the tree");
+
+        // 混合长度：等长的 8 条走多缓冲分组，其余逐条计算，结果必须与单条一致
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < 29; ++i)
+        {
+            keys.push_back(pattern_bytes(i < 16 ? 32 : (i * 7) % 150).substr(i % 3));
+        }
+        const std::vector<std::string_view> views(keys.begin(), keys.end());
+        std::vector<randkey::KeyDigest> digests(views.size());
+        randkey::hash_keys(KeyHashAlgorithm::Sha256, views, digests);
+        bool batch_matches = true;
+        for (std::size_t i = 0; i < views.size(); ++i)
+        {
+            batch_matches = batch_matches && digests[i] == randkey::sha256(views[i]);
+        }
+        expect(batch_matches, "batched sha256 should match single-message hashing");
+
+        std::string output;
+        {
+            randkey::StringSink sink(output);
+            std::ostream stream(&sink);
+            randkey::OutputWriter writer(stream);
+            writer.emit_hash(KeyHashAlgorithm::Sha256, false);
+            for (int i = 0; i < 70; ++i)
+            {
+                writer.write_line("abc");
+            }
+            writer.flush();
+            expect(writer.bytes_written() == 70U * (3 + 1 + 64 + 1), "hashed lines should be key<TAB>digest");
+        }
+        expect(output.substr(0, 69) == "abc\tba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad\n" &&
+                   output.substr(69 * 69) == output.substr(0, 69),
+               "staged keys should be flushed with their digests in order");
+
+        std::string digests_only;
+        {
+            randkey::StringSink sink(digests_only);
+            std::ostream stream(&sink);
+            randkey::OutputWriter writer(stream);
+            writer.emit_hash(KeyHashAlgorithm::Blake3, true);
+            writer.write_key(U"abc");
+        }
+        expect(digests_only == "6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85\n",
+               "hash-only output should omit the key");
+
+        bool rejected = false;
+        try
+        {
+            randkey::parse_key_hash_algorithm(U"md5");
+        }
+        catch (const std::runtime_error &error)
+        {
+            rejected = std::string(error.what()) == "error_hash_algorithm";
+        }
+        expect(rejected, "unknown hash algorithms should be rejected");
+    }
+
+    return failures;
+}
@@ -1,7 +1,20 @@
+#include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
+#include "randkey/exclusion_index.hpp"
+#include "randkey/external_sorter.hpp"
+#include "randkey/fingerprint_set.hpp"
+#include "randkey/fixed_key_generator.hpp"
 #include "randkey/generator.hpp"
 
 namespace
@@ -112,5 +125,507 @@ int run_generator_tests()
         expect(outcome.keys.size() == 1, "should still generate with mixing seed");
     }
 
+    {
+        GenerationOptions options;
+        options.raw_bytes = 32;
+        options.raw_encoding = BinaryEncoding::Hex;
+        options.count = 3;
+
+        auto first = generator.generate(options, 99ULL, std::nullopt);
+        auto second = generator.generate(options, 99ULL, std::nullopt);
+        expect(first.keys.size() == 3 && first.keys == second.keys, "raw deterministic keys should be reproducible");
+        expect(first.keys[0].size() == 64, "raw hex key should encode every byte");
+        expect(first.keys[0] != first.keys[1], "raw keys should differ per index");
+
+        auto secure = generator.generate(options, std::nullopt, std::nullopt);
+        expect(secure.keys.size() == 3 && secure.keys[0].size() == 64, "raw secure keys should have requested size");
+
+        std::ostringstream stream;
+        options.raw_encoding = BinaryEncoding::Binary;
+        {
+            OutputWriter writer(stream);
+            generator.generate(options, writer, 99ULL, std::nullopt);
+        }
+        expect(stream.str().size() == 96, "binary raw output should be unseparated bytes");
+
+        expect_throw("binary raw mode should require streaming", [&] {
+            generator.generate(options, 99ULL, std::nullopt);
+        });
+    }
+
+    {
+        const std::u32string_view base32 = U"ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+        GenerationOptions options;
+        options.length = 4096;
+        options.count = 1;
+        options.registry.include(BuiltinCharset::Base32);
+
+        auto outcome = generator.generate(options, std::nullopt, std::nullopt);
+        const std::u32string &key = outcome.keys[0];
+        expect(key.size() == 4096, "bit-exact path should honour length");
+
+        std::array<std::size_t, 32> histogram{};
+        bool in_alphabet = true;
+        for (char32_t ch : key)
+        {
+            const auto pos = base32.find(ch);
+            if (pos == std::u32string_view::npos)
+            {
+                in_alphabet = false;
+                break;
+            }
+            ++histogram[pos];
+        }
+        expect(in_alphabet, "bit-exact path should only emit alphabet characters");
+
+        bool all_seen = true;
+        for (auto hits : histogram)
+        {
+            all_seen = all_seen && hits > 0;
+        }
+        expect(all_seen, "bit-exact path should reach every alphabet index");
+    }
+
+    {
+        GenerationOptions options;
+        options.length = 37;
+        options.count = 4;
+        options.registry.include(BuiltinCharset::Hex);
+        options.registry.add_token(U"語言");
+        for (char32_t ch = 0x4E00; ch < 0x4E0F; ++ch)
+        {
+            options.registry.add_characters(std::u32string(1, ch));
+        }
+
+        auto outcome = generator.generate(options, std::nullopt, 5ULL);
+        expect(outcome.keys.size() == 4 && outcome.keys[0].size() >= 37, "multi-character tokens should work on bit-exact path");
+
+        GenerationOptions wide;
+        wide.length = 100;
+        wide.count = 2;
+        for (char32_t ch = 0x4E00; ch < 0x4E80; ++ch)
+        {
+            wide.registry.add_characters(std::u32string(1, ch));
+        }
+        outcome = generator.generate(wide, std::nullopt, std::nullopt);
+        bool in_range = outcome.keys.size() == 2 && outcome.keys[1].size() == 100;
+        for (char32_t ch : outcome.keys[1])
+        {
+            in_range = in_range && ch >= 0x4E00 && ch < 0x4E80;
+        }
+        expect(in_range, "generic bit-width path should stay within the charset");
+    }
+
+    {
+        GenerationOptions options;
+        options.id_format = IdFormat::UuidV7;
+        options.count = 2000;
+
+        auto outcome = generator.generate(options, std::nullopt, std::nullopt);
+        bool ordered = outcome.keys.size() == 2000;
+        for (std::size_t i = 1; ordered && i < outcome.keys.size(); ++i)
+        {
+            ordered = outcome.keys[i - 1] < outcome.keys[i] && outcome.keys[i].size() == 36;
+        }
+        expect(ordered, "uuid7 batches should be strictly increasing");
+    }
+
+    {
+        GenerationOptions options;
+        options.pattern = U"KEY-A{4}-9999-\\X{2}h";
+        options.count = 20;
+
+        auto outcome = generator.generate(options, std::nullopt, std::nullopt);
+        bool shape_ok = outcome.keys.size() == 20;
+        for (const auto &key : outcome.keys)
+        {
+            shape_ok = shape_ok && key.size() == 17 && key.compare(0, 4, U"KEY-") == 0 &&
+                       key[8] == U'-' && key[13] == U'-' && key.compare(14, 2, U"XX") == 0;
+            for (std::size_t i = 4; i < 8; ++i)
+            {
+                shape_ok = shape_ok && key[i] >= U'A' && key[i] <= U'Z';
+            }
+            for (std::size_t i = 9; i < 13; ++i)
+            {
+                shape_ok = shape_ok && key[i] >= U'0' && key[i] <= U'9';
+            }
+        }
+        expect(shape_ok, "pattern keys should follow the template");
+
+        auto first = generator.generate(options, 77ULL, std::nullopt);
+        auto second = generator.generate(options, 77ULL, std::nullopt);
+        expect(first.keys == second.keys, "deterministic pattern keys should be reproducible");
+
+        const auto plan = PatternPlan::compile(U"AAAA-9999", CharsetRegistry{});
+        expect(plan.segments().size() == 3 && plan.draw_count() == 8, "pattern plan should merge repeated placeholders");
+
+        options.pattern = U"A{0}";
+        expect_throw("zero repeat should be rejected", [&] { generator.generate(options, 1ULL, std::nullopt); });
+        options.pattern = U"A{3";
+        expect_throw("unterminated repeat should be rejected", [&] { generator.generate(options, 1ULL, std::nullopt); });
+        expect_throw("huge literal repeats should be rejected before expansion",
+                     [&] { PatternPlan::compile(U"\\-{4000000000}", CharsetRegistry{}); });
+        expect_throw("repeats should be capped across the whole template",
+                     [&] { PatternPlan::compile(U"9{1000000}-{48577}", CharsetRegistry{}); });
+        expect(PatternPlan::compile(U"9{1000000}-{48576}", CharsetRegistry{}).draw_count() == 1000000,
+               "templates up to the character limit should compile");
+    }
+
+    {
+        GenerationOptions options;
+        options.length = 8;
+        options.count = 500;
+        options.registry.include_all_builtins();
+        options.required_classes = {BuiltinCharset::Uppercase, BuiltinCharset::Digits, BuiltinCharset::Special};
+
+        auto outcome = generator.generate(options, std::nullopt, std::nullopt);
+        bool compliant = outcome.keys.size() == 500;
+        for (const auto &key : outcome.keys)
+        {
+            bool upper = false;
+            bool digit = false;
+            bool special = false;
+            for (char32_t ch : key)
+            {
+                upper = upper || (ch >= U'A' && ch <= U'Z');
+                digit = digit || (ch >= U'0' && ch <= U'9');
+                special = special || CharsetRegistry::builtin_characters(BuiltinCharset::Special).find(ch) != std::u32string_view::npos;
+            }
+            compliant = compliant && key.size() == 8 && upper && digit && special;
+        }
+        expect(compliant, "constrained keys should contain every required class");
+
+        // {a, b, 0} 长度 2 且要求 lower+digit：合法序列 a0 b0 0a 0b 应等概率出现
+        CharsetRegistry small;
+        small.add_characters(U"ab0");
+        const std::vector<std::u32string> tokens = small.materialize();
+        const ConstrainedSampler sampler(tokens, {BuiltinCharset::Lowercase, BuiltinCharset::Digits}, 2);
+        std::mt19937_64 engine(2024);
+        std::array<std::size_t, 9> histogram{};
+        std::vector<std::size_t> choices;
+        for (int i = 0; i < 40000; ++i)
+        {
+            sampler.sample([&] { return engine(); }, choices);
+            ++histogram[choices[0] * 3 + choices[1]];
+        }
+        const std::size_t legal[] = {0 * 3 + 2, 1 * 3 + 2, 2 * 3 + 0, 2 * 3 + 1};
+        std::size_t legal_total = 0;
+        bool balanced = true;
+        for (std::size_t cell : legal)
+        {
+            legal_total += histogram[cell];
+            balanced = balanced && histogram[cell] > 9500 && histogram[cell] < 10500;
+        }
+        expect(legal_total == 40000 && balanced, "constrained sampling should be uniform over compliant keys");
+
+        options.length = 2;
+        expect_throw("length shorter than required classes should be rejected", [&] {
+            generator.generate(options, 1ULL, std::nullopt);
+        });
+
+        // 超长密钥不建计数表，改为整键拒绝采样
+        options.length = 20000;
+        options.count = 2;
+        outcome = generator.generate(options, 5ULL, std::nullopt);
+        bool long_compliant = outcome.keys.size() == 2;
+        for (const auto &key : outcome.keys)
+        {
+            long_compliant = long_compliant && key.size() == 20000 &&
+                             std::any_of(key.begin(), key.end(), [](char32_t ch) { return ch >= U'A' && ch <= U'Z'; }) &&
+                             std::any_of(key.begin(), key.end(), [](char32_t ch) { return ch >= U'0' && ch <= U'9'; });
+        }
+        expect(long_compliant, "long constrained keys should be sampled without quadratic tables");
+
+        std::u32string crowded;
+        for (char32_t ch = 0x4E00; ch < 0x4E00 + 20000; ++ch)
+        {
+            crowded.push_back(ch);
+        }
+        CharsetRegistry sparse;
+        sparse.add_characters(crowded + U"a");
+        expect_throw("long keys with a rare required class should be rejected", [&] {
+            ConstrainedSampler(sparse.materialize(), {BuiltinCharset::Lowercase}, 2000);
+        });
+    }
+
+    {
+        GenerationOptions options;
+        options.length = 1000;
+        options.count = 1;
+        options.registry.add_weighted_token(U"x", 9.0);
+        options.registry.add_weighted_token(U"y", 1.0);
+
+        auto outcome = generator.generate(options, 3ULL, std::nullopt);
+        const auto heavy = static_cast<std::size_t>(std::count(outcome.keys[0].begin(), outcome.keys[0].end(), U'x'));
+        expect(outcome.keys[0].size() == 1000 && heavy > 850 && heavy < 950, "weighted tokens should be drawn by weight");
+        expect(outcome.keys == generator.generate(options, 3ULL, std::nullopt).keys, "weighted deterministic keys should be reproducible");
+    }
+
+    {
+        const auto temp_path = std::filesystem::temp_directory_path() / "randkey_wordlist_test.txt";
+        {
+            std::ofstream out(temp_path, std::ios::binary);
+            out << "apple\r\nbanana\n\ncherry\napple\ndate";
+        }
+
+        const Wordlist wordlist = Wordlist::load(temp_path);
+        expect(wordlist.size() == 4 && wordlist.word(0) == "apple" && wordlist.word(3) == "date",
+               "wordlist should skip blanks, duplicates and carriage returns");
+
+        GenerationOptions options;
+        options.passphrase_wordlist = temp_path;
+        options.words = 5;
+        options.separator = U"-";
+        options.count = 10;
+
+        auto outcome = generator.generate(options, 11ULL, std::nullopt);
+        bool shape_ok = outcome.keys.size() == 10;
+        for (const auto &phrase : outcome.keys)
+        {
+            shape_ok = shape_ok && std::count(phrase.begin(), phrase.end(), U'-') == 4;
+        }
+        expect(shape_ok, "passphrases should contain the requested number of words");
+        expect(outcome.entropy_bits.has_value() && outcome.entropy_bits.value() == 10.0,
+               "passphrase entropy should be words * log2(wordlist size)");
+        expect(outcome.keys == generator.generate(options, 11ULL, std::nullopt).keys,
+               "deterministic passphrases should be reproducible");
+
+        std::filesystem::remove(temp_path);
+    }
+
+    {
+        GenerationOptions options;
+        options.registry.add_characters(U"ab");
+        options.length = 4;
+        options.count = 16;
+        options.unique = true;
+
+        auto outcome = generator.generate(options, 5ULL, std::nullopt);
+        const std::set<std::u32string> distinct(outcome.keys.begin(), outcome.keys.end());
+        expect(distinct.size() == 16, "unique mode should exhaust the keyspace without duplicates");
+        expect(outcome.keys == generator.generate(options, 5ULL, std::nullopt).keys,
+               "unique deterministic keys should be reproducible");
+
+        options.unique = false;
+        options.count = 4;
+        auto prefix = generator.generate(options, 5ULL, std::nullopt);
+        expect(prefix.keys[0] == outcome.keys[0], "unique mode should keep first occurrences unchanged");
+
+        options.unique = true;
+        options.count = 17;
+        expect_throw("unique mode should fail when the keyspace is exhausted", [&] {
+            generator.generate(options, 5ULL, std::nullopt);
+        });
+    }
+
+    {
+        FingerprintSet set(4);
+        expect(set.insert(std::u32string_view(U"abc")) && !set.insert(std::u32string_view(U"abc")),
+               "short keys should be detected exactly");
+        expect(KeyFingerprint::of(std::u32string_view(U"abcdefgh")).exact() &&
+                   !KeyFingerprint::of(std::u32string_view(U"abcdefghi")).exact(),
+               "only short ascii keys should use exact fingerprints");
+
+        const std::uint64_t colliding = (1ULL << 63U) | 42U;
+        expect(set.insert(KeyFingerprint{colliding, 1}) && set.insert(KeyFingerprint{colliding, 2}) &&
+                   !set.insert(KeyFingerprint{colliding, 2}),
+               "primary fingerprint collisions should fall back to the secondary fingerprint");
+
+        FingerprintSet long_keys(20000);
+        bool distinct_accepted = true;
+        for (int i = 0; i < 20000; ++i)
+        {
+            distinct_accepted = distinct_accepted && long_keys.insert(std::string_view("voucher-" + std::to_string(i) + "-ü"));
+        }
+        expect(distinct_accepted && !long_keys.insert(std::string_view("voucher-19999-ü")) &&
+                   long_keys.contains(KeyFingerprint::of(std::string_view("voucher-0-ü"))) &&
+                   !long_keys.contains(KeyFingerprint::of(std::string_view("voucher-x-ü"))),
+               "hashed keys should be deduplicated by their 128-bit fingerprint");
+    }
+
+    {
+        const auto keys_path = std::filesystem::temp_directory_path() / "randkey_exclude_test.txt";
+        std::filesystem::remove(ExclusionIndex::index_path(keys_path));
+        {
+            std::ofstream out(keys_path, std::ios::binary);
+            out << "aaa\r\naab\naba\nabb\nbaa\nbab\nbba\n";
+        }
+
+        GenerationOptions options;
+        options.registry.add_characters(U"ab");
+        options.length = 3;
+        options.count = 1;
+        options.exclude_file = keys_path;
+
+        auto outcome = generator.generate(options, 9ULL, std::nullopt);
+        expect(outcome.keys.size() == 1 && outcome.keys[0] == U"bbb", "excluded keys should be regenerated");
+        expect(std::filesystem::exists(ExclusionIndex::index_path(keys_path)), "exclusion index should be persisted");
+
+        const ExclusionIndex index = ExclusionIndex::open(keys_path);
+        expect(index.mapped() && index.size() == 7, "persisted exclusion index should be memory-mapped");
+        expect(index.contains(std::u32string_view(U"aaa")) && index.contains(std::string_view("bba")) &&
+                   !index.contains(std::u32string_view(U"bbb")),
+               "exclusion index lookups should match the key file");
+
+        options.count = 2;
+        options.unique = true;
+        expect_throw("exclusion should exhaust a tiny keyspace", [&] { generator.generate(options, 9ULL, std::nullopt); });
+
+        std::filesystem::remove(ExclusionIndex::index_path(keys_path));
+        std::filesystem::remove(keys_path);
+
+        std::vector<std::string> issued;
+        for (std::size_t i = 0; i < 20000; ++i)
+        {
+            issued.push_back("KEY-" + std::to_string(i * 7919));
+        }
+        const ExclusionIndex memory = ExclusionIndex::from_keys(issued);
+        bool all_found = true;
+        std::size_t false_hits = 0;
+        for (std::size_t i = 0; i < 20000; ++i)
+        {
+            all_found = all_found && memory.contains(std::string_view(issued[i]));
+            false_hits += memory.contains(std::string_view("NEW-" + std::to_string(i))) ? 1 : 0;
+        }
+        expect(all_found && false_hits == 0, "exclusion index should have no false negatives or false positives");
+    }
+
+    {
+        std::set<std::string> expected;
+        std::vector<std::string> sorted;
+        std::size_t runs = 0;
+        const auto spill_parent = std::filesystem::temp_directory_path() / "randkey_sort_test";
+        std::filesystem::remove_all(spill_parent);
+        std::filesystem::create_directories(spill_parent);
+        bool private_runs = true;
+        {
+            ExternalSorter sorter(ExternalSorter::MIN_MEMORY_LIMIT, spill_parent);
+            std::mt19937_64 engine(17);
+            for (std::size_t i = 0; i < 60000; ++i)
+            {
+                // 前缀相同、长度不一的键用于覆盖整键补排
+                std::string key = "k" + std::to_string(engine() % 40000);
+                key.append(i % 7 == 0 ? "-suffix" : "");
+                expected.insert(key);
+                sorter.push(key);
+            }
+#if !defined(_WIN32)
+            using std::filesystem::perms;
+            for (const auto &directory : std::filesystem::directory_iterator(spill_parent))
+            {
+                private_runs = private_runs && (directory.status().permissions() & perms::all) == perms::owner_all;
+                for (const auto &run : std::filesystem::directory_iterator(directory.path()))
+                {
+                    private_runs = private_runs && (run.status().permissions() & perms::all) ==
+                                                       (perms::owner_read | perms::owner_write);
+                }
+            }
+#endif
+            sorter.finish([&](std::string_view key) { sorted.emplace_back(key); });
+            runs = sorter.spilled_runs();
+        }
+        expect(runs > 1, "sorter should spill runs under a small memory limit");
+        expect(private_runs, "spilled runs should live in an owner-only directory with owner-only files");
+        expect(std::filesystem::is_empty(spill_parent), "sorter should remove its runs and private directory");
+        std::filesystem::remove_all(spill_parent);
+        expect(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()),
+               "external sort should emit ascending keys without duplicates");
+
+        GenerationOptions options;
+        options.registry.add_characters(U"ab");
+        options.length = 3;
+        options.count = 40;
+        options.sorted = true;
+
+        auto outcome = generator.generate(options, 21ULL, std::nullopt);
+        const std::set<std::u32string> distinct(outcome.keys.begin(), outcome.keys.end());
+        expect(std::is_sorted(outcome.keys.begin(), outcome.keys.end()) && distinct.size() == outcome.keys.size() &&
+                   outcome.keys.size() == 8,
+               "sorted generation should output each distinct key once in order");
+    }
+
+    {
+        expect(shard_range(10, 0, 3).end == 3 && shard_range(10, 2, 3).begin == 6 && shard_range(10, 2, 3).end == 10,
+               "shard ranges should partition the total");
+
+        GenerationOptions options;
+        options.registry.include(BuiltinCharset::Lowercase);
+        options.length = 10;
+        options.count = 25;
+        const auto whole = generator.generate(options, 77ULL, std::nullopt).keys;
+
+        std::vector<std::u32string> joined;
+        for (std::uint64_t shard = 0; shard < 4; ++shard)
+        {
+            GenerationOptions part = options;
+            apply_shard(part, shard, 4);
+            const auto keys = generator.generate(part, 77ULL, std::nullopt).keys;
+            joined.insert(joined.end(), keys.begin(), keys.end());
+        }
+        expect(joined == whole, "concatenated shards should match a single run");
+
+        GenerationOptions raw;
+        raw.raw_bytes = 16;
+        raw.raw_encoding = BinaryEncoding::Hex;
+        raw.count = 9;
+        const auto raw_whole = generator.generate(raw, 77ULL, std::nullopt).keys;
+        raw.start_index = 5;
+        raw.count = 4;
+        const auto raw_tail = generator.generate(raw, 77ULL, std::nullopt).keys;
+        expect(std::equal(raw_tail.begin(), raw_tail.end(), raw_whole.begin() + 5), "raw keys should honour start_index");
+    }
+
+    {
+        using HexKey = randkey::FixedKeyGenerator<"0123456789abcdef", 32>;
+        using DigitKey = randkey::FixedKeyGenerator<randkey::fixed_charsets::digits, 12>;
+        using MixedKey = randkey::FixedKeyGenerator<randkey::fixed_charsets::lowercase + randkey::fixed_charsets::digits, 20>;
+        static_assert(HexKey::THRESHOLD == 256 && DigitKey::THRESHOLD == 250 && MixedKey::THRESHOLD == 252);
+        static_assert(std::is_same_v<HexKey::key_type, std::array<char, 32>>);
+        static_assert(HexKey::TABLE[0x1f] == 'f' && DigitKey::TABLE[249] == '9');
+        static_assert(MixedKey::charset() == "abcdefghijklmnopqrstuvwxyz0123456789");
+        static_assert(!randkey::FixedCharset("aa").valid() && !randkey::FixedCharset("a b").valid());
+
+        const std::pair<randkey::BuiltinCharset, std::string_view> builtins[] = {
+            {randkey::BuiltinCharset::Lowercase, randkey::fixed_charsets::lowercase.view()},
+            {randkey::BuiltinCharset::Uppercase, randkey::fixed_charsets::uppercase.view()},
+            {randkey::BuiltinCharset::Digits, randkey::fixed_charsets::digits.view()},
+            {randkey::BuiltinCharset::Special, randkey::fixed_charsets::special.view()},
+            {randkey::BuiltinCharset::Hex, randkey::fixed_charsets::hex.view()},
+            {randkey::BuiltinCharset::Base32, randkey::fixed_charsets::base32.view()},
+            {randkey::BuiltinCharset::Base64, randkey::fixed_charsets::base64.view()},
+            {randkey::BuiltinCharset::Base64Url, randkey::fixed_charsets::base64url.view()},
+        };
+        bool builtins_match = true;
+        for (const auto &[kind, fixed] : builtins)
+        {
+            const std::u32string_view runtime = randkey::CharsetRegistry::builtin_characters(kind);
+            builtins_match = builtins_match && std::equal(runtime.begin(), runtime.end(), fixed.begin(), fixed.end(),
+                                                          [](char32_t a, char b) { return a == static_cast<char32_t>(b); });
+        }
+        expect(builtins_match, "fixed charsets should mirror the runtime builtin tables");
+
+        randkey::SecureRandomStream random;
+        std::array<std::size_t, 10> counts{};
+        for (int i = 0; i < 2000; ++i)
+        {
+            const DigitKey::key_type key = DigitKey::generate(random);
+            for (char ch : key)
+            {
+                ++counts[static_cast<std::size_t>(ch - '0')];
+            }
+        }
+        // 24000 次抽样，每个数字期望 2400 次，允许约 7 个标准差的偏离
+        expect(std::all_of(counts.begin(), counts.end(), [](std::size_t count) { return count > 2070 && count < 2730; }),
+               "fixed digit keys should be uniform over the charset");
+
+        const HexKey::key_type hex = HexKey::generate();
+        const std::string_view text = HexKey::view(hex);
+        expect(text.size() == 32 && text.find_first_not_of("0123456789abcdef") == std::string_view::npos,
+               "fixed hex keys should stay within the literal charset");
+        const MixedKey::key_type mixed = MixedKey::generate(random);
+        expect(MixedKey::view(mixed).find_first_not_of(MixedKey::charset()) == std::string_view::npos,
+               "concatenated fixed charsets should generate");
+    }
+
     return failures;
 }
@@ -3,6 +3,8 @@
 int run_charset_tests();
 int run_generator_tests();
 int run_cli_tests();
+int run_codec_tests();
+int run_c_api_tests();
 
 int main()
 {
@@ -10,6 +12,8 @@ int main()
     failures += run_charset_tests();
     failures += run_generator_tests();
     failures += run_cli_tests();
+    failures += run_codec_tests();
+    failures += run_c_api_tests();
 
     if (failures > 0)
     {